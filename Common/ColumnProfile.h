@@ -0,0 +1,35 @@
+#pragma once
+
+#include <utility>
+
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+/**
+ * @brief Profile of single column of loaded dataset.
+ */
+struct ColumnProfile
+{
+    /// Number of empty values.
+    int emptyValues_{0};
+
+    /// Number of distinct non-empty values.
+    int distinctValues_{0};
+
+    /// Minimum for numeric and date columns, null when column is empty.
+    QVariant min_{};
+
+    /// Maximum for numeric and date columns, null when column is empty.
+    QVariant max_{};
+
+    /// Most frequent values with number of occurrences, most frequent first.
+    QVector<std::pair<QVariant, int>> topValues_{};
+
+    /// Number of values in equal width bins between minimum and maximum of
+    /// numeric and date columns.
+    QVector<int> histogram_{};
+
+    /// Distinct strings of string column.
+    QStringList strings_{};
+};
@@ -0,0 +1,89 @@
+#include "CompressionUtilities.h"
+
+#include <zlib.h>
+
+namespace CompressionUtilities
+{
+std::pair<bool, DeflatedChunk> deflateChunk(const QByteArray& input,
+                                            bool lastChunk)
+{
+    DeflatedChunk chunk;
+    chunk.uncompressedSize_ = input.size();
+    chunk.crc_ = static_cast<quint32>(
+        crc32(crc32(0L, Z_NULL, 0),
+              reinterpret_cast<const Bytef*>(input.constData()),
+              static_cast<uInt>(input.size())));
+
+    z_stream stream{};
+    const int memoryLevel{8};
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS,
+                     memoryLevel, Z_DEFAULT_STRATEGY) != Z_OK)
+        return {false, {}};
+
+    // Bound does not include bytes needed for full flush marker.
+    const int flushMarkerSize{16};
+    const uLong bound{
+        deflateBound(&stream, static_cast<uLong>(input.size()))};
+    chunk.data_.resize(static_cast<int>(bound) + flushMarkerSize);
+
+    stream.next_in =
+        reinterpret_cast<Bytef*>(const_cast<char*>(input.constData()));
+    stream.avail_in = static_cast<uInt>(input.size());
+
+    const int flush{lastChunk ? Z_FINISH : Z_FULL_FLUSH};
+    int written{0};
+    int result{Z_OK};
+    do
+    {
+        if (written == chunk.data_.size())
+            chunk.data_.resize(chunk.data_.size() * 2);
+        stream.next_out =
+            reinterpret_cast<Bytef*>(chunk.data_.data() + written);
+        stream.avail_out = static_cast<uInt>(chunk.data_.size() - written);
+        result = deflate(&stream, flush);
+        written = chunk.data_.size() - static_cast<int>(stream.avail_out);
+    } while (result == Z_OK && stream.avail_out == 0);
+
+    // Repeated flush without new input reports no progress but is fine.
+    const bool flushed{(result == Z_OK || result == Z_BUF_ERROR) &&
+                       stream.avail_in == 0};
+    const bool success{lastChunk ? result == Z_STREAM_END : flushed};
+    deflateEnd(&stream);
+
+    chunk.data_.resize(written);
+    return {success, chunk};
+}
+
+std::pair<bool, QByteArray> inflateChunk(const QByteArray& input,
+                                         qint64 uncompressedSize)
+{
+    z_stream stream{};
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        return {false, {}};
+
+    // One spare byte lets inflate consume flush marker after the data.
+    QByteArray output(static_cast<int>(uncompressedSize) + 1,
+                      Qt::Uninitialized);
+    stream.next_in =
+        reinterpret_cast<Bytef*>(const_cast<char*>(input.constData()));
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = reinterpret_cast<Bytef*>(output.data());
+    stream.avail_out = static_cast<uInt>(output.size());
+
+    const int result{inflate(&stream, Z_SYNC_FLUSH)};
+    const bool success{(result == Z_OK || result == Z_STREAM_END) &&
+                       stream.avail_in == 0 &&
+                       static_cast<qint64>(stream.total_out) ==
+                           uncompressedSize};
+    inflateEnd(&stream);
+
+    output.resize(static_cast<int>(uncompressedSize));
+    return {success, output};
+}
+
+quint32 combineCrc(quint32 firstCrc, quint32 secondCrc, qint64 secondSize)
+{
+    return static_cast<quint32>(
+        crc32_combine(firstCrc, secondCrc, static_cast<z_off_t>(secondSize)));
+}
+}  // namespace CompressionUtilities
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <utility>
+
+#include <QByteArray>
+
+/**
+ * Helper functions for compression of data in independent chunks. Chunks
+ * compressed one after another form single raw deflate stream.
+ */
+namespace CompressionUtilities
+{
+/**
+ * @brief Chunk of compressed data.
+ */
+struct DeflatedChunk
+{
+    QByteArray data_{};
+    quint32 crc_{0};
+    qint64 uncompressedSize_{0};
+};
+
+/**
+ * @brief Compress chunk using raw deflate. Chunk which is not last is ended
+ * using full flush, so it can be concatenated with next chunks.
+ * @param input Data to compress.
+ * @param lastChunk Flag indicating that chunk closes deflate stream.
+ * @return Flag indicating success and compressed chunk.
+ */
+std::pair<bool, DeflatedChunk> deflateChunk(const QByteArray& input,
+                                            bool lastChunk);
+
+/**
+ * @brief Decompress single chunk compressed using deflateChunk().
+ * @param input Compressed chunk.
+ * @param uncompressedSize Size of chunk before compression.
+ * @return Flag indicating success and decompressed data.
+ */
+std::pair<bool, QByteArray> inflateChunk(const QByteArray& input,
+                                         qint64 uncompressedSize);
+
+/**
+ * @brief Calculate crc of two concatenated blocks of data.
+ * @param firstCrc Crc of first block.
+ * @param secondCrc Crc of second block.
+ * @param secondSize Size of second block.
+ * @return Crc of concatenated blocks.
+ */
+quint32 combineCrc(quint32 firstCrc, quint32 secondCrc, qint64 secondSize);
+}  // namespace CompressionUtilities
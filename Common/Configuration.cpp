@@ -74,6 +74,9 @@ QString Configuration::configDump() const
 
     dump.append("Import file path = " + importFilePath_ + "\n");
 
+    dump.append("Hibernation idle minutes = " +
+                QString::number(hibernationIdleMinutes_) + "\n");
+
     if (updatePolicy_ != UpdatePolicy::NOT_DECIDED)
     {
         dump.append(QLatin1String("AutoUpdate active = "));
@@ -134,6 +137,12 @@ void Configuration::parseConfigXml(QDomDocument& configXml)
     QDomElement importPathElement{list.at(0).toElement()};
     if (!importPathElement.isNull())
         importFilePath_ = importPathElement.attribute(XML_NAME_VALUE);
+
+    list = configXml.elementsByTagName(XML_NAME_HIBERNATION);
+    QDomElement hibernationElement{list.at(0).toElement()};
+    if (!hibernationElement.isNull())
+        hibernationIdleMinutes_ =
+            hibernationElement.attribute(XML_NAME_VALUE).toInt();
 }
 
 QString Configuration::generateConfigXml() const
@@ -155,6 +164,11 @@ QString Configuration::generateConfigXml() const
     importPath.setAttribute(XML_NAME_VALUE, importFilePath_);
     root.appendChild(importPath);
 
+    QDomElement hibernation = doc.createElement(XML_NAME_HIBERNATION);
+    hibernation.setAttribute(XML_NAME_VALUE,
+                             QString::number(hibernationIdleMinutes_));
+    root.appendChild(hibernation);
+
     return doc.toString();
 }
 
@@ -206,3 +220,13 @@ void Configuration::setImportFilePath(const QString& path)
 {
     importFilePath_ = path;
 }
+
+int Configuration::getHibernationIdleMinutes() const
+{
+    return hibernationIdleMinutes_;
+}
+
+void Configuration::setHibernationIdleMinutes(int minutes)
+{
+    hibernationIdleMinutes_ = minutes;
+}
@@ -63,6 +63,14 @@ public:
 
     void setImportFilePath(const QString& path);
 
+    /**
+     * @brief Get time after which hidden tab is hibernated.
+     * @return Time in minutes, 0 when idle tabs are not hibernated.
+     */
+    int getHibernationIdleMinutes() const;
+
+    void setHibernationIdleMinutes(int minutes);
+
 private:
     Configuration();
     ~Configuration() = default;
@@ -92,9 +100,14 @@ private:
 
     UpdatePolicy updatePolicy_{UpdatePolicy::NOT_DECIDED};
 
+    int hibernationIdleMinutes_{DEFAULT_HIBERNATION_IDLE_MINUTES};
+
+    static constexpr int DEFAULT_HIBERNATION_IDLE_MINUTES{10};
+
     const QString XML_NAME_CONFIG{QStringLiteral("CONFIG")};
     const QString XML_NAME_UPDATE{QStringLiteral("UPDATE")};
     const QString XML_NAME_VALUE{QStringLiteral("VALUE")};
     const QString XML_NAME_STYLE{QStringLiteral("STYLE")};
     const QString XML_NAME_IMPORTPATH{QStringLiteral("IMPORTPATH")};
+    const QString XML_NAME_HIBERNATION{QStringLiteral("HIBERNATION")};
 };
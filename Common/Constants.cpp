@@ -25,6 +25,8 @@ static QVector<QString> initProgressBarNames()
     progressTitles[static_cast<int>(BarTitle::SAVING)] = QObject::tr("Saving");
     progressTitles[static_cast<int>(BarTitle::ANALYSING)] =
         QObject::tr("Analysing");
+    progressTitles[static_cast<int>(BarTitle::CACHING)] =
+        QObject::tr("Caching");
     return progressTitles;
 }
 
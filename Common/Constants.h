@@ -23,6 +23,7 @@ enum class BarTitle : unsigned char
     LOADING = 0,
     SAVING,
     ANALYSING,
+    CACHING,
     END
 };
 
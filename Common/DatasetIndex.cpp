@@ -0,0 +1,157 @@
+#include "DatasetIndex.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include <QDataStream>
+
+namespace
+{
+const quint32 INDEX_MAGIC{0x56425849};
+const quint32 INDEX_VERSION{1};
+const quint32 ROW_GROUPS_MAGIC{0x56425847};
+const quint32 ROW_GROUPS_VERSION{1};
+}  // namespace
+
+QDataStream& operator<<(QDataStream& stream, const ColumnIndex& index)
+{
+    return stream << index.min_ << index.max_ << index.emptyValues_
+                  << index.distinctStrings_ << index.distinctCounts_
+                  << index.sortRanks_;
+}
+
+QDataStream& operator>>(QDataStream& stream, ColumnIndex& index)
+{
+    return stream >> index.min_ >> index.max_ >> index.emptyValues_ >>
+           index.distinctStrings_ >> index.distinctCounts_ >>
+           index.sortRanks_;
+}
+
+QDataStream& operator<<(QDataStream& stream, const RowGroup& group)
+{
+    return stream << group.firstRow_ << group.rowCount_
+                  << group.compressedOffset_ << group.compressedSize_
+                  << group.uncompressedSize_ << group.min_ << group.max_;
+}
+
+QDataStream& operator>>(QDataStream& stream, RowGroup& group)
+{
+    return stream >> group.firstRow_ >> group.rowCount_ >>
+           group.compressedOffset_ >> group.compressedSize_ >>
+           group.uncompressedSize_ >> group.min_ >> group.max_;
+}
+
+namespace DatasetIndex
+{
+QByteArray toByteArray(quint32 dataCrc, unsigned int rowCount,
+                       const QVector<ColumnIndex>& indexes)
+{
+    QByteArray content;
+    QDataStream stream(&content, QIODevice::WriteOnly);
+    writeHeader(stream, dataCrc, rowCount,
+                static_cast<unsigned int>(indexes.size()));
+    for (const auto& index : indexes)
+        stream << index;
+    return content;
+}
+
+void writeHeader(QDataStream& stream, quint32 dataCrc, unsigned int rowCount,
+                 unsigned int columnCount)
+{
+    // Column count followed by indexes has layout of streamed QVector.
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << INDEX_MAGIC << INDEX_VERSION << dataCrc
+           << static_cast<quint32>(rowCount)
+           << static_cast<quint32>(columnCount);
+}
+
+std::tuple<bool, QVector<ColumnIndex>> fromByteArray(const QByteArray& content,
+                                                     quint32 dataCrc,
+                                                     unsigned int rowCount,
+                                                     unsigned int columnCount)
+{
+    QDataStream stream(content);
+    stream.setVersion(QDataStream::Qt_5_12);
+    quint32 magic{0};
+    quint32 version{0};
+    quint32 storedCrc{0};
+    quint32 storedRowCount{0};
+    stream >> magic >> version >> storedCrc >> storedRowCount;
+    if (stream.status() != QDataStream::Ok || magic != INDEX_MAGIC ||
+        version != INDEX_VERSION || storedCrc != dataCrc ||
+        storedRowCount != rowCount)
+        return {false, {}};
+
+    QVector<ColumnIndex> indexes;
+    stream >> indexes;
+    if (stream.status() != QDataStream::Ok ||
+        indexes.size() != static_cast<int>(columnCount))
+        return {false, {}};
+
+    for (const auto& index : indexes)
+        if (index.sortRanks_.size() != static_cast<int>(rowCount))
+            return {false, {}};
+
+    return {true, indexes};
+}
+
+QByteArray rowGroupsToByteArray(quint32 dataCrc,
+                                const QVector<RowGroup>& groups)
+{
+    QByteArray content;
+    QDataStream stream(&content, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << ROW_GROUPS_MAGIC << ROW_GROUPS_VERSION << dataCrc << groups;
+    return content;
+}
+
+std::tuple<bool, QVector<RowGroup>> rowGroupsFromByteArray(
+    const QByteArray& content, quint32 dataCrc, unsigned int rowCount,
+    unsigned int columnCount)
+{
+    QDataStream stream(content);
+    stream.setVersion(QDataStream::Qt_5_12);
+    quint32 magic{0};
+    quint32 version{0};
+    quint32 storedCrc{0};
+    QVector<RowGroup> groups;
+    stream >> magic >> version >> storedCrc >> groups;
+    if (stream.status() != QDataStream::Ok || magic != ROW_GROUPS_MAGIC ||
+        version != ROW_GROUPS_VERSION || storedCrc != dataCrc)
+        return {false, {}};
+
+    // Groups need to cover all rows one after another.
+    quint32 nextRow{0};
+    for (const auto& group : groups)
+    {
+        if (group.firstRow_ != nextRow ||
+            group.min_.size() != static_cast<int>(columnCount) ||
+            group.max_.size() != static_cast<int>(columnCount))
+            return {false, {}};
+        nextRow += group.rowCount_;
+    }
+    if (nextRow != rowCount)
+        return {false, {}};
+
+    return {true, groups};
+}
+
+QVector<quint32> computeSortRanks(const QVector<double>& keys)
+{
+    QVector<int> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&keys](int left, int right) {
+        return keys[left] < keys[right];
+    });
+
+    QVector<quint32> ranks(keys.size());
+    quint32 rank{0};
+    for (int i = 0; i < order.size(); ++i)
+    {
+        if (i > 0 && keys[order[i - 1]] < keys[order[i]])
+            rank++;
+        ranks[order[i]] = rank;
+    }
+    return ranks;
+}
+}  // namespace DatasetIndex
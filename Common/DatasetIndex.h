@@ -0,0 +1,137 @@
+#pragma once
+
+#include <tuple>
+
+#include <QByteArray>
+#include <QVariant>
+#include <QVector>
+
+class QDataStream;
+
+/**
+ * @brief Precomputed information about single column of saved dataset.
+ */
+struct ColumnIndex
+{
+    /// Minimum for numeric and date columns.
+    QVariant min_{};
+
+    /// Maximum for numeric and date columns.
+    QVariant max_{};
+
+    /// Flag indicating that column contains empty dates.
+    bool emptyValues_{false};
+
+    /// Distinct string indexes in order of first occurrence.
+    QVector<int> distinctStrings_{};
+
+    /// Number of occurrences of each distinct string.
+    QVector<int> distinctCounts_{};
+
+    /// Rank of each row in sorted column. Equal values share rank.
+    QVector<quint32> sortRanks_{};
+};
+
+/**
+ * @brief Range of rows compressed independently, with zone map of columns.
+ */
+struct RowGroup
+{
+    /// Index of first row in group.
+    quint32 firstRow_{0};
+
+    /// Number of rows in group.
+    quint32 rowCount_{0};
+
+    /// Position of group in compressed data entry.
+    qint64 compressedOffset_{0};
+
+    /// Size of group in compressed data entry.
+    qint64 compressedSize_{0};
+
+    /// Size of group after decompression.
+    qint64 uncompressedSize_{0};
+
+    /// Minimum of each numeric column and julian day of each date column.
+    QVector<double> min_{};
+
+    /// Maximum of each numeric column and julian day of each date column.
+    QVector<double> max_{};
+};
+
+QDataStream& operator<<(QDataStream& stream, const ColumnIndex& index);
+
+QDataStream& operator>>(QDataStream& stream, ColumnIndex& index);
+
+QDataStream& operator<<(QDataStream& stream, const RowGroup& group);
+
+QDataStream& operator>>(QDataStream& stream, RowGroup& group);
+
+/**
+ * Helper functions for secondary indexes stored inside .vbx files. Indexes
+ * are tied to data entry using its crc and row count.
+ */
+namespace DatasetIndex
+{
+/**
+ * @brief Serialize indexes of all columns.
+ * @param dataCrc Crc of data entry indexes were computed for.
+ * @param rowCount Number of rows in data entry.
+ * @param indexes Indexes of columns.
+ * @return Serialized indexes.
+ */
+QByteArray toByteArray(quint32 dataCrc, unsigned int rowCount,
+                       const QVector<ColumnIndex>& indexes);
+
+/**
+ * @brief Write header of serialized indexes. Indexes of columns streamed
+ * one by one after header form content readable by fromByteArray().
+ * @param stream Stream to write to.
+ * @param dataCrc Crc of data entry indexes were computed for.
+ * @param rowCount Number of rows in data entry.
+ * @param columnCount Number of columns which indexes follow.
+ */
+void writeHeader(QDataStream& stream, quint32 dataCrc, unsigned int rowCount,
+                 unsigned int columnCount);
+
+/**
+ * @brief Deserialize indexes and check if they match data entry.
+ * @param content Serialized indexes.
+ * @param dataCrc Crc of current data entry.
+ * @param rowCount Number of rows in current data entry.
+ * @param columnCount Number of columns in current data entry.
+ * @return Flag indicating indexes are valid and indexes of columns.
+ */
+std::tuple<bool, QVector<ColumnIndex>> fromByteArray(const QByteArray& content,
+                                                     quint32 dataCrc,
+                                                     unsigned int rowCount,
+                                                     unsigned int columnCount);
+
+/**
+ * @brief Serialize row groups of data entry.
+ * @param dataCrc Crc of data entry groups were created for.
+ * @param groups Row groups.
+ * @return Serialized row groups.
+ */
+QByteArray rowGroupsToByteArray(quint32 dataCrc,
+                                const QVector<RowGroup>& groups);
+
+/**
+ * @brief Deserialize row groups and check if they match data entry.
+ * @param content Serialized row groups.
+ * @param dataCrc Crc of current data entry.
+ * @param rowCount Number of rows in current data entry.
+ * @param columnCount Number of columns in current data entry.
+ * @return Flag indicating row groups are valid and row groups.
+ */
+std::tuple<bool, QVector<RowGroup>> rowGroupsFromByteArray(
+    const QByteArray& content, quint32 dataCrc, unsigned int rowCount,
+    unsigned int columnCount);
+
+/**
+ * @brief Compute ranks of values. Equal values get equal rank.
+ * @param keys Values to rank.
+ * @return Rank of each value.
+ */
+QVector<quint32> computeSortRanks(const QVector<double>& keys);
+}  // namespace DatasetIndex
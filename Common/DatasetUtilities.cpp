@@ -54,6 +54,10 @@ QString getDatasetDataFilename() { return QStringLiteral("data.csv"); }
 
 QString getDatasetStringsFilename() { return QStringLiteral("strings.txt"); }
 
+QString getDatasetIndexFilename() { return QStringLiteral("index.dat"); }
+
+QString getDatasetRowGroupsFilename() { return QStringLiteral("groups.dat"); }
+
 QString getDatasetExtension() { return QStringLiteral(".vbx"); }
 
 QString getDatasetNameRegExp() { return QStringLiteral("[\\w\\s-]+"); }
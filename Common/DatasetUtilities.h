@@ -24,6 +24,10 @@ QString getDatasetDataFilename();
 
 QString getDatasetStringsFilename();
 
+QString getDatasetIndexFilename();
+
+QString getDatasetRowGroupsFilename();
+
 QString getDatasetExtension();
 
 QString getDatasetNameRegExp();
@@ -0,0 +1,119 @@
+#include "ImportCache.h"
+
+#include <algorithm>
+
+#include <QApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "DatasetUtilities.h"
+
+namespace
+{
+/// Size of beginning and ending of source file included in content hash.
+constexpr qint64 HASHED_PART_SIZE{1024 * 1024};
+
+QString getSourceKey(const QFileInfo& fileInfo)
+{
+    const QByteArray path{fileInfo.canonicalFilePath().toUtf8()};
+    return QCryptographicHash::hash(path, QCryptographicHash::Sha1)
+        .toHex()
+        .left(16);
+}
+
+std::pair<bool, QString> getContentKey(const QFileInfo& fileInfo)
+{
+    QFile file(fileInfo.canonicalFilePath());
+    if (!file.open(QIODevice::ReadOnly))
+        return {false, {}};
+
+    // Beginning and ending of file together with size and modification time
+    // identify content without reading whole file.
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(fileInfo.size()));
+    hash.addData(
+        QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+    hash.addData(file.read(HASHED_PART_SIZE));
+    if (file.size() > HASHED_PART_SIZE)
+    {
+        file.seek(std::max(HASHED_PART_SIZE, file.size() - HASHED_PART_SIZE));
+        hash.addData(file.read(HASHED_PART_SIZE));
+    }
+    return {true, hash.result().toHex().left(16)};
+}
+}  // namespace
+
+namespace ImportCache
+{
+QString getCacheDir()
+{
+    const QString cacheDirName{QStringLiteral("Cache")};
+    return QString(QApplication::applicationDirPath() + "/" + cacheDirName +
+                   "/");
+}
+
+QString getCacheFilePath(const QFileInfo& fileInfo)
+{
+    const QDir directory{getCacheDir()};
+    if (!directory.exists() && !directory.mkpath(directory.path()))
+        return {};
+
+    const auto [success, contentKey] = getContentKey(fileInfo);
+    if (!success)
+        return {};
+
+    return getCacheDir() + getSourceKey(fileInfo) + "_" + contentKey +
+           DatasetUtilities::getDatasetExtension();
+}
+
+void removeStaleEntries(const QString& cacheFilePath)
+{
+    const QFileInfo cacheFileInfo(cacheFilePath);
+    const QString sourceKey{
+        cacheFileInfo.completeBaseName().section('_', 0, 0)};
+    QDir directory{cacheFileInfo.absolutePath()};
+    directory.setFilter(QDir::Files | QDir::NoDotAndDotDot);
+    directory.setNameFilters(QStringList(
+        sourceKey + "_*" + DatasetUtilities::getDatasetExtension()));
+    for (const QString& entry : directory.entryList())
+        if (entry != cacheFileInfo.fileName())
+            directory.remove(entry);
+}
+
+void removeLeastRecentlyUsed(const QString& keptFilePath,
+                             qint64 maxCacheSize)
+{
+    const QFileInfo keptFileInfo(keptFilePath);
+    QDir directory{keptFileInfo.absolutePath()};
+    directory.setFilter(QDir::Files | QDir::NoDotAndDotDot);
+    directory.setNameFilters(
+        QStringList("*" + DatasetUtilities::getDatasetExtension()));
+
+    // Modification time of cache file is updated when it is used.
+    directory.setSorting(QDir::Time);
+    qint64 totalSize{0};
+    for (const QFileInfo& entry : directory.entryInfoList())
+    {
+        if (entry.fileName() == keptFileInfo.fileName())
+        {
+            totalSize += entry.size();
+            continue;
+        }
+        if (totalSize + entry.size() > maxCacheSize)
+            directory.remove(entry.fileName());
+        else
+            totalSize += entry.size();
+    }
+}
+
+void markUsed(const QString& cacheFilePath)
+{
+    QFile file(cacheFilePath);
+    if (file.open(QIODevice::ReadWrite))
+        file.setFileTime(QDateTime::currentDateTime(),
+                         QFileDevice::FileModificationTime);
+}
+}  // namespace ImportCache
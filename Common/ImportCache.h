@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QString>
+
+class QFileInfo;
+
+/**
+ * Functions locating imported files stored in inner format. Cache file name
+ * depends on identity of source file, so changed source is imported again.
+ */
+namespace ImportCache
+{
+/// Total size of cache files above which least recently used are removed.
+constexpr qint64 MAX_CACHE_SIZE{2LL * 1024 * 1024 * 1024};
+
+/// Directory of cached datasets.
+QString getCacheDir();
+
+/**
+ * @brief Get path of cache file for given source file. Path is built from
+ * canonical path, size, modification time and hash of first and last
+ * megabyte of source. Key is computed on each import, so whole source is
+ * intentionally not read. Edit keeping size and modification time and
+ * touching middle of large file only is not detected.
+ * @param fileInfo Source file.
+ * @return Path of cache file or empty string when cache can not be used.
+ */
+QString getCacheFilePath(const QFileInfo& fileInfo);
+
+/**
+ * @brief Remove cache files made for older versions of same source file.
+ * @param cacheFilePath Path of current cache file.
+ */
+void removeStaleEntries(const QString& cacheFilePath);
+
+/**
+ * @brief Remove least recently used cache files when total size of cache
+ * files in directory of kept file exceeds limit.
+ * @param keptFilePath Path of cache file which is never removed.
+ * @param maxCacheSize Limit of total size in bytes.
+ */
+void removeLeastRecentlyUsed(const QString& keptFilePath,
+                             qint64 maxCacheSize = MAX_CACHE_SIZE);
+
+/**
+ * @brief Mark cache file as recently used.
+ * @param cacheFilePath Path of cache file.
+ */
+void markUsed(const QString& cacheFilePath);
+}  // namespace ImportCache
@@ -0,0 +1,87 @@
+#include "MemoryBudget.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "MemoryReporter.h"
+#include "MemoryUtilities.h"
+
+MemoryBudget& MemoryBudget::getInstance()
+{
+    static MemoryBudget instance;
+    return instance;
+}
+
+void MemoryBudget::registerReporter(MemoryReporter* reporter)
+{
+    if (!reporters_.contains(reporter))
+        reporters_.append(reporter);
+}
+
+void MemoryBudget::unregisterReporter(MemoryReporter* reporter)
+{
+    reporters_.removeAll(reporter);
+}
+
+quint64 MemoryBudget::getUsedMemory() const
+{
+    quint64 usedMemory{0};
+    for (const MemoryReporter* reporter : reporters_)
+        usedMemory += reporter->getUsedMemory();
+    return usedMemory;
+}
+
+quint64 MemoryBudget::getLimit() const
+{
+    if (limit_ != 0)
+        return limit_;
+
+    const quint64 availableMemory{MemoryUtilities::getAvailableMemory()};
+    if (availableMemory == 0)
+        return 0;
+    return static_cast<quint64>(
+        static_cast<double>(getUsedMemory() + availableMemory) *
+        AVAILABLE_MEMORY_RATIO);
+}
+
+void MemoryBudget::setLimit(quint64 limit) { limit_ = limit; }
+
+bool MemoryBudget::makeRoom(quint64 neededMemory)
+{
+    // Limit is taken before releasing, released memory becomes available.
+    const quint64 limit{getLimit()};
+    if (limit == 0)
+        return true;
+
+    quint64 usedMemory{getUsedMemory()};
+    if (usedMemory + neededMemory <= limit)
+        return true;
+
+    // Cached memory of reporter can be costly to compute, it is taken once.
+    QVector<std::pair<quint64, MemoryReporter*>> reporters;
+    reporters.reserve(reporters_.size());
+    for (MemoryReporter* reporter : reporters_)
+        if (const quint64 cachedMemory{reporter->getCachedMemory()};
+            cachedMemory > 0)
+            reporters.append({cachedMemory, reporter});
+    std::sort(reporters.begin(), reporters.end(),
+              [](const auto& left, const auto& right) {
+                  return left.first > right.first;
+              });
+    for (const auto& cachedReporter : reporters)
+    {
+        if (usedMemory + neededMemory <= limit)
+            break;
+        usedMemory -= std::min(usedMemory,
+                               cachedReporter.second->releaseCachedMemory());
+    }
+    return usedMemory + neededMemory <= limit;
+}
+
+quint64 MemoryBudget::releaseCaches()
+{
+    quint64 releasedMemory{0};
+    for (MemoryReporter* reporter : reporters_)
+        releasedMemory += reporter->releaseCachedMemory();
+    return releasedMemory;
+}
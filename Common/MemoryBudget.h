@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QVector>
+
+class MemoryReporter;
+
+/**
+ * @brief Singleton keeping memory used by registered objects under limit.
+ * When limit would be exceeded, caches are released starting from biggest
+ * one. Used from GUI thread only.
+ */
+class MemoryBudget
+{
+public:
+    MemoryBudget& operator=(const MemoryBudget& other) = delete;
+    MemoryBudget(const MemoryBudget& other) = delete;
+
+    MemoryBudget& operator=(MemoryBudget&& other) = delete;
+    MemoryBudget(MemoryBudget&& other) = delete;
+
+    /**
+     * @brief Used to access memory budget singleton.
+     * @return Singleton instance.
+     */
+    static MemoryBudget& getInstance();
+
+    /**
+     * @brief Start accounting memory of given object.
+     * @param reporter Object reporting memory.
+     */
+    void registerReporter(MemoryReporter* reporter);
+
+    /**
+     * @brief Stop accounting memory of given object.
+     * @param reporter Object reporting memory.
+     */
+    void unregisterReporter(MemoryReporter* reporter);
+
+    /**
+     * @brief Get memory used by all registered objects.
+     * @return Used bytes.
+     */
+    quint64 getUsedMemory() const;
+
+    /**
+     * @brief Get limit of memory used by registered objects. Without set
+     * limit, part of used and available memory is taken.
+     * @return Limit in bytes.
+     */
+    quint64 getLimit() const;
+
+    /**
+     * @brief Set limit of memory used by registered objects.
+     * @param limit Limit in bytes, 0 for limit based on available memory.
+     */
+    void setLimit(quint64 limit);
+
+    /**
+     * @brief Release caches until given amount of memory fits in limit.
+     * @param neededMemory Bytes which are going to be allocated.
+     * @return True if needed memory fits in limit, false otherwise.
+     */
+    bool makeRoom(quint64 neededMemory);
+
+    /**
+     * @brief Release all caches of registered objects.
+     * @return Released bytes.
+     */
+    quint64 releaseCaches();
+
+    /// Part of memory used and available which registered objects can use.
+    static constexpr double AVAILABLE_MEMORY_RATIO{0.75};
+
+private:
+    MemoryBudget() = default;
+    ~MemoryBudget() = default;
+
+    QVector<MemoryReporter*> reporters_;
+
+    quint64 limit_{0};
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QtGlobal>
+
+/**
+ * @class MemoryReporter
+ * @brief Interface of objects reporting memory they use. Objects keeping
+ * data which can be recomputed can release it on request of memory budget.
+ */
+class MemoryReporter
+{
+public:
+    MemoryReporter() = default;
+    virtual ~MemoryReporter() = default;
+
+    MemoryReporter& operator=(const MemoryReporter& other) = delete;
+    MemoryReporter(const MemoryReporter& other) = delete;
+
+    MemoryReporter& operator=(MemoryReporter&& other) = delete;
+    MemoryReporter(MemoryReporter&& other) = delete;
+
+    /**
+     * @brief Get memory used by object.
+     * @return Used bytes.
+     */
+    virtual quint64 getUsedMemory() const = 0;
+
+    /**
+     * @brief Get part of used memory which can be released.
+     * @return Bytes used by data which can be recomputed.
+     */
+    virtual quint64 getCachedMemory() const { return 0; }
+
+    /**
+     * @brief Release data which can be recomputed when needed.
+     * @return Released bytes.
+     */
+    virtual quint64 releaseCachedMemory() { return 0; }
+};
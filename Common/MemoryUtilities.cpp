@@ -0,0 +1,49 @@
+#include "MemoryUtilities.h"
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_LINUX)
+#include <QFile>
+#endif
+
+namespace MemoryUtilities
+{
+quint64 getAvailableMemory()
+{
+#if defined(Q_OS_WIN)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status) == 0)
+        return 0;
+    return static_cast<quint64>(status.ullAvailPhys);
+#elif defined(Q_OS_LINUX)
+    // Unlike free memory, available memory includes reclaimable caches.
+    QFile memoryInfo(QStringLiteral("/proc/meminfo"));
+    if (!memoryInfo.open(QIODevice::ReadOnly | QIODevice::Text))
+        return 0;
+
+    const QByteArray availableKey{QByteArrayLiteral("MemAvailable:")};
+    while (!memoryInfo.atEnd())
+    {
+        const QByteArray line{memoryInfo.readLine()};
+        if (!line.startsWith(availableKey))
+            continue;
+        const QList<QByteArray> fields{
+            line.mid(availableKey.size()).simplified().split(' ')};
+        const quint64 kilobytes{fields.first().toULongLong()};
+        return kilobytes * 1024;
+    }
+    return 0;
+#else
+    return 0;
+#endif
+}
+
+quint64 getStringMemory(const QString& string)
+{
+    if (string.capacity() == 0)
+        return 0;
+    return ARRAY_HEADER_SIZE +
+           static_cast<quint64>(string.capacity() + 1) * sizeof(QChar);
+}
+}  // namespace MemoryUtilities
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QArrayData>
+#include <QString>
+#include <QVector>
+
+/**
+ * Functions related to memory of machine and memory used by containers.
+ */
+namespace MemoryUtilities
+{
+/**
+ * @brief Get physical memory which can be used without swapping.
+ * @return Available memory in bytes or 0 when it can not be determined.
+ */
+quint64 getAvailableMemory();
+
+/// Header allocated together with content of vectors and strings.
+constexpr quint64 ARRAY_HEADER_SIZE{sizeof(QArrayData)};
+
+/**
+ * @brief Get memory allocated by vector, without memory owned by elements.
+ * @param vector Vector.
+ * @return Allocated bytes.
+ */
+template <typename T>
+quint64 getVectorMemory(const QVector<T>& vector)
+{
+    if (vector.capacity() == 0)
+        return 0;
+    return ARRAY_HEADER_SIZE + static_cast<quint64>(vector.capacity()) *
+                                   sizeof(T);
+}
+
+/**
+ * @brief Get memory allocated by string.
+ * @param string String.
+ * @return Allocated bytes.
+ */
+quint64 getStringMemory(const QString& string);
+}  // namespace MemoryUtilities
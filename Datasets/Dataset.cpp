@@ -1,9 +1,19 @@
 #include "Dataset.h"
 
+#include <algorithm>
+#include <future>
+#include <numeric>
+#include <thread>
+
+#include <QDataStream>
 #include <QDate>
 #include <QDomDocument>
+#include <QHash>
+#include <QIODevice>
+#include <QRandomGenerator>
 
 #include <Constants.h>
+#include <MemoryUtilities.h>
 
 Dataset::Dataset(QString name, QObject* parent)
     : QObject(parent),
@@ -25,6 +35,10 @@ ColumnType Dataset::getColumnFormat(Column column) const
 std::tuple<double, double> Dataset::getNumericRange(Column column) const
 {
     Q_ASSERT(ColumnType::NUMBER == getColumnFormat(column));
+    if (!columnIndexes_.isEmpty())
+        return {columnIndexes_[column].min_.toDouble(),
+                columnIndexes_[column].max_.toDouble()};
+
     double min{0.};
     double max{0.};
     bool first{true};
@@ -51,6 +65,11 @@ std::tuple<double, double> Dataset::getNumericRange(Column column) const
 std::tuple<QDate, QDate, bool> Dataset::getDateRange(Column column) const
 {
     Q_ASSERT(ColumnType::DATE == getColumnFormat(column));
+    if (!columnIndexes_.isEmpty())
+        return {columnIndexes_[column].min_.toDate(),
+                columnIndexes_[column].max_.toDate(),
+                columnIndexes_[column].emptyValues_};
+
     QDate minDate;
     QDate maxDate;
     bool emptyDates{false};
@@ -86,6 +105,14 @@ QStringList Dataset::getStringList(Column column) const
 {
     Q_ASSERT(ColumnType::STRING == getColumnFormat(column));
     QStringList listToFill;
+    if (!columnIndexes_.isEmpty())
+    {
+        for (const int index : columnIndexes_[column].distinctStrings_)
+            listToFill.append(sharedStrings_[index].toString());
+        listToFill.removeDuplicates();
+        return listToFill;
+    }
+
     listToFill.reserve(static_cast<int>(rowCount()));
     for (const auto& row : data_)
     {
@@ -104,6 +131,18 @@ QStringList Dataset::getStringList(Column column) const
     return listToFill;
 }
 
+bool Dataset::hasSortRanks() const
+{
+    return !columnIndexes_.isEmpty() &&
+           columnIndexes_.constFirst().sortRanks_.size() ==
+               static_cast<int>(rowCount());
+}
+
+quint32 Dataset::getSortRank(int row, Column column) const
+{
+    return columnIndexes_[column].sortRanks_[row];
+}
+
 std::tuple<bool, Column> Dataset::getTaggedColumn(ColumnTag columnTag) const
 {
     if (isColumnTagged(columnTag))
@@ -119,6 +158,11 @@ QString Dataset::getHeaderName(Column column) const
     return QLatin1String("");
 }
 
+bool Dataset::isColumnActive(Column column) const
+{
+    return activeColumns_.isEmpty() || activeColumns_.at(column);
+}
+
 bool Dataset::isValid() const { return valid_; }
 
 QString Dataset::getName() const { return name_; }
@@ -129,18 +173,71 @@ bool Dataset::initialize()
         return false;
     bool success{false};
     std::tie(success, sampleData_) = getSample();
+    if (success)
+        analyzeSampleStrings();
     return success;
 }
 
 bool Dataset::loadData()
 {
+    loadingPercent_ = 0;
     bool success{false};
     std::tie(success, data_) = getAllData();
+    dataSharingToken_ = std::make_shared<bool>();
+    if (isLoadingCancelled())
+    {
+        data_.clear();
+        closeZip();
+        error_ = QObject::tr("Loading cancelled");
+        return false;
+    }
+
+    if (query_.hasPredicates() || query_.isPartial())
+    {
+        if (!queryAppliedWhileLoading_)
+            applyQuery(data_);
+        rowsCount_ = static_cast<unsigned int>(data_.size());
+    }
     rebuildDefinitonUsingActiveColumnsOnly();
+    if (success)
+        internStrings();
     closeZip();
     return success;
 }
 
+bool Dataset::loadData(const LoadQuery& query)
+{
+    setLoadQuery(query);
+    return loadData();
+}
+
+void Dataset::setLoadQuery(const LoadQuery& query)
+{
+    if (!query.activeColumns_.isEmpty())
+        setActiveColumns(query.activeColumns_);
+    query_ = query;
+}
+
+const LoadQuery& Dataset::getLoadQuery() const { return query_; }
+
+unsigned int Dataset::getLoadingPercent() const { return loadingPercent_; }
+
+void Dataset::cancelLoading() { loadingCancelled_ = true; }
+
+bool Dataset::isLoadingCancelled() const { return loadingCancelled_; }
+
+void Dataset::setProgressiveLoading(bool progressive)
+{
+    progressiveLoading_ = progressive;
+}
+
+bool Dataset::isProgressiveLoading() const { return progressiveLoading_; }
+
+void Dataset::setLoadingPercent(unsigned int percent)
+{
+    loadingPercent_ = percent;
+}
+
 QDomElement Dataset::columnsToXml(QDomDocument& xmlDocument) const
 {
     QDomElement columns{xmlDocument.createElement(XML_COLUMNS)};
@@ -177,6 +274,235 @@ QByteArray Dataset::definitionToXml(unsigned int rowCount) const
     return xmlDocument.toByteArray();
 }
 
+std::tuple<bool, unsigned int> Dataset::matchDefinitionXml(
+    const QByteArray& definitionContent) const
+{
+    QDomDocument xmlDocument;
+    if (!xmlDocument.setContent(definitionContent))
+        return {false, 0};
+
+    const QDomElement root{xmlDocument.documentElement()};
+    const QDomNodeList columns{
+        root.firstChildElement(XML_COLUMNS).childNodes()};
+    if (columns.size() != static_cast<int>(columnsCount_))
+        return {false, 0};
+
+    for (Column column = 0; column < static_cast<int>(columnsCount_); ++column)
+    {
+        const QDomElement columnElement{columns.at(column).toElement()};
+        if (columnElement.attribute(XML_COLUMN_NAME) !=
+                headerColumnNames_.at(column) ||
+            columnElement.attribute(XML_COLUMN_FORMAT).toInt() !=
+                static_cast<int>(columnTypes_.at(column)))
+            return {false, 0};
+    }
+
+    return {true, root.firstChildElement(XML_ROW_COUNT)
+                      .attribute(XML_ROW_COUNT)
+                      .toUInt()};
+}
+
+quint64 Dataset::estimateColumnMemory(Column column,
+                                      unsigned int rowCount) const
+{
+    // Every field is kept in variant, strings as index of shared string.
+    const quint64 fieldsSize{static_cast<quint64>(rowCount) *
+                             sizeof(QVariant)};
+    if (getColumnFormat(column) != ColumnType::STRING ||
+        column >= stringsSamples_.size() ||
+        stringsSamples_[column].values_ == 0)
+        return fieldsSize;
+
+    // Strings seen once in sample are expected to keep appearing in rows
+    // not sampled, repeated ones are expected to be already known.
+    const StringsSample& sample{stringsSamples_[column]};
+    const double notSampledRows{
+        std::max(0., static_cast<double>(rowCount) - sample.values_)};
+    double distinct{sample.distinct_ +
+                    sample.singletons_ * notSampledRows / sample.values_};
+    distinct = std::min(distinct, static_cast<double>(rowCount));
+    if (sharedStrings_.size() > 1)
+        distinct = std::min(distinct,
+                            static_cast<double>(sharedStrings_.size() - 1));
+
+    const double stringSize{sizeof(QVariant) +
+                            MemoryUtilities::ARRAY_HEADER_SIZE +
+                            sizeof(QChar) * (sample.averageLength_ + 1)};
+    return fieldsSize + static_cast<quint64>(distinct * stringSize);
+}
+
+quint64 Dataset::estimateMemory(const QVector<bool>& activeColumns,
+                                unsigned int rowCount) const
+{
+    quint64 size{0};
+    int loadedColumns{0};
+    for (Column column = 0; column < activeColumns.size(); ++column)
+    {
+        if (!activeColumns[column])
+            continue;
+        size += estimateColumnMemory(column, rowCount);
+        loadedColumns++;
+    }
+
+    // Each row is separate vector referenced from vector of rows.
+    if (loadedColumns > 0)
+        size += static_cast<quint64>(rowCount) *
+                (MemoryUtilities::ARRAY_HEADER_SIZE +
+                 sizeof(QVector<QVariant>));
+    return size;
+}
+
+quint64 Dataset::estimateLoadMemory() const
+{
+    QVector<bool> activeColumns(static_cast<int>(columnCount()));
+    for (Column column = 0; column < activeColumns.size(); ++column)
+        activeColumns[column] = isColumnActive(column);
+
+    unsigned int rowsToLoad{rowCount()};
+    if (query_.isPartial())
+        rowsToLoad = std::min(rowsToLoad, query_.rowLimit_);
+    return estimateMemory(activeColumns, rowsToLoad);
+}
+
+quint64 Dataset::getUsedMemory() const
+{
+    quint64 usedMemory{getStringsUsedMemory()};
+    if (isStorageReported(data_))
+        usedMemory += MemoryUtilities::getVectorMemory(data_);
+
+    // Rows have equal sizes, first one is representative.
+    if (areRowsReported())
+        usedMemory += static_cast<quint64>(data_.size()) *
+                      MemoryUtilities::getVectorMemory(data_.constFirst());
+
+    // Strings not interned yet are kept in rows.
+    if (areRowsReported())
+        for (Column column = 0; column < columnTypes_.size(); ++column)
+        {
+            if (columnTypes_.at(column) != ColumnType::STRING)
+                continue;
+            for (const auto& row : data_)
+                if (column < row.size() &&
+                    row.at(column).type() == QVariant::String)
+                    usedMemory += MemoryUtilities::getStringMemory(
+                        row.at(column).toString());
+        }
+
+    if (isStorageReported(columnIndexes_))
+        for (const ColumnIndex& index : columnIndexes_)
+            usedMemory +=
+                MemoryUtilities::getVectorMemory(index.sortRanks_) +
+                MemoryUtilities::getVectorMemory(index.distinctStrings_) +
+                MemoryUtilities::getVectorMemory(index.distinctCounts_);
+
+    const quint64 hashNodeSize{sizeof(void*) + sizeof(uint) + 2 * sizeof(int)};
+    for (const auto& positions : distinctStringPositions_)
+        usedMemory += static_cast<quint64>(positions.size()) * hashNodeSize +
+                      static_cast<quint64>(positions.capacity()) *
+                          sizeof(void*);
+    return usedMemory;
+}
+
+quint64 Dataset::getCachedMemory() const
+{
+    // Releasing shared storage would not free memory.
+    if (isDataShared())
+        return 0;
+
+    quint64 cachedMemory{0};
+    for (const ColumnIndex& index : columnIndexes_)
+        cachedMemory += MemoryUtilities::getVectorMemory(index.sortRanks_);
+    return cachedMemory;
+}
+
+quint64 Dataset::releaseCachedMemory()
+{
+    if (isDataShared())
+        return 0;
+
+    const quint64 releasedMemory{getCachedMemory()};
+    for (ColumnIndex& index : columnIndexes_)
+    {
+        index.sortRanks_.clear();
+        index.sortRanks_.squeeze();
+    }
+    return releasedMemory;
+}
+
+quint64 Dataset::getColumnUsedMemory(Column column) const
+{
+    quint64 usedMemory{0};
+    if (areRowsReported())
+        usedMemory += static_cast<quint64>(data_.size()) * sizeof(QVariant);
+    if (column < columnIndexes_.size() && isStorageReported(columnIndexes_))
+    {
+        const ColumnIndex& index{columnIndexes_[column]};
+        usedMemory += MemoryUtilities::getVectorMemory(index.sortRanks_) +
+                      MemoryUtilities::getVectorMemory(index.distinctStrings_) +
+                      MemoryUtilities::getVectorMemory(index.distinctCounts_);
+    }
+    return usedMemory;
+}
+
+quint64 Dataset::getStringsUsedMemory() const
+{
+    if (!isStorageReported(sharedStrings_))
+        return 0;
+
+    quint64 usedMemory{MemoryUtilities::getVectorMemory(sharedStrings_)};
+    for (const QVariant& string : sharedStrings_)
+        if (string.type() == QVariant::String)
+            usedMemory += MemoryUtilities::getStringMemory(string.toString());
+
+    // Hash keys share content with shared strings, only nodes are counted.
+    const quint64 hashNodeSize{sizeof(void*) + sizeof(uint) +
+                               sizeof(QString) + sizeof(int)};
+    usedMemory += static_cast<quint64>(stringIndexes_.size()) * hashNodeSize +
+                  static_cast<quint64>(stringIndexes_.capacity()) *
+                      sizeof(void*);
+    return usedMemory;
+}
+
+bool Dataset::spillData(QIODevice& device)
+{
+    QDataStream stream(&device);
+    stream << data_ << sharedStrings_;
+    for (const ColumnIndex& index : columnIndexes_)
+        stream << index.sortRanks_;
+    if (stream.status() != QDataStream::Ok)
+        return false;
+
+    data_.clear();
+    data_.squeeze();
+    sharedStrings_.clear();
+    sharedStrings_.squeeze();
+    stringIndexes_.clear();
+    stringIndexes_.squeeze();
+    indexedStringsCount_ = 0;
+    distinctStringPositions_.clear();
+    releaseCachedMemory();
+    return true;
+}
+
+bool Dataset::restoreData(QIODevice& device)
+{
+    QDataStream stream(&device);
+    stream >> data_ >> sharedStrings_;
+    for (ColumnIndex& index : columnIndexes_)
+        stream >> index.sortRanks_;
+    if (stream.status() == QDataStream::Ok &&
+        data_.size() == static_cast<int>(rowsCount_))
+        return true;
+
+    // Broken spill leaves dataset without rows rather than with wrong ones.
+    error_ = QObject::tr("Can not restore data of dataset");
+    data_.clear();
+    sharedStrings_.clear();
+    releaseCachedMemory();
+    rowsCount_ = 0;
+    return false;
+}
+
 QVector<QVector<QVariant>> Dataset::retrieveSampleData()
 {
     return std::move(sampleData_);
@@ -194,6 +520,41 @@ void Dataset::setTaggedColumn(ColumnTag columnTag, Column column)
 
 QString Dataset::getLastError() const { return error_; }
 
+void Dataset::analyzeSampleStrings()
+{
+    stringsSamples_.clear();
+    stringsSamples_.resize(static_cast<int>(columnCount()));
+    for (Column column = 0; column < static_cast<int>(columnCount()); ++column)
+    {
+        if (getColumnFormat(column) != ColumnType::STRING)
+            continue;
+
+        QHash<QString, int> occurrences;
+        qint64 totalLength{0};
+        for (const auto& row : sampleData_)
+        {
+            if (column >= row.size() || row[column].isNull() ||
+                row[column].type() != QVariant::String)
+                continue;
+            const QString string{row[column].toString()};
+            occurrences[string]++;
+            totalLength += string.size();
+        }
+
+        StringsSample& sample{stringsSamples_[column]};
+        for (const int count : occurrences)
+        {
+            sample.values_ += count;
+            if (count == 1)
+                sample.singletons_++;
+        }
+        sample.distinct_ = occurrences.size();
+        if (sample.values_ > 0)
+            sample.averageLength_ =
+                static_cast<double>(totalLength) / sample.values_;
+    }
+}
+
 void Dataset::rebuildDefinitonUsingActiveColumnsOnly()
 {
     QVector<ColumnType> rebuiltColumnsFormat;
@@ -248,6 +609,501 @@ void Dataset::updateSampleDataStrings(QVector<QVector<QVariant>>& data) const
     }
 }
 
+void Dataset::applyQuery(QVector<QVector<QVariant>>& data) const
+{
+    if (query_.mode_ == LoadMode::ROW_RANGE)
+        data = data.mid(static_cast<int>(query_.firstRow_),
+                        static_cast<int>(query_.rowLimit_));
+
+    if (query_.hasPredicates())
+        applyPredicates(data);
+
+    if (query_.mode_ == LoadMode::RANDOM_SAMPLE)
+    {
+        QVector<QVector<QVariant>> sample;
+        QVector<unsigned int> sourceRows;
+        for (int row = 0; row < data.size(); ++row)
+        {
+            const int slot{getReservoirSlot(static_cast<unsigned int>(row))};
+            if (slot == NOT_SAMPLED)
+                continue;
+            if (slot == sample.size())
+            {
+                sample.append(data[row]);
+                sourceRows.append(static_cast<unsigned int>(row));
+            }
+            else
+            {
+                sample[slot] = data[row];
+                sourceRows[slot] = static_cast<unsigned int>(row);
+            }
+        }
+        orderSample(sample, sourceRows);
+        data = sample;
+    }
+}
+
+int Dataset::getReservoirSlot(unsigned int seenRows) const
+{
+    if (seenRows < query_.rowLimit_)
+        return static_cast<int>(seenRows);
+
+    // Each of seen rows stays in sample with equal probability.
+    const quint32 drawn{QRandomGenerator::global()->bounded(seenRows + 1U)};
+    return drawn < query_.rowLimit_ ? static_cast<int>(drawn) : NOT_SAMPLED;
+}
+
+void Dataset::orderSample(QVector<QVector<QVariant>>& sample,
+                          const QVector<unsigned int>& sourceRows)
+{
+    QVector<int> order(sample.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&sourceRows](int left, int right) {
+        return sourceRows[left] < sourceRows[right];
+    });
+
+    QVector<QVector<QVariant>> orderedSample;
+    orderedSample.reserve(sample.size());
+    for (const int index : order)
+        orderedSample.append(std::move(sample[index]));
+    sample = std::move(orderedSample);
+}
+
+void Dataset::applyPredicates(QVector<QVector<QVariant>>& data) const
+{
+    int acceptedRows{0};
+    for (int row = 0; row < data.size(); ++row)
+    {
+        const QVector<QVariant>& currentRow{data[row]};
+        bool accepted{true};
+        for (const auto& predicate : query_.rangePredicates_)
+        {
+            const int dataColumn{getDataColumn(predicate.column_)};
+            if (dataColumn == Constants::NOT_SET_COLUMN)
+                continue;
+            const QVariant& value{currentRow[dataColumn]};
+            const bool isDate{getColumnFormat(predicate.column_) ==
+                              ColumnType::DATE};
+            const double key{isDate ? static_cast<double>(
+                                          value.toDate().toJulianDay())
+                                    : value.toDouble()};
+            if ((isDate && value.isNull()) || key < predicate.min_ ||
+                key > predicate.max_)
+                accepted = false;
+        }
+
+        for (const auto& predicate : query_.stringPredicates_)
+        {
+            const int dataColumn{getDataColumn(predicate.column_)};
+            if (dataColumn != Constants::NOT_SET_COLUMN &&
+                !predicate.acceptedStrings_.contains(
+                    getStringValue(currentRow[dataColumn])))
+                accepted = false;
+        }
+
+        if (accepted)
+        {
+            if (acceptedRows != row)
+                data[acceptedRows] = std::move(data[row]);
+            acceptedRows++;
+        }
+    }
+    data.resize(acceptedRows);
+}
+
+int Dataset::getDataColumn(Column column) const
+{
+    // Loaded data contains active columns only.
+    if (!activeColumns_[column])
+        return Constants::NOT_SET_COLUMN;
+    return static_cast<int>(std::count(activeColumns_.constBegin(),
+                                       activeColumns_.constBegin() + column,
+                                       true));
+}
+
+void Dataset::internStrings()
+{
+    for (Column column = 0; column < static_cast<Column>(columnCount());
+         ++column)
+    {
+        if (columnTypes_.at(column) != ColumnType::STRING)
+            continue;
+
+        QHash<QString, int> stringIndexes;
+        internColumnStrings(data_, column, stringIndexes);
+    }
+}
+
+void Dataset::internColumnStrings(QVector<QVector<QVariant>>& rows,
+                                  int dataColumn,
+                                  QHash<QString, int>& stringIndexes)
+{
+    for (auto& row : rows)
+    {
+        // Checked using const access, rows can be shared.
+        if (row.at(dataColumn).isNull() ||
+            row.at(dataColumn).type() != QVariant::String)
+            continue;
+
+        QVariant& value{row[dataColumn]};
+        const QString string{value.toString()};
+        auto it{stringIndexes.constFind(string)};
+        if (it == stringIndexes.constEnd())
+        {
+            it = stringIndexes.insert(string, sharedStrings_.size());
+            sharedStrings_.append(value);
+        }
+        value = QVariant(it.value());
+    }
+}
+
+bool Dataset::isFollowable() const { return false; }
+
+QVector<QVector<QVariant>> Dataset::readAppendedRows() { return {}; }
+
+QString Dataset::getSourceId() const { return {}; }
+
+void Dataset::releaseLoadingBuffers() {}
+
+bool Dataset::canShareDataOf(const Dataset& other) const
+{
+    const QString sourceId{getSourceId()};
+    if (sourceId.isEmpty() || sourceId != other.getSourceId() ||
+        metaObject() != other.metaObject())
+        return false;
+
+    // Other dataset needs to be loaded and not hibernated.
+    if (other.data_.size() != static_cast<int>(other.rowsCount_) ||
+        !other.activeColumns_.isEmpty())
+        return false;
+
+    if (query_.hasPredicates() || query_.isPartial() ||
+        other.query_.hasPredicates() || other.query_.isPartial())
+        return false;
+
+    Column otherColumn{0};
+    for (Column column = 0; column < static_cast<Column>(columnCount());
+         ++column)
+    {
+        if (!isColumnActive(column))
+            continue;
+        if (otherColumn >= static_cast<Column>(other.columnCount()) ||
+            other.getHeaderName(otherColumn) != getHeaderName(column) ||
+            other.getColumnFormat(otherColumn) != getColumnFormat(column))
+            return false;
+        otherColumn++;
+    }
+    return otherColumn == static_cast<Column>(other.columnCount());
+}
+
+void Dataset::shareDataOf(const Dataset& other)
+{
+    data_ = other.data_;
+    sharedStrings_ = other.sharedStrings_;
+    columnIndexes_ = other.columnIndexes_;
+    rowsCount_ = other.rowsCount_;
+    dataTakenFromOther_ = true;
+    dataSharingToken_ = other.dataSharingToken_;
+    rebuildDefinitonUsingActiveColumnsOnly();
+    releaseLoadingBuffers();
+    closeZip();
+}
+
+bool Dataset::isDataShared() const
+{
+    // Rows are shared as whole vector or one by one, any subset of them can
+    // be taken, so sharing is tracked explicitly.
+    return !data_.isEmpty() && dataSharingToken_.use_count() > 1;
+}
+
+void Dataset::shareRowsOf(const Dataset& other, const QVector<int>& rows)
+{
+    columnTypes_ = other.columnTypes_;
+    headerColumnNames_ = other.headerColumnNames_;
+    taggedColumns_ = other.taggedColumns_;
+    columnsCount_ = other.columnsCount_;
+
+    data_.clear();
+    data_.reserve(rows.size());
+    for (const int row : rows)
+        data_.append(other.data_.at(row));
+    rowsCount_ = static_cast<unsigned int>(data_.size());
+    sharedStrings_ = other.sharedStrings_;
+    dataTakenFromOther_ = true;
+    dataSharingToken_ = other.dataSharingToken_;
+
+    columnIndexes_.fill(ColumnIndex(), static_cast<int>(columnCount()));
+    updateColumnStatistics(0);
+}
+
+std::function<QVector<ColumnProfile>()> Dataset::createProfiler() const
+{
+    // Snapshot shares storage, dataset detaches it when modified.
+    return [rows = data_, strings = sharedStrings_, types = columnTypes_]() {
+        QVector<ColumnProfile> profiles(types.size());
+        ColumnProfile* results{profiles.data()};
+        std::atomic<int> nextColumn{0};
+        auto profileColumns{[&]() {
+            for (int column = nextColumn++; column < types.size();
+                 column = nextColumn++)
+                results[column] =
+                    (types[column] == ColumnType::STRING
+                         ? profileStringColumn(rows, strings, column)
+                         : profileValueColumn(rows, column, types[column]));
+        }};
+
+        const int workers{std::clamp(
+            static_cast<int>(std::thread::hardware_concurrency()), 1,
+            std::max(1, types.size()))};
+        std::vector<std::future<void>> pendingWorkers;
+        for (int worker = 1; worker < workers; ++worker)
+            pendingWorkers.push_back(
+                std::async(std::launch::async, profileColumns));
+        profileColumns();
+        for (auto& pendingWorker : pendingWorkers)
+            pendingWorker.wait();
+        return profiles;
+    };
+}
+
+ColumnProfile Dataset::profileStringColumn(
+    const QVector<QVector<QVariant>>& rows, const QVector<QVariant>& strings,
+    Column column)
+{
+    // Loaded rows keep strings as indexes of shared strings.
+    ColumnProfile profile;
+    QVector<int> counts(strings.size(), 0);
+    for (const auto& row : rows)
+    {
+        const QVariant& value{row.at(column)};
+        if (value.isNull())
+            profile.emptyValues_++;
+        else
+            counts[value.toInt()]++;
+    }
+
+    QVector<std::pair<int, int>> occurrences;
+    for (int index = 0; index < counts.size(); ++index)
+    {
+        if (counts[index] == 0)
+            continue;
+        profile.strings_.append(strings[index].toString());
+        occurrences.append({counts[index], index});
+    }
+    profile.distinctValues_ = occurrences.size();
+
+    const int topCount{std::min(PROFILE_TOP_VALUES, occurrences.size())};
+    std::partial_sort(occurrences.begin(), occurrences.begin() + topCount,
+                      occurrences.end(),
+                      [](const auto& left, const auto& right) {
+                          return left.first > right.first ||
+                                 (left.first == right.first &&
+                                  left.second < right.second);
+                      });
+    for (int i = 0; i < topCount; ++i)
+        profile.topValues_.append(
+            {strings[occurrences[i].second], occurrences[i].first});
+    return profile;
+}
+
+ColumnProfile Dataset::profileValueColumn(
+    const QVector<QVector<QVariant>>& rows, Column column,
+    ColumnType columnType)
+{
+    // Dates are counted as julian days.
+    ColumnProfile profile;
+    QHash<double, int> counts;
+    for (const auto& row : rows)
+    {
+        const QVariant& value{row.at(column)};
+        if (value.isNull())
+        {
+            profile.emptyValues_++;
+            continue;
+        }
+        counts[columnType == ColumnType::DATE
+                   ? static_cast<double>(value.toDate().toJulianDay())
+                   : value.toDouble()]++;
+    }
+    profile.distinctValues_ = counts.size();
+    if (counts.isEmpty())
+        return profile;
+
+    auto toVariant{[columnType](double value) {
+        return columnType == ColumnType::DATE
+                   ? QVariant(QDate::fromJulianDay(static_cast<qint64>(value)))
+                   : QVariant(value);
+    }};
+    const auto [lowest, highest] =
+        std::minmax_element(counts.keyBegin(), counts.keyEnd());
+    const double minValue{*lowest};
+    const double maxValue{*highest};
+    profile.min_ = toVariant(minValue);
+    profile.max_ = toVariant(maxValue);
+
+    // Histogram is built from distinct values, rows are not scanned again.
+    profile.histogram_.fill(0, PROFILE_HISTOGRAM_BINS);
+    QVector<std::pair<int, double>> occurrences;
+    occurrences.reserve(counts.size());
+    for (auto it = counts.constBegin(); it != counts.constEnd(); ++it)
+    {
+        int bin{0};
+        if (maxValue > minValue)
+            bin = std::min(PROFILE_HISTOGRAM_BINS - 1,
+                           static_cast<int>((it.key() - minValue) /
+                                            (maxValue - minValue) *
+                                            PROFILE_HISTOGRAM_BINS));
+        profile.histogram_[bin] += it.value();
+        occurrences.append({it.value(), it.key()});
+    }
+
+    const int topCount{std::min(PROFILE_TOP_VALUES, occurrences.size())};
+    std::partial_sort(occurrences.begin(), occurrences.begin() + topCount,
+                      occurrences.end(),
+                      [](const auto& left, const auto& right) {
+                          return left.first > right.first ||
+                                 (left.first == right.first &&
+                                  left.second < right.second);
+                      });
+    for (int i = 0; i < topCount; ++i)
+        profile.topValues_.append(
+            {toVariant(occurrences[i].second), occurrences[i].first});
+    return profile;
+}
+
+bool Dataset::areRowsReported() const
+{
+    return isStorageReported(data_) && !data_.isEmpty() &&
+           isStorageReported(data_.constFirst());
+}
+
+void Dataset::appendRows(QVector<QVector<QVariant>> rows)
+{
+    if (rows.isEmpty())
+        return;
+
+    // Statistics of loaded rows are computed once, later only new rows.
+    const int first{data_.size()};
+    if (columnIndexes_.isEmpty())
+    {
+        columnIndexes_.fill(ColumnIndex(), static_cast<int>(columnCount()));
+        updateColumnStatistics(0);
+    }
+
+    if (indexedStringsCount_ != sharedStrings_.size())
+    {
+        stringIndexes_.clear();
+        for (int index = 0; index < sharedStrings_.size(); ++index)
+            stringIndexes_.insert(sharedStrings_[index].toString(), index);
+        indexedStringsCount_ = sharedStrings_.size();
+    }
+
+    for (Column column = 0; column < static_cast<Column>(columnCount());
+         ++column)
+    {
+        if (columnTypes_.at(column) != ColumnType::STRING)
+            continue;
+
+        for (auto& row : rows)
+        {
+            QVariant& value{row[column]};
+            if (value.isNull() || value.type() != QVariant::String)
+                continue;
+
+            const QString string{value.toString()};
+            auto it{stringIndexes_.constFind(string)};
+            if (it == stringIndexes_.constEnd())
+            {
+                it = stringIndexes_.insert(string, sharedStrings_.size());
+                sharedStrings_.append(value);
+                ++indexedStringsCount_;
+            }
+            value = QVariant(it.value());
+        }
+    }
+
+    data_.append(rows);
+    rowsCount_ = static_cast<unsigned int>(data_.size());
+    updateColumnStatistics(first);
+}
+
+void Dataset::updateColumnStatistics(int first)
+{
+    if (first == 0)
+        distinctStringPositions_.clear();
+    distinctStringPositions_.resize(columnIndexes_.size());
+
+    for (Column column = 0; column < static_cast<Column>(columnCount());
+         ++column)
+    {
+        ColumnIndex& index{columnIndexes_[column]};
+        index.sortRanks_.clear();
+        const ColumnType columnType{columnTypes_.at(column)};
+        if (columnType == ColumnType::STRING)
+        {
+            QHash<int, int>& positions{distinctStringPositions_[column]};
+            if (positions.size() != index.distinctStrings_.size())
+            {
+                positions.clear();
+                for (int position = 0;
+                     position < index.distinctStrings_.size(); ++position)
+                    positions.insert(index.distinctStrings_[position],
+                                     position);
+            }
+            for (int row = first; row < data_.size(); ++row)
+            {
+                const QVariant& value{data_.at(row).at(column)};
+                if (value.isNull())
+                    continue;
+                const int string{value.toInt()};
+                auto it{positions.constFind(string)};
+                if (it == positions.constEnd())
+                {
+                    it = positions.insert(string,
+                                          index.distinctStrings_.size());
+                    index.distinctStrings_.append(string);
+                    index.distinctCounts_.append(0);
+                }
+                ++index.distinctCounts_[it.value()];
+            }
+            continue;
+        }
+
+        for (int row = first; row < data_.size(); ++row)
+        {
+            const QVariant& value{data_.at(row).at(column)};
+            if (value.isNull())
+            {
+                index.emptyValues_ = true;
+                continue;
+            }
+            if (columnType == ColumnType::DATE)
+            {
+                const QDate date{value.toDate()};
+                if (index.min_.isNull() || date < index.min_.toDate())
+                    index.min_ = date;
+                if (index.max_.isNull() || date > index.max_.toDate())
+                    index.max_ = date;
+                continue;
+            }
+            const double number{value.toDouble()};
+            if (index.min_.isNull() || number < index.min_.toDouble())
+                index.min_ = number;
+            if (index.max_.isNull() || number > index.max_.toDouble())
+                index.max_ = number;
+        }
+    }
+}
+
+QString Dataset::getStringValue(const QVariant& value) const
+{
+    if (value.isNull())
+        return QString();
+    if (value.type() == QVariant::String)
+        return value.toString();
+    return sharedStrings_[value.toInt()].toString();
+}
+
 bool Dataset::isColumnTagged(ColumnTag tag) const
 {
     return taggedColumns_.contains(tag);
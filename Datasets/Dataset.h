@@ -1,26 +1,33 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <memory>
 
 #include <ColumnType.h>
+#include <QHash>
 #include <QMap>
 #include <QObject>
 #include <QVariant>
 #include <QVector>
 
+#include <ColumnProfile.h>
 #include <ColumnTag.h>
+#include <DatasetIndex.h>
+#include <MemoryReporter.h>
+
+#include "LoadQuery.h"
 
 class DatasetDefinition;
 class QDomDocument;
 class QDomElement;
-
-typedef int Column;
+class QIODevice;
 
 /**
  * @class Dataset
  * @brief Representation for set of data.
  */
-class Dataset : public QObject
+class Dataset : public QObject, public MemoryReporter
 {
     Q_OBJECT
 public:
@@ -51,16 +58,18 @@ public:
      * @param column Column for which data need to be retrieved.
      * @return Pointer to QVariant with data.
      */
-    virtual inline QVariant* getData(int row, Column column)
+    virtual inline const QVariant* getData(int row, Column column) const
     {
+        // Const access, non-const one would detach shared rows.
+        const QVariant& value{data_.at(row).at(column)};
         if (getColumnFormat(column) == ColumnType::STRING)
         {
-            if (data_[row][column].isNull())
+            if (value.isNull())
                 return &nullStringVariant_;
-            if (data_[row][column].type() != QVariant::String)
-                return &sharedStrings_[data_[row][column].toInt()];
+            if (value.type() != QVariant::String)
+                return &sharedStrings_.at(value.toInt());
         }
-        return &data_[row][column];
+        return &value;
     }
 
     /**
@@ -87,10 +96,24 @@ public:
     /**
      * @brief Get list of unique strings in given column.
      * @param column Column index.
-     * @return String list for given column.
+     * @return Strings of column in order of first occurrence.
      */
     QStringList getStringList(Column column) const;
 
+    /**
+     * @brief Check if precomputed sort ranks of columns are available.
+     * @return True if available, false otherwise.
+     */
+    bool hasSortRanks() const;
+
+    /**
+     * @brief Get rank of value in sorted column. Equal values share rank.
+     * @param row Row index.
+     * @param column Column index.
+     * @return Sort rank.
+     */
+    quint32 getSortRank(int row, Column column) const;
+
     /**
      * @brief Get index of tagged column if available.
      * @param columnTag Type of tagged column.
@@ -105,6 +128,13 @@ public:
      */
     QString getHeaderName(Column column) const;
 
+    /**
+     * @brief Check if column is going to be loaded.
+     * @param column Column index.
+     * @return True if column is active or columns were already rebuilt.
+     */
+    bool isColumnActive(Column column) const;
+
     /**
      * @brief Check if dataset is valid.
      * @return True if valid, false otherwise.
@@ -129,6 +159,48 @@ public:
      */
     bool loadData();
 
+    /**
+     * @brief Load only given columns and rows matching given predicates.
+     * @param query Columns and predicates.
+     * @return True if succeed, false otherwise.
+     */
+    bool loadData(const LoadQuery& query);
+
+    /**
+     * @brief Set columns, predicates and rows to use in next load.
+     * @param query Load query.
+     */
+    void setLoadQuery(const LoadQuery& query);
+
+    /**
+     * @brief Get query used to load data.
+     * @return Load query.
+     */
+    const LoadQuery& getLoadQuery() const;
+
+    /**
+     * @brief Get progress of ongoing load. Safe to call from other threads.
+     * @return Percent of data loaded.
+     */
+    unsigned int getLoadingPercent() const;
+
+    /**
+     * @brief Request stop of ongoing load. Safe to call from other threads.
+     */
+    virtual void cancelLoading();
+
+    /**
+     * @brief Check if load was cancelled.
+     * @return True if cancel was requested, false otherwise.
+     */
+    bool isLoadingCancelled() const;
+
+    /**
+     * @brief Emit loaded rows in chunks while loading is ongoing.
+     * @param progressive Flag indicating chunks should be emitted.
+     */
+    void setProgressiveLoading(bool progressive);
+
     /**
      * @brief Create XML with definition of dataset
      * @param rowCount Number of rows active in view.
@@ -136,6 +208,15 @@ public:
      */
     QByteArray definitionToXml(unsigned int rowCount) const;
 
+    /**
+     * @brief Check if definition created by definitionToXml() describes
+     * columns with same names and types as dataset.
+     * @param definitionContent Definition as XML.
+     * @return Flag indicating columns match and row count from definition.
+     */
+    std::tuple<bool, unsigned int> matchDefinitionXml(
+        const QByteArray& definitionContent) const;
+
     /**
      * @brief Retrieve sample data (data is moved).
      * @return Sample data.
@@ -161,6 +242,136 @@ public:
      */
     QString getLastError() const;
 
+    /**
+     * @brief Check if rows appended to source after load can be read.
+     * @return True if dataset follows its source, false otherwise.
+     */
+    virtual bool isFollowable() const;
+
+    /**
+     * @brief Get identifier of source in its current state. Datasets with
+     * equal identifiers, columns and queries load same rows.
+     * @return Identifier or empty string when source can not be identified.
+     */
+    virtual QString getSourceId() const;
+
+    /**
+     * @brief Check if rows of other loaded dataset can be taken instead of
+     * loading them. Source, active columns and load query need to match.
+     * @param other Loaded dataset.
+     * @return True if data can be shared, false otherwise.
+     */
+    bool canShareDataOf(const Dataset& other) const;
+
+    /**
+     * @brief Take rows, strings and indexes of other loaded dataset instead
+     * of loading them. Storage is implicitly shared and copied only when one
+     * of datasets modifies it.
+     * @param other Loaded dataset.
+     */
+    void shareDataOf(const Dataset& other);
+
+    /**
+     * @brief Check if rows are shared with other dataset.
+     * @return True if rows are shared, false otherwise.
+     */
+    bool isDataShared() const;
+
+    /**
+     * @brief Take given rows of other loaded dataset. Rows and strings are
+     * implicitly shared, only references to rows are stored. Statistics of
+     * columns are computed for taken rows.
+     * @param other Loaded dataset.
+     * @param rows Rows of other dataset to take.
+     */
+    void shareRowsOf(const Dataset& other, const QVector<int>& rows);
+
+    /**
+     * @brief Create function computing profiles of columns in parallel.
+     * Function works on snapshot of rows taken now, so it can be called on
+     * other thread while dataset is used or modified.
+     * @return Function returning profile of each column.
+     */
+    std::function<QVector<ColumnProfile>()> createProfiler() const;
+
+    /**
+     * @brief Read rows appended to source since load or previous read. Can
+     * be called from other thread, but not concurrently with itself.
+     * @return Rows of active columns with plain strings.
+     */
+    virtual QVector<QVector<QVariant>> readAppendedRows();
+
+    /**
+     * @brief Append rows to loaded dataset. Strings are interned and column
+     * statistics are updated using appended rows only. Sort ranks are
+     * dropped.
+     * @param rows Rows of active columns with plain strings.
+     */
+    void appendRows(QVector<QVector<QVariant>> rows);
+
+    /**
+     * @brief Estimate memory needed to keep column loaded. Estimation uses
+     * column type and cardinality and lengths of strings found in sample.
+     * @param column Column index.
+     * @param rowCount Number of rows to load.
+     * @return Estimated size in bytes.
+     */
+    quint64 estimateColumnMemory(Column column, unsigned int rowCount) const;
+
+    /**
+     * @brief Estimate memory needed to keep given columns loaded.
+     * @param activeColumns Flags of columns to load.
+     * @param rowCount Number of rows to load.
+     * @return Estimated size in bytes.
+     */
+    quint64 estimateMemory(const QVector<bool>& activeColumns,
+                           unsigned int rowCount) const;
+
+    /**
+     * @brief Estimate memory needed to load using active columns and query.
+     * @return Estimated size in bytes.
+     */
+    quint64 estimateLoadMemory() const;
+
+    quint64 getUsedMemory() const override;
+
+    /**
+     * @brief Sort ranks are cached, views sort without them.
+     * @return Bytes used by sort ranks.
+     */
+    quint64 getCachedMemory() const override;
+
+    quint64 releaseCachedMemory() override;
+
+    /**
+     * @brief Get memory used by fields and statistics of column. Strings are
+     * shared between columns and not included.
+     * @param column Column index.
+     * @return Used bytes.
+     */
+    quint64 getColumnUsedMemory(Column column) const;
+
+    /**
+     * @brief Get memory used by shared strings.
+     * @return Used bytes.
+     */
+    quint64 getStringsUsedMemory() const;
+
+    /**
+     * @brief Write rows, shared strings and sort ranks to device and release
+     * them. Definition and statistics of columns are kept.
+     * @param device Device opened for writing.
+     * @return True if success, false otherwise.
+     */
+    bool spillData(QIODevice& device);
+
+    /**
+     * @brief Read rows, shared strings and sort ranks written by spillData().
+     * @param device Device opened for reading.
+     * @return True if success, false otherwise.
+     */
+    bool restoreData(QIODevice& device);
+
 protected:
     virtual bool analyze() = 0;
 
@@ -170,8 +381,41 @@ protected:
 
     virtual void closeZip() = 0;
 
+    /**
+     * @brief Release buffers read from source for loading. Called when rows
+     * are taken from other dataset, so source is not loaded.
+     */
+    virtual void releaseLoadingBuffers();
+
     void updateSampleDataStrings(QVector<QVector<QVariant>>& data) const;
 
+    /**
+     * @brief Replace plain strings in column of loaded rows by indexes of
+     * sharedStrings_, so equal strings of column are stored once. Can be
+     * called for parts of rows while they are loaded.
+     * @param rows Loaded rows.
+     * @param dataColumn Column in rows.
+     * @param stringIndexes Index of each string of column, kept between
+     * parts of rows.
+     */
+    void internColumnStrings(QVector<QVector<QVariant>>& rows, int dataColumn,
+                             QHash<QString, int>& stringIndexes);
+
+    void setLoadingPercent(unsigned int percent);
+
+    bool isProgressiveLoading() const;
+
+    int getReservoirSlot(unsigned int seenRows) const;
+
+    static void orderSample(QVector<QVector<QVariant>>& sample,
+                            const QVector<unsigned int>& sourceRows);
+
+    /// Returned by getReservoirSlot() for rows not taken into sample.
+    static constexpr int NOT_SAMPLED{-1};
+
+    /// Data of dataset. String columns got names in sharedStrings_.
+    QVector<QVector<QVariant>> data_;
+
     QVector<QVariant> sharedStrings_;
 
     bool valid_{false};
@@ -190,6 +434,27 @@ protected:
 
     QString error_;
 
+    /// Predicates rows need to match to be loaded.
+    LoadQuery query_;
+
+    /// Set by implementations dropping non-matching rows while parsing.
+    bool queryAppliedWhileLoading_{false};
+
+    /// Precomputed indexes of active columns, empty when not available.
+    QVector<ColumnIndex> columnIndexes_;
+
+    /// Load progress, written by loading thread and polled by GUI.
+    std::atomic<unsigned int> loadingPercent_{0};
+
+    std::atomic<bool> loadingCancelled_{false};
+
+    bool progressiveLoading_{false};
+
+    /// Rows in first emitted chunk, kept small to show data quickly.
+    static constexpr int FIRST_LOADED_CHUNK_SIZE{1000};
+
+    static constexpr int LOADED_CHUNK_SIZE{100000};
+
     const QString XML_NAME{QStringLiteral("DATASET")};
     const QString XML_COLUMNS{QStringLiteral("COLUMNS")};
     const QString XML_COLUMN{QStringLiteral("COLUMN")};
@@ -200,10 +465,71 @@ protected:
     const QString XML_ROW_COUNT{QStringLiteral("ROW_COUNT")};
 
 private:
+    /**
+     * @brief Strings of single column found in sample.
+     */
+    struct StringsSample
+    {
+        int values_{0};
+        int distinct_{0};
+        int singletons_{0};
+        double averageLength_{0.};
+    };
+
+    void analyzeSampleStrings();
+
     void rebuildDefinitonUsingActiveColumnsOnly();
 
     bool isColumnTagged(ColumnTag tag) const;
 
+    void applyQuery(QVector<QVector<QVariant>>& data) const;
+
+    void applyPredicates(QVector<QVector<QVariant>>& data) const;
+
+    /**
+     * @brief Replace plain strings left in string columns by indexes of
+     * sharedStrings_. Dictionary of each column is released before next
+     * column is processed.
+     */
+    void internStrings();
+
+    /**
+     * @brief Update minimums, maximums and distinct strings of columns.
+     * @param first First row to take into account.
+     */
+    void updateColumnStatistics(int first);
+
+    int getDataColumn(Column column) const;
+
+    /**
+     * @brief Check if memory of storage is reported by this dataset. Storage
+     * taken from other dataset is reported there while it is shared.
+     * @param storage Vector of dataset.
+     * @return True if storage is reported, false otherwise.
+     */
+    template <typename T>
+    bool isStorageReported(const QVector<T>& storage) const
+    {
+        return !dataTakenFromOther_ || storage.isDetached();
+    }
+
+    bool areRowsReported() const;
+
+    static ColumnProfile profileStringColumn(
+        const QVector<QVector<QVariant>>& rows,
+        const QVector<QVariant>& strings, Column column);
+
+    static ColumnProfile profileValueColumn(
+        const QVector<QVector<QVariant>>& rows, Column column,
+        ColumnType columnType);
+
+    /// Number of most frequent values kept in profile of column.
+    static constexpr int PROFILE_TOP_VALUES{5};
+
+    static constexpr int PROFILE_HISTOGRAM_BINS{20};
+
+    QString getStringValue(const QVariant& value) const;
+
     QDomElement columnsToXml(QDomDocument& xmlDocument) const;
 
     QDomElement rowCountToXml(QDomDocument& xmlDocument,
@@ -215,16 +541,34 @@ private:
 
     QVector<QVector<QVariant>> sampleData_;
 
-    /// Data of dataset. String columns got names in sharedStrings_.
-    QVector<QVector<QVariant>> data_;
+    /// Strings found in sample for each column, used to estimate memory.
+    QVector<StringsSample> stringsSamples_;
+
+    /// Rows were taken from other dataset which reports memory of them.
+    bool dataTakenFromOther_{false};
+
+    /// Token held by all datasets using same rows. Rows are shared while
+    /// token has more than one holder, value of it is not used.
+    std::shared_ptr<bool> dataSharingToken_{std::make_shared<bool>()};
+
+    /// Index of each shared string, filled when rows get appended.
+    QHash<QString, int> stringIndexes_;
+
+    /// Number of shared strings put into stringIndexes_. Equal strings of
+    /// different columns can be stored more than once.
+    int indexedStringsCount_{0};
+
+    /// Position of each string index in distinct strings of column, filled
+    /// when rows get appended.
+    QVector<QHash<int, int>> distinctStringPositions_;
 
     /// Stores information about columns which are tagged.
     QMap<ColumnTag, Column> taggedColumns_;
 
 Q_SIGNALS:
     /**
-     * @brief Signal for loading percent changes
-     * @param newPercentage New percent.
+     * @brief Emitted from loading thread when progressive loading is set.
+     * @param rows Loaded rows of active columns with strings resolved.
      */
-    void loadingPercentChanged(unsigned int newPercentage);
+    void rowsLoaded(const QVector<QVector<QVariant>>& rows);
 };
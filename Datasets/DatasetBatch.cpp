@@ -0,0 +1,363 @@
+#include "DatasetBatch.h"
+
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <thread>
+
+#include <QDate>
+#include <QFileInfo>
+#include <QLocale>
+
+#include <Logger.h>
+
+#include "DatasetDsv.h"
+#include "DatasetOds.h"
+#include "DatasetXlsx.h"
+
+namespace
+{
+std::size_t getMaxPendingFiles()
+{
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+QVariant widenValue(const QVariant& value, ColumnType fileType)
+{
+    if (value.isNull() || fileType == ColumnType::STRING)
+        return value;
+    if (fileType == ColumnType::DATE)
+        return value.toDate().toString(Qt::ISODate);
+    return QString::number(value.toDouble(), 'g',
+                           QLocale::FloatingPointShortest);
+}
+}  // namespace
+
+DatasetBatch::DatasetBatch(const QString& name, const QStringList& filePaths,
+                           QObject* parent)
+    : Dataset(name, parent), filePaths_(filePaths)
+{
+}
+
+DatasetBatch::~DatasetBatch() = default;
+
+void DatasetBatch::setSourceFileColumn(bool sourceFileColumn)
+{
+    sourceFileColumn_ = sourceFileColumn;
+}
+
+std::unique_ptr<Dataset> DatasetBatch::createFileDataset(
+    const QFileInfo& fileInfo, const QString& name)
+{
+    const QString suffix{fileInfo.suffix().toLower()};
+    const QString filePath{fileInfo.canonicalFilePath()};
+    if (suffix == QLatin1String("xlsx"))
+        return std::make_unique<DatasetXlsx>(name, filePath);
+    if (suffix == QLatin1String("ods"))
+        return std::make_unique<DatasetOds>(name, filePath);
+    if (suffix == QLatin1String("csv") || suffix == QLatin1String("tsv") ||
+        suffix == QLatin1String("txt"))
+        return std::make_unique<DatasetDsv>(name, filePath);
+    return nullptr;
+}
+
+bool DatasetBatch::analyze()
+{
+    if (filePaths_.isEmpty())
+    {
+        error_ = QObject::tr("No files to import.");
+        return false;
+    }
+
+    // Files are analysed on at most one thread per core.
+    std::deque<std::future<FileDataset>> pendingFiles;
+    files_.clear();
+    fileColumnTypes_.clear();
+    bool success{true};
+    auto addOldestFile{[&]() {
+        FileDataset dataset{pendingFiles.front().get()};
+        pendingFiles.pop_front();
+        const int fileIndex{static_cast<int>(files_.size())};
+        if (success && dataset == nullptr)
+        {
+            error_ = QObject::tr("Not supported type of file ") +
+                     filePaths_[fileIndex];
+            success = false;
+        }
+        success = success && addFileDefinition(fileIndex, *dataset);
+
+        // Files are initialized again when loaded, first one gives sample.
+        if (fileIndex > 0)
+            dataset = nullptr;
+        files_.push_back(std::move(dataset));
+    }};
+
+    for (const QString& filePath : filePaths_)
+    {
+        if (pendingFiles.size() >= getMaxPendingFiles())
+            addOldestFile();
+        pendingFiles.push_back(std::async(std::launch::async,
+                                          &DatasetBatch::initializeFile,
+                                          this, filePath));
+    }
+    while (!pendingFiles.empty())
+        addOldestFile();
+
+    if (!success)
+    {
+        files_.clear();
+        return false;
+    }
+
+    if (sourceFileColumn_)
+    {
+        headerColumnNames_.append(QObject::tr("File"));
+        columnTypes_.append(ColumnType::STRING);
+        ++columnsCount_;
+    }
+
+    valid_ = true;
+    LOG(LogTypes::IMPORT_EXPORT,
+        "Batch of " + QString::number(filePaths_.size()) + " files having " +
+            QString::number(rowsCount_) + " rows.");
+    return true;
+}
+
+std::tuple<bool, QVector<QVector<QVariant>>> DatasetBatch::getSample()
+{
+    // Sample is taken from first file.
+    QVector<QVector<QVariant>> sample{files_.front()->retrieveSampleData()};
+    files_.front() = nullptr;
+    for (auto& row : sample)
+    {
+        for (Column column = 0; column < getFileColumnCount(); ++column)
+            if (columnTypes_[column] == ColumnType::STRING)
+                row[column] =
+                    widenValue(row[column], fileColumnTypes_[0][column]);
+        if (sourceFileColumn_)
+            row.append(getSourceFileName(0));
+    }
+    return {true, sample};
+}
+
+std::tuple<bool, QVector<QVector<QVariant>>> DatasetBatch::getAllData()
+{
+    if (!isValid())
+        return {false, {}};
+
+    // Files are loaded concurrently and appended in order.
+    files_.resize(static_cast<std::size_t>(filePaths_.size()));
+    std::deque<std::future<bool>> pendingFiles;
+    QVector<QVector<QVariant>> data;
+    data.reserve(static_cast<int>(rowCount()));
+    QHash<QString, int> stringIndexes;
+    sharedStrings_.clear();
+    bool success{true};
+    int appendedFiles{0};
+    auto appendOldestFile{[&]() {
+        const bool loaded{pendingFiles.front().get()};
+        pendingFiles.pop_front();
+        const int fileIndex{appendedFiles++};
+        FileDataset& dataset{files_[static_cast<std::size_t>(fileIndex)]};
+        success = success && loaded && !isLoadingCancelled();
+        if (success)
+            appendFileData(fileIndex, *dataset, data, stringIndexes);
+        dataset = nullptr;
+        setLoadingPercent(static_cast<unsigned int>(100 * appendedFiles /
+                                                    filePaths_.size()));
+    }};
+
+    for (int fileIndex = 0; fileIndex < filePaths_.size(); ++fileIndex)
+    {
+        if (pendingFiles.size() >= getMaxPendingFiles())
+            appendOldestFile();
+        pendingFiles.push_back(std::async(
+            std::launch::async, &DatasetBatch::loadFile, this, fileIndex,
+            std::ref(files_[static_cast<std::size_t>(fileIndex)])));
+    }
+    while (!pendingFiles.empty())
+        appendOldestFile();
+
+    if (!success)
+        return {false, {}};
+
+    LOG(LogTypes::IMPORT_EXPORT,
+        "Loaded " + QString::number(filePaths_.size()) + " files having " +
+            QString::number(data.size()) + " rows and " +
+            QString::number(sharedStrings_.size()) + " distinct strings.");
+    return {true, data};
+}
+
+void DatasetBatch::closeZip() { files_.clear(); }
+
+void DatasetBatch::cancelLoading()
+{
+    Dataset::cancelLoading();
+    const std::lock_guard<std::mutex> lock(loadingFilesMutex_);
+    for (Dataset* dataset : loadingFiles_)
+        dataset->cancelLoading();
+}
+
+DatasetBatch::FileDataset DatasetBatch::initializeFile(
+    const QString& filePath) const
+{
+    const QFileInfo fileInfo(filePath);
+    FileDataset dataset{createFileDataset(fileInfo, fileInfo.baseName())};
+    if (dataset != nullptr)
+        dataset->initialize();
+    return dataset;
+}
+
+bool DatasetBatch::addFileDefinition(int fileIndex, const Dataset& dataset)
+{
+    if (!dataset.isValid())
+    {
+        error_ = QObject::tr("Can not import file ") + filePaths_[fileIndex] +
+                 (dataset.getLastError().isEmpty()
+                      ? QString()
+                      : QStringLiteral(": ") + dataset.getLastError());
+        LOG(LogTypes::IMPORT_EXPORT, error_);
+        return false;
+    }
+
+    QStringList columnNames;
+    QVector<ColumnType> columnTypes;
+    for (Column column = 0;
+         column < static_cast<Column>(dataset.columnCount()); ++column)
+    {
+        columnNames.append(dataset.getHeaderName(column));
+        columnTypes.append(dataset.getColumnFormat(column));
+    }
+
+    if (fileIndex == 0)
+    {
+        headerColumnNames_ = columnNames;
+        columnTypes_ = columnTypes;
+        columnsCount_ = dataset.columnCount();
+        rowsCount_ = 0;
+    }
+    else if (columnNames != headerColumnNames_)
+    {
+        error_ = QObject::tr("Columns of file ") + filePaths_[fileIndex] +
+                 QObject::tr(" differ from columns of file ") +
+                 filePaths_.constFirst();
+        LOG(LogTypes::IMPORT_EXPORT, error_);
+        return false;
+    }
+
+    for (int column = 0; column < columnTypes_.size(); ++column)
+        if (columnTypes_[column] != columnTypes[column])
+            columnTypes_[column] = ColumnType::STRING;
+
+    fileColumnTypes_.append(columnTypes);
+    rowsCount_ += dataset.rowCount();
+    return true;
+}
+
+bool DatasetBatch::loadFile(int fileIndex, FileDataset& dataset)
+{
+    // Datasets released after analysis or previous load are analysed again.
+    if (dataset == nullptr && !isLoadingCancelled())
+        dataset = initializeFile(filePaths_[fileIndex]);
+    if (dataset == nullptr || !dataset->isValid())
+        return false;
+
+    const int fileColumnCount{getFileColumnCount()};
+    QVector<bool> activeColumns{activeColumns_.mid(0, fileColumnCount)};
+    if (activeColumns.isEmpty())
+        activeColumns.fill(true, fileColumnCount);
+    dataset->setActiveColumns(activeColumns);
+
+    // Cancel requested before registration is forwarded here.
+    {
+        const std::lock_guard<std::mutex> lock(loadingFilesMutex_);
+        loadingFiles_.append(dataset.get());
+    }
+    if (isLoadingCancelled())
+        dataset->cancelLoading();
+    const bool loaded{dataset->loadData()};
+    {
+        const std::lock_guard<std::mutex> lock(loadingFilesMutex_);
+        loadingFiles_.removeOne(dataset.get());
+    }
+
+    if (!loaded)
+    {
+        LOG(LogTypes::IMPORT_EXPORT, "Loading of " + filePaths_[fileIndex] +
+                                         " failed: " +
+                                         dataset->getLastError());
+        return false;
+    }
+    return true;
+}
+
+void DatasetBatch::appendFileData(int fileIndex, Dataset& dataset,
+                                  QVector<QVector<QVariant>>& data,
+                                  QHash<QString, int>& stringIndexes)
+{
+    // Loaded dataset has active columns only.
+    QVector<Column> fileColumns;
+    for (Column column = 0; column < getFileColumnCount(); ++column)
+        if (isColumnActive(column))
+            fileColumns.append(column);
+    const bool appendSourceFile{sourceFileColumn_ &&
+                                isColumnActive(getFileColumnCount())};
+    const QVector<ColumnType>& fileTypes{fileColumnTypes_[fileIndex]};
+
+    auto internString{[&](const QString& string) {
+        auto it{stringIndexes.constFind(string)};
+        if (it == stringIndexes.constEnd())
+        {
+            it = stringIndexes.insert(string, sharedStrings_.size());
+            sharedStrings_.append(string);
+        }
+        return it.value();
+    }};
+
+    // Strings of file are shared, so their addresses identify them.
+    QHash<const QVariant*, int> fileStringIndexes;
+    auto getStringIndex{[&](const QVariant* value) {
+        auto it{fileStringIndexes.constFind(value)};
+        if (it == fileStringIndexes.constEnd())
+            it = fileStringIndexes.insert(value,
+                                          internString(value->toString()));
+        return it.value();
+    }};
+
+    const int rows{static_cast<int>(dataset.rowCount())};
+    const int width{fileColumns.size() + (appendSourceFile ? 1 : 0)};
+    const int sourceFileIndex{
+        appendSourceFile ? internString(getSourceFileName(fileIndex)) : 0};
+    for (int row = 0; row < rows; ++row)
+    {
+        QVector<QVariant> dataRow(width);
+        for (int dataColumn = 0; dataColumn < fileColumns.size();
+             ++dataColumn)
+        {
+            const QVariant* value{dataset.getData(row, dataColumn)};
+            if (value->isNull())
+                continue;
+            const Column column{fileColumns[dataColumn]};
+            if (columnTypes_[column] != ColumnType::STRING)
+                dataRow[dataColumn] = *value;
+            else if (fileTypes[column] == ColumnType::STRING)
+                dataRow[dataColumn] = getStringIndex(value);
+            else
+                dataRow[dataColumn] = internString(
+                    widenValue(*value, fileTypes[column]).toString());
+        }
+        if (appendSourceFile)
+            dataRow[width - 1] = sourceFileIndex;
+        data.append(dataRow);
+    }
+}
+
+int DatasetBatch::getFileColumnCount() const
+{
+    return static_cast<int>(columnCount()) - (sourceFileColumn_ ? 1 : 0);
+}
+
+QString DatasetBatch::getSourceFileName(int fileIndex) const
+{
+    return QFileInfo(filePaths_[fileIndex]).fileName();
+}
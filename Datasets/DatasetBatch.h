@@ -0,0 +1,94 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QHash>
+#include <QStringList>
+
+#include "Dataset.h"
+
+class QFileInfo;
+
+/**
+ * @class DatasetBatch
+ * @brief Dataset being union of files having same columns.
+ *
+ * Files are analysed and loaded concurrently, at most one file per core at
+ * once. Rows are concatenated in order of files and strings of all files
+ * are merged into shared strings of batch. Columns having different types
+ * in files become string columns.
+ */
+class DatasetBatch : public Dataset
+{
+    Q_OBJECT
+public:
+    DatasetBatch(const QString& name, const QStringList& filePaths,
+                 QObject* parent = nullptr);
+
+    ~DatasetBatch() override;
+
+    /**
+     * @brief Add column with name of file from which each row comes.
+     * Need to be called before initialization.
+     * @param sourceFileColumn Flag indicating column should be added.
+     */
+    void setSourceFileColumn(bool sourceFileColumn);
+
+    /**
+     * @brief Create dataset for file basing on its extension.
+     * @param fileInfo File to import.
+     * @param name Name of created dataset.
+     * @return Dataset or nullptr when file type is not supported.
+     */
+    static std::unique_ptr<Dataset> createFileDataset(
+        const QFileInfo& fileInfo, const QString& name);
+
+    /**
+     * @brief Request stop of ongoing load, files being loaded are cancelled
+     * too. Safe to call from other threads.
+     */
+    void cancelLoading() override;
+
+protected:
+    bool analyze() override;
+
+    std::tuple<bool, QVector<QVector<QVariant>>> getSample() override;
+
+    std::tuple<bool, QVector<QVector<QVariant>>> getAllData() override;
+
+    void closeZip() override;
+
+private:
+    using FileDataset = std::unique_ptr<Dataset>;
+
+    FileDataset initializeFile(const QString& filePath) const;
+
+    bool addFileDefinition(int fileIndex, const Dataset& dataset);
+
+    bool loadFile(int fileIndex, FileDataset& dataset);
+
+    void appendFileData(int fileIndex, Dataset& dataset,
+                        QVector<QVector<QVariant>>& data,
+                        QHash<QString, int>& stringIndexes);
+
+    int getFileColumnCount() const;
+
+    QString getSourceFileName(int fileIndex) const;
+
+    const QStringList filePaths_;
+
+    bool sourceFileColumn_{false};
+
+    /// Datasets of files. Released once definition is read and after load.
+    std::vector<FileDataset> files_;
+
+    /// Datasets of files being loaded, guarded by mutex.
+    QVector<Dataset*> loadingFiles_;
+
+    std::mutex loadingFilesMutex_;
+
+    /// Types of columns in each of files.
+    QVector<QVector<ColumnType>> fileColumnTypes_;
+};
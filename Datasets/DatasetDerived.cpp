@@ -0,0 +1,28 @@
+#include "DatasetDerived.h"
+
+DatasetDerived::DatasetDerived(const QString& name,
+                               const Dataset& parentDataset,
+                               const QVector<int>& rows, QObject* parent)
+    : Dataset(name, parent)
+{
+    shareRowsOf(parentDataset, rows);
+    activeColumns_.fill(true, static_cast<int>(columnCount()));
+    valid_ = true;
+}
+
+bool DatasetDerived::analyze() { return valid_; }
+
+std::tuple<bool, QVector<QVector<QVariant>>> DatasetDerived::getSample()
+{
+    QVector<QVector<QVariant>> sample{
+        data_.mid(0, static_cast<int>(SAMPLE_SIZE))};
+    updateSampleDataStrings(sample);
+    return {true, sample};
+}
+
+std::tuple<bool, QVector<QVector<QVariant>>> DatasetDerived::getAllData()
+{
+    return {true, data_};
+}
+
+void DatasetDerived::closeZip() {}
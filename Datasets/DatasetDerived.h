@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Dataset.h"
+
+/**
+ * @class DatasetDerived
+ * @brief Dataset of chosen rows of other loaded dataset.
+ *
+ * Rows are not copied, references to rows of parent dataset are kept. Data
+ * is materialized only when dataset is saved.
+ */
+class DatasetDerived : public Dataset
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Create dataset, it is loaded once created.
+     * @param name Dataset name.
+     * @param parentDataset Loaded dataset rows are taken from.
+     * @param rows Rows of parent dataset to take.
+     * @param parent Parent object.
+     */
+    DatasetDerived(const QString& name, const Dataset& parentDataset,
+                   const QVector<int>& rows, QObject* parent = nullptr);
+
+    ~DatasetDerived() override = default;
+
+protected:
+    bool analyze() override;
+
+    std::tuple<bool, QVector<QVector<QVariant>>> getSample() override;
+
+    std::tuple<bool, QVector<QVector<QVariant>>> getAllData() override;
+
+    void closeZip() override;
+};
@@ -0,0 +1,556 @@
+#include "DatasetDsv.h"
+
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <QDate>
+
+#include <Logger.h>
+
+namespace
+{
+const QStringList& getDateFormats()
+{
+    static const QStringList dateFormats{
+        QStringLiteral("yyyy-MM-dd"), QStringLiteral("dd.MM.yyyy"),
+        QStringLiteral("dd/MM/yyyy"), QStringLiteral("MM/dd/yyyy"),
+        QStringLiteral("yyyy/MM/dd"), QStringLiteral("dd-MM-yyyy"),
+        QStringLiteral("yyyy.MM.dd")};
+    return dateFormats;
+}
+}  // namespace
+
+DatasetDsv::DatasetDsv(const QString& name, const QString& filePath,
+                       QObject* parent)
+    : Dataset(name, parent), file_(filePath)
+{
+}
+
+void DatasetDsv::setFollowing(bool following) { following_ = following; }
+
+bool DatasetDsv::isFollowable() const
+{
+    return following_ && isValid() && !query_.hasPredicates() &&
+           !query_.isPartial();
+}
+
+void DatasetDsv::setChunkSize(qint64 chunkSize) { chunkSize_ = chunkSize; }
+
+QVector<QVector<QVariant>> DatasetDsv::readAppendedRows()
+{
+    if (!following_)
+        return {};
+
+    QFile file(file_.fileName());
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    if (file.size() < followedOffset_)
+    {
+        LOG(LogTypes::IMPORT_EXPORT,
+            "File " + file.fileName() + " truncated, following from start.");
+        followedOffset_ = dataStart_;
+    }
+    if (file.size() == followedOffset_ || !file.seek(followedOffset_))
+        return {};
+
+    // Incomplete last record is read again next time.
+    const QByteArray appended{file.readAll()};
+    const char* begin{appended.constData()};
+    const char* end{parser_.findLastRecordEnd(begin, begin + appended.size())};
+
+    // Columns of loaded rows can not be widened, following stops instead.
+    QVector<QVector<QVariant>> rows;
+    QVector<QByteArray> fields;
+    bool mismatched{false};
+    const char* position{begin};
+    while (position < end)
+    {
+        const char* recordEnd{parser_.parseRecord(position, end, fields)};
+        if (fields.isEmpty())
+        {
+            position = recordEnd;
+            continue;
+        }
+
+        QVector<QVariant> row(followedColumns_.size());
+        for (int dataColumn = 0; dataColumn < followedColumns_.size();
+             ++dataColumn)
+        {
+            const Column column{followedColumns_[dataColumn]};
+            if (column >= fields.size() || fields[column].isEmpty())
+                continue;
+
+            if (followedTypes_[dataColumn] == ColumnType::STRING)
+            {
+                row[dataColumn] = QString::fromUtf8(fields[column]);
+                continue;
+            }
+            bool mismatchedValue{false};
+            row[dataColumn] =
+                convert(fields[column], followedTypes_[dataColumn],
+                        followedDateFormats_[dataColumn], mismatchedValue);
+            mismatched = mismatched || mismatchedValue;
+        }
+        if (mismatched)
+            break;
+        rows.append(row);
+        position = recordEnd;
+    }
+    followedOffset_ += position - begin;
+
+    if (mismatched)
+    {
+        following_ = false;
+        error_ = QObject::tr("Following of file ") + file.fileName() +
+                 QObject::tr(" stopped, appended value does not match type "
+                             "of column.");
+        LOG(LogTypes::IMPORT_EXPORT, error_);
+    }
+    return rows;
+}
+
+bool DatasetDsv::analyze()
+{
+    if (!mapFile())
+    {
+        error_ = QObject::tr("Can not open file ") + file_.fileName();
+        LOG(LogTypes::IMPORT_EXPORT, error_);
+        return false;
+    }
+
+    if (!readHeader())
+    {
+        error_ = QObject::tr("File ") + file_.fileName() +
+                 QObject::tr(" has no header.");
+        LOG(LogTypes::IMPORT_EXPORT, error_);
+        return false;
+    }
+
+    detectColumnTypes();
+    findChunks();
+    valid_ = true;
+
+    LOG(LogTypes::IMPORT_EXPORT,
+        "Separator '" + QString(parser_.getSeparator()) + "', " +
+            QString::number(chunkStarts_.size()) + " chunks.");
+    return true;
+}
+
+std::tuple<bool, QVector<QVector<QVariant>>> DatasetDsv::getSample()
+{
+    QVector<QVector<QVariant>> data;
+    QVector<QByteArray> fields;
+    const char* position{mapped_ + dataStart_};
+    const char* end{mapped_ + size_};
+    bool mismatched{false};
+    while (position < end && data.size() < static_cast<int>(SAMPLE_SIZE))
+    {
+        position = parser_.parseRecord(position, end, fields);
+        if (fields.isEmpty())
+            continue;
+
+        QVector<QVariant> row(static_cast<int>(columnCount()));
+        for (Column column = 0; column < std::min(row.size(), fields.size());
+             ++column)
+        {
+            if (fields[column].isEmpty())
+                continue;
+            row[column] = (columnTypes_[column] == ColumnType::STRING
+                               ? QVariant(QString::fromUtf8(fields[column]))
+                               : convert(fields[column], columnTypes_[column],
+                                         dateFormats_[column], mismatched));
+        }
+        data.append(row);
+    }
+    return {true, data};
+}
+
+std::tuple<bool, QVector<QVector<QVariant>>> DatasetDsv::getAllData()
+{
+    if (!isValid() || !mapFile())
+        return {false, {}};
+
+    // Types were guessed from beginning of file, mismatching columns are
+    // widened and file is parsed again.
+    auto [parsed, data, mismatchedColumns]{parseChunks()};
+    while (parsed && !mismatchedColumns.isEmpty())
+    {
+        data.clear();
+        widenToString(mismatchedColumns);
+        std::tie(parsed, data, mismatchedColumns) = parseChunks();
+    }
+    if (!parsed)
+        return {false, {}};
+
+    if (data.size() != static_cast<int>(rowCount()))
+    {
+        LOG(LogTypes::IMPORT_EXPORT,
+            "Expected " + QString::number(rowCount()) + " rows, parsed " +
+                QString::number(data.size()) + ".");
+        rowsCount_ = static_cast<unsigned int>(data.size());
+    }
+    if (following_)
+        setFollowedColumns();
+    setLoadingPercent(100);
+
+    return {true, data};
+}
+
+std::tuple<bool, QVector<QVector<QVariant>>, QVector<Column>>
+DatasetDsv::parseChunks()
+{
+    // Chunks are merged in order, up to one chunk per core parsed at once.
+    const std::size_t maxPendingChunks{
+        std::max(1U, std::thread::hardware_concurrency())};
+    std::deque<std::future<ParsedChunk>> pendingChunks;
+    QVector<QVector<QVariant>> data;
+    data.reserve(static_cast<int>(rowCount()));
+    QHash<QByteArray, int> stringIndexes;
+    sharedStrings_.clear();
+    QVector<bool> mismatchedColumns(static_cast<int>(columnCount()), false);
+    int mergedChunks{0};
+    auto mergeOldestChunk{[&]() {
+        ParsedChunk chunk{pendingChunks.front().get()};
+        pendingChunks.pop_front();
+        for (Column column = 0; column < mismatchedColumns.size(); ++column)
+            mismatchedColumns[column] = mismatchedColumns[column] ||
+                                        chunk.mismatchedColumns_[column];
+        appendChunk(chunk, data, stringIndexes);
+        setLoadingPercent(static_cast<unsigned int>(
+            100 * ++mergedChunks / chunkStarts_.size()));
+    }};
+
+    for (int chunk = 0; chunk < chunkStarts_.size(); ++chunk)
+    {
+        if (isLoadingCancelled())
+            break;
+        if (pendingChunks.size() >= maxPendingChunks)
+            mergeOldestChunk();
+        const qint64 chunkEnd{chunk + 1 < chunkStarts_.size()
+                                  ? chunkStarts_[chunk + 1]
+                                  : dataEnd_};
+        pendingChunks.push_back(std::async(std::launch::async,
+                                           &DatasetDsv::parseChunk, this,
+                                           chunkStarts_[chunk], chunkEnd));
+    }
+    while (!pendingChunks.empty())
+        mergeOldestChunk();
+
+    if (isLoadingCancelled())
+        return {false, {}, {}};
+
+    QVector<Column> columns;
+    for (Column column = 0; column < mismatchedColumns.size(); ++column)
+        if (mismatchedColumns[column])
+            columns.append(column);
+    return {true, data, columns};
+}
+
+void DatasetDsv::widenToString(const QVector<Column>& columns)
+{
+    for (const Column column : columns)
+    {
+        LOG(LogTypes::IMPORT_EXPORT,
+            "Column " + headerColumnNames_[column] +
+                " has values not matching guessed type, loaded as strings.");
+        columnTypes_[column] = ColumnType::STRING;
+        dateFormats_[column].clear();
+    }
+}
+
+void DatasetDsv::closeZip()
+{
+    if (mapped_ != nullptr)
+        file_.unmap(reinterpret_cast<uchar*>(const_cast<char*>(mapped_)));
+    mapped_ = nullptr;
+    file_.close();
+}
+
+void DatasetDsv::setFollowedColumns()
+{
+    // Definition gets rebuilt using active columns after load.
+    followedColumns_.clear();
+    followedTypes_.clear();
+    followedDateFormats_.clear();
+    for (Column column = 0; column < static_cast<Column>(columnCount());
+         ++column)
+    {
+        if (!isColumnActive(column))
+            continue;
+        followedColumns_.append(column);
+        followedTypes_.append(columnTypes_[column]);
+        followedDateFormats_.append(dateFormats_[column]);
+    }
+    followedOffset_ = dataEnd_;
+}
+
+bool DatasetDsv::mapFile()
+{
+    if (mapped_ != nullptr)
+        return true;
+
+    if (!file_.open(QIODevice::ReadOnly))
+        return false;
+
+    size_ = file_.size();
+    uchar* mapped{size_ > 0 ? file_.map(0, size_) : nullptr};
+    if (mapped == nullptr)
+    {
+        file_.close();
+        return false;
+    }
+    mapped_ = reinterpret_cast<const char*>(mapped);
+    return true;
+}
+
+bool DatasetDsv::readHeader()
+{
+    const QByteArray byteOrderMark{"\xEF\xBB\xBF"};
+    const char* begin{mapped_};
+    const char* end{mapped_ + size_};
+    if (QByteArray::fromRawData(mapped_, static_cast<int>(std::min(
+                                           size_, qint64(3))))
+            .startsWith(byteOrderMark))
+        begin += byteOrderMark.size();
+
+    parser_ = DsvParser::sniff(
+        begin, begin + std::min(static_cast<qint64>(end - begin), SNIFF_SIZE));
+
+    QVector<QByteArray> fields;
+    const char* position{begin};
+    while (position < end && fields.isEmpty())
+        position = parser_.parseRecord(position, end, fields);
+    if (fields.isEmpty())
+        return false;
+
+    dataStart_ = position - mapped_;
+    headerColumnNames_.clear();
+    for (const QByteArray& field : fields)
+    {
+        const QString name{QString::fromUtf8(field).trimmed()};
+        headerColumnNames_.append(name.isEmpty() ? QObject::tr("no name")
+                                                 : name);
+    }
+    columnsCount_ = static_cast<unsigned int>(fields.size());
+    return true;
+}
+
+void DatasetDsv::detectColumnTypes()
+{
+    QVector<QVector<QByteArray>> sampleRows;
+    QVector<QByteArray> fields;
+    const char* position{mapped_ + dataStart_};
+    const char* end{mapped_ + size_};
+    while (position < end && sampleRows.size() < SNIFFED_ROWS)
+    {
+        position = parser_.parseRecord(position, end, fields);
+        if (!fields.isEmpty())
+            sampleRows.append(fields);
+    }
+
+    // Number if all values are numbers, date if all match one date format.
+    columnTypes_.fill(ColumnType::STRING, static_cast<int>(columnCount()));
+    dateFormats_.fill(QString(), static_cast<int>(columnCount()));
+    for (Column column = 0; column < static_cast<Column>(columnCount());
+         ++column)
+    {
+        bool valuesFound{false};
+        bool numbers{true};
+        QStringList dateFormats{getDateFormats()};
+        for (const auto& row : sampleRows)
+        {
+            if (column >= row.size() || row[column].isEmpty())
+                continue;
+
+            valuesFound = true;
+            if (numbers)
+                row[column].toDouble(&numbers);
+            const QString value{QString::fromUtf8(row[column])};
+            dateFormats.erase(
+                std::remove_if(dateFormats.begin(), dateFormats.end(),
+                               [&value](const QString& format) {
+                                   return !QDate::fromString(value, format)
+                                               .isValid();
+                               }),
+                dateFormats.end());
+            if (!numbers && dateFormats.isEmpty())
+                break;
+        }
+
+        if (!valuesFound)
+            continue;
+        if (numbers)
+            columnTypes_[column] = ColumnType::NUMBER;
+        else if (!dateFormats.isEmpty())
+        {
+            columnTypes_[column] = ColumnType::DATE;
+            dateFormats_[column] = dateFormats.constFirst();
+        }
+    }
+}
+
+void DatasetDsv::findChunks()
+{
+    // Parts of file are scanned in parallel from each possible state. State
+    // at beginning of each part is known after preceding parts.
+    const qint64 dataSize{size_ - dataStart_};
+    const int partsCount{static_cast<int>((dataSize + chunkSize_ - 1) /
+                                          chunkSize_)};
+    std::vector<DsvParser::Scan> scans(static_cast<std::size_t>(partsCount));
+    const int threadsCount{std::max(
+        1, std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                    partsCount))};
+    std::vector<std::future<void>> scanners;
+    for (int thread = 0; thread < threadsCount; ++thread)
+        scanners.push_back(std::async(std::launch::async, [&, thread]() {
+            for (int part = thread; part < partsCount; part += threadsCount)
+            {
+                const qint64 partBegin{dataStart_ + part * chunkSize_};
+                const qint64 partEnd{std::min(size_, partBegin + chunkSize_)};
+                scans[static_cast<std::size_t>(part)] = parser_.scan(
+                    mapped_, mapped_ + partBegin, mapped_ + partEnd);
+            }
+        }));
+    for (auto& scanner : scanners)
+        scanner.wait();
+
+    chunkStarts_ = {dataStart_};
+    qint64 records{0};
+    DsvParser::State state{DsvParser::FIELD_START};
+    for (const auto& scan : scans)
+    {
+        const qint64 recordEnd{scan.firstRecordEnd_[state]};
+        if (&scan != &scans.front() && recordEnd != -1 && recordEnd < size_)
+            chunkStarts_.append(recordEnd);
+        records += scan.records_[state];
+        state = scan.endState_[state];
+    }
+
+    // Last record does not need to end with line break. When file is
+    // followed, such record is probably still written and is read later.
+    dataEnd_ = size_;
+    if (dataSize > 0 && mapped_[size_ - 1] != '\n')
+    {
+        if (following_)
+            dataEnd_ = parser_.findLastRecordEnd(
+                           mapped_ + chunkStarts_.constLast(),
+                           mapped_ + size_) -
+                       mapped_;
+        else
+            ++records;
+    }
+    rowsCount_ = static_cast<unsigned int>(records);
+}
+
+QVariant DatasetDsv::convert(const QByteArray& field, ColumnType columnType,
+                             const QString& dateFormat, bool& mismatched)
+{
+    bool converted{true};
+    QVariant value;
+    if (columnType == ColumnType::NUMBER)
+        value = field.toDouble(&converted);
+    else if (columnType == ColumnType::DATE)
+    {
+        const QDate date{
+            QDate::fromString(QString::fromUtf8(field), dateFormat)};
+        converted = date.isValid();
+        value = date;
+    }
+
+    mismatched = !converted;
+    return converted ? value : QVariant();
+}
+
+DatasetDsv::ParsedChunk DatasetDsv::parseChunk(qint64 begin, qint64 end) const
+{
+    ParsedChunk chunk;
+    chunk.mismatchedColumns_.fill(false, static_cast<int>(columnCount()));
+    QHash<QByteArray, int> stringIndexes;
+    QVector<QByteArray> fields;
+    const int activeColumnsCount{activeColumns_.count(true)};
+    const char* position{mapped_ + begin};
+    const char* chunkEnd{mapped_ + end};
+    while (position < chunkEnd)
+    {
+        position = parser_.parseRecord(position, chunkEnd, fields);
+        if (fields.isEmpty())
+            continue;
+
+        QVector<QVariant> row(activeColumnsCount);
+        int dataColumn{0};
+        for (Column column = 0; column < static_cast<Column>(columnCount());
+             ++column)
+        {
+            if (!activeColumns_.at(column))
+                continue;
+
+            const int currentColumn{dataColumn++};
+            if (column >= fields.size() || fields[column].isEmpty())
+                continue;
+
+            const QByteArray& field{fields[column]};
+            if (columnTypes_[column] != ColumnType::STRING)
+            {
+                bool mismatched{false};
+                row[currentColumn] =
+                    convert(field, columnTypes_[column], dateFormats_[column],
+                            mismatched);
+                if (mismatched)
+                    chunk.mismatchedColumns_[column] = true;
+                continue;
+            }
+
+            // Fields may refer to mapped file, so keys are deep copies.
+            auto it{stringIndexes.constFind(field)};
+            if (it == stringIndexes.constEnd())
+            {
+                const QByteArray string(field.constData(), field.size());
+                it = stringIndexes.insert(string, chunk.strings_.size());
+                chunk.strings_.append(string);
+            }
+            row[currentColumn] = it.value();
+        }
+        chunk.rows_.append(row);
+    }
+    return chunk;
+}
+
+void DatasetDsv::appendChunk(ParsedChunk& chunk,
+                             QVector<QVector<QVariant>>& data,
+                             QHash<QByteArray, int>& stringIndexes)
+{
+    QVector<int> sharedIndexes;
+    sharedIndexes.reserve(chunk.strings_.size());
+    for (const QByteArray& string : chunk.strings_)
+    {
+        auto it{stringIndexes.constFind(string)};
+        if (it == stringIndexes.constEnd())
+        {
+            it = stringIndexes.insert(string, sharedStrings_.size());
+            sharedStrings_.append(QString::fromUtf8(string));
+        }
+        sharedIndexes.append(it.value());
+    }
+
+    QVector<int> stringColumns;
+    int dataColumn{0};
+    for (Column column = 0; column < static_cast<Column>(columnCount());
+         ++column)
+    {
+        if (!activeColumns_.at(column))
+            continue;
+        if (columnTypes_[column] == ColumnType::STRING)
+            stringColumns.append(dataColumn);
+        ++dataColumn;
+    }
+
+    for (auto& row : chunk.rows_)
+        for (const int column : stringColumns)
+            if (!row[column].isNull())
+                row[column] = sharedIndexes[row[column].toInt()];
+    data += chunk.rows_;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <QFile>
+#include <QHash>
+
+#include "Dataset.h"
+#include "DsvParser.h"
+
+/**
+ * @class DatasetDsv
+ * @brief Dataset class for delimiter separated values files like .csv.
+ *
+ * File is memory mapped. Separator, quote, column types and date formats
+ * are guessed from beginning of file. Whole file is split into chunks at
+ * record ends found with respect to quoting and chunks are parsed in
+ * parallel. Columns having values not matching type guessed from beginning
+ * of file are widened to strings and parsed again. Following of file stops
+ * when appended value does not match type of column.
+ */
+class DatasetDsv : public Dataset
+{
+    Q_OBJECT
+public:
+    DatasetDsv(const QString& name, const QString& filePath,
+               QObject* parent = nullptr);
+
+    ~DatasetDsv() override = default;
+
+    /**
+     * @brief Keep reading rows appended to file after load. Need to be
+     * called before load.
+     * @param following Flag indicating file should be followed.
+     */
+    void setFollowing(bool following);
+
+    bool isFollowable() const override;
+
+    /**
+     * @brief Set approximate size of chunk parsed on separate thread. Need
+     * to be called before initialization.
+     * @param chunkSize Size in bytes.
+     */
+    void setChunkSize(qint64 chunkSize);
+
+    QVector<QVector<QVariant>> readAppendedRows() override;
+
+protected:
+    bool analyze() override;
+
+    std::tuple<bool, QVector<QVector<QVariant>>> getSample() override;
+
+    std::tuple<bool, QVector<QVector<QVariant>>> getAllData() override;
+
+    void closeZip() override;
+
+private:
+    /**
+     * @brief Rows parsed from chunk. Strings are indexes of chunk strings.
+     */
+    struct ParsedChunk
+    {
+        QVector<QVector<QVariant>> rows_{};
+        QVector<QByteArray> strings_{};
+
+        /// Flags of columns having values not matching column type.
+        QVector<bool> mismatchedColumns_{};
+    };
+
+    bool mapFile();
+
+    bool readHeader();
+
+    void detectColumnTypes();
+
+    void findChunks();
+
+    static QVariant convert(const QByteArray& field, ColumnType columnType,
+                            const QString& dateFormat, bool& mismatched);
+
+    void setFollowedColumns();
+
+    ParsedChunk parseChunk(qint64 begin, qint64 end) const;
+
+    /**
+     * @brief Parse all chunks in parallel.
+     * @return Flag indicating success, parsed rows and columns having values
+     * not matching column type.
+     */
+    std::tuple<bool, QVector<QVector<QVariant>>, QVector<Column>>
+    parseChunks();
+
+    void widenToString(const QVector<Column>& columns);
+
+    void appendChunk(ParsedChunk& chunk, QVector<QVector<QVariant>>& data,
+                     QHash<QByteArray, int>& stringIndexes);
+
+    QFile file_;
+
+    const char* mapped_{nullptr};
+
+    qint64 size_{0};
+
+    DsvParser parser_{',', '"'};
+
+    /// Offset of first record after header.
+    qint64 dataStart_{0};
+
+    /// Offset after last record loaded.
+    qint64 dataEnd_{0};
+
+    /// Offsets of chunks parsed in parallel, each starting new record.
+    QVector<qint64> chunkStarts_;
+
+    /// Formats of date columns, empty for other columns.
+    QVector<QString> dateFormats_;
+
+    bool following_{false};
+
+    /// Offset in file after last record read.
+    qint64 followedOffset_{0};
+
+    /// Loaded columns of file with their types and date formats.
+    QVector<Column> followedColumns_;
+    QVector<ColumnType> followedTypes_;
+    QVector<QString> followedDateFormats_;
+
+    /// Beginning of file used to guess format and column types.
+    static constexpr qint64 SNIFF_SIZE{1024 * 1024};
+
+    /// Number of records used to guess column types.
+    static constexpr int SNIFFED_ROWS{1000};
+
+    /// Approximate size of chunk parsed on separate thread.
+    static constexpr qint64 CHUNK_SIZE{8 * 1024 * 1024};
+
+    qint64 chunkSize_{CHUNK_SIZE};
+};
@@ -1,13 +1,18 @@
 #include "DatasetInner.h"
 
 #include <Qt5Quazip/quazipfile.h>
-#include <QCoreApplication>
+#include <QDateTime>
 #include <QDir>
 #include <QDomDocument>
-#include <QTextStream>
+#include <QFileInfo>
 
+#include <cstring>
+
+#include <CompressionUtilities.h>
+#include <Constants.h>
 #include <DatasetUtilities.h>
 #include <Logger.h>
+#include <MemoryUtilities.h>
 
 DatasetInner::DatasetInner(const QString& name, QObject* parent)
     : Dataset(name, parent), datasetsDir_(DatasetUtilities::getDatasetsDir())
@@ -16,22 +21,54 @@ DatasetInner::DatasetInner(const QString& name, QObject* parent)
                     DatasetUtilities::getDatasetExtension());
 }
 
+DatasetInner::DatasetInner(const QString& name, const QString& filePath,
+                           QObject* parent)
+    : Dataset(name, parent),
+      datasetsDir_(QFileInfo(filePath).absolutePath() + "/")
+{
+    zip_.setZipName(filePath);
+}
+
 bool DatasetInner::analyze()
 {
     if (!openZip())
         return false;
 
     QByteArray definitionContent;
-    if (!loadXmlFile(definitionContent, zip_) || !fromXml(definitionContent) ||
-        !loadStrings(zip_))
+    // Strings are read when sample or data is loaded, data can be taken
+    // from other dataset instead.
+    if (!loadXmlFile(definitionContent, zip_) || !fromXml(definitionContent))
         return false;
 
     valid_ = true;
     return true;
 }
 
+QString DatasetInner::getSourceId() const
+{
+    const QFileInfo fileInfo(zip_.getZipName());
+    if (!fileInfo.exists())
+        return {};
+    return fileInfo.absoluteFilePath() + "@" +
+           fileInfo.lastModified().toString(Qt::ISODateWithMs);
+}
+
+quint64 DatasetInner::getUsedMemory() const
+{
+    return Dataset::getUsedMemory() +
+           static_cast<quint64>(stringsArena_.capacity()) +
+           MemoryUtilities::getVectorMemory(stringsOffsets_);
+}
+
 void DatasetInner::closeZip() { zip_.close(); }
 
+void DatasetInner::releaseLoadingBuffers()
+{
+    stringsArena_.clear();
+    stringsOffsets_.clear();
+    stringsOffsets_.squeeze();
+}
+
 bool DatasetInner::openZip()
 {
     if (!zip_.open(QuaZip::mdUnzip))
@@ -45,20 +82,31 @@ bool DatasetInner::openZip()
 std::tuple<bool, QVector<QVector<QVariant>>> DatasetInner::getSample()
 {
     auto [success, data] = fillData(zip_, true);
-    if (!success)
+    if (!success || !loadStrings(zip_, getLastSampleStringIndex(data)))
         return {false, {}};
 
+    decodeReferencedStrings(data, true);
     updateSampleDataStrings(data);
     return {true, data};
 }
 
 std::tuple<bool, QVector<QVector<QVariant>>> DatasetInner::getAllData()
 {
-    if (!isValid())
+    if (!isValid() || !loadStrings(zip_))
         return {false, {}};
 
     QVector<QVector<QVariant>> data;
-    std::tie(valid_, data) = fillData(zip_, false);
+    if (auto [groupsLoaded, groups] = loadRowGroups(zip_); groupsLoaded)
+        std::tie(valid_, data) = fillDataUsingRowGroups(zip_, groups);
+    else
+        std::tie(valid_, data) = fillData(zip_, false);
+    queryAppliedWhileLoading_ = true;
+    decodeReferencedStrings(data, false);
+    if (valid_ && !query_.hasPredicates() && !query_.isPartial())
+        loadIndexes(zip_);
+
+    // All needed strings are decoded, raw content is not used anymore.
+    releaseLoadingBuffers();
 
     return {true, data};
 }
@@ -140,23 +188,214 @@ bool DatasetInner::loadXmlFile(QByteArray& definitionContent, QuaZip& zip)
     return true;
 }
 
-bool DatasetInner::loadStrings(QuaZip& zip)
+bool DatasetInner::loadStrings(QuaZip& zip, int neededStrings)
 {
     QuaZipFile zipFile(&zip);
     zip.setCurrentFile(DatasetUtilities::getDatasetStringsFilename());
     if (!openQuaZipFile(zipFile))
         return false;
 
-    QList<QByteArray> strings{zipFile.readAll().split('\n')};
+    // String with index n ends on n-th line.
+    if (neededStrings == ALL_STRINGS)
+        stringsArena_ = zipFile.readAll();
+    else
+    {
+        stringsArena_.clear();
+        int lines{0};
+        while (lines < neededStrings && !zipFile.atEnd())
+        {
+            const QByteArray part{zipFile.read(STRINGS_READ_SIZE)};
+            if (part.isEmpty())
+                break;
+            lines += part.count('\n');
+            stringsArena_.append(part);
+        }
+    }
+    stringsOffsets_.clear();
+    stringsOffsets_.reserve(stringsArena_.count('\n') + 2);
+    stringsOffsets_.append(0);
+    for (int position = stringsArena_.indexOf('\n'); position != -1;
+         position = stringsArena_.indexOf('\n', position + 1))
+        stringsOffsets_.append(position + 1);
+    stringsOffsets_.append(stringsArena_.size() + 1);
+
+    // First element need to be empty. Others are decoded when referenced.
+    sharedStrings_.clear();
+    sharedStrings_.resize(stringsOffsets_.size());
+    sharedStrings_[0] = QVariant(QString());
+
+    return true;
+}
+
+void DatasetInner::decodeReferencedStrings(
+    const QVector<QVector<QVariant>>& data, bool fillSamplesOnly)
+{
+    if (stringsOffsets_.isEmpty())
+        return;
+
+    int dataColumn{0};
+    for (Column column = 0; column < static_cast<int>(columnCount()); ++column)
+    {
+        if (!fillSamplesOnly && !activeColumns_[column])
+            continue;
+
+        if (getColumnFormat(column) == ColumnType::STRING)
+        {
+            for (const auto& row : data)
+            {
+                const int index{row[dataColumn].toInt()};
+                if (index > 0 && index < sharedStrings_.size() &&
+                    !sharedStrings_[index].isValid())
+                    sharedStrings_[index] = decodeString(index);
+            }
+        }
+        dataColumn++;
+    }
+}
+
+int DatasetInner::getLastSampleStringIndex(
+    const QVector<QVector<QVariant>>& sample) const
+{
+    // Sample contains all columns.
+    int lastIndex{0};
+    for (Column column = 0; column < static_cast<int>(columnCount()); ++column)
+        if (getColumnFormat(column) == ColumnType::STRING)
+            for (const auto& row : sample)
+                lastIndex = std::max(lastIndex, row[column].toInt());
+    return lastIndex;
+}
+
+QVariant DatasetInner::decodeString(int index) const
+{
+    const int begin{stringsOffsets_[index - 1]};
+    const int end{stringsOffsets_[index] - 1};
+    return QVariant(QString::fromUtf8(stringsArena_.constData() + begin,
+                                      end - begin));
+}
+
+void DatasetInner::loadIndexes(QuaZip& zip)
+{
+    columnIndexes_.clear();
+    QuaZipFileInfo dataFileInfo;
+    if (!zip.setCurrentFile(DatasetUtilities::getDatasetDataFilename()) ||
+        !zip.getCurrentFileInfo(&dataFileInfo) ||
+        !zip.setCurrentFile(DatasetUtilities::getDatasetIndexFilename()))
+        return;
+
+    QuaZipFile zipFile(&zip);
+    if (!openQuaZipFile(zipFile))
+        return;
+
+    auto [valid, indexes] = DatasetIndex::fromByteArray(
+        zipFile.readAll(), dataFileInfo.crc, rowCount(), columnCount());
+    if (!valid)
+    {
+        LOG(LogTypes::IMPORT_EXPORT,
+            "Indexes do not match data, values will be recomputed.");
+        return;
+    }
+
+    for (Column column = 0; column < static_cast<int>(columnCount()); ++column)
+        if (activeColumns_[column])
+            columnIndexes_.append(indexes[column]);
+}
+
+std::tuple<bool, QVector<RowGroup>> DatasetInner::loadRowGroups(QuaZip& zip)
+{
+    QuaZipFileInfo dataFileInfo;
+    if ((query_.rangePredicates_.isEmpty() &&
+         query_.mode_ != LoadMode::ROW_RANGE) ||
+        !zip.setCurrentFile(DatasetUtilities::getDatasetDataFilename()) ||
+        !zip.getCurrentFileInfo(&dataFileInfo) ||
+        !zip.setCurrentFile(DatasetUtilities::getDatasetRowGroupsFilename()))
+        return {false, {}};
+
+    QuaZipFile zipFile(&zip);
+    if (!openQuaZipFile(zipFile))
+        return {false, {}};
+
+    auto [valid, groups] = DatasetIndex::rowGroupsFromByteArray(
+        zipFile.readAll(), dataFileInfo.crc, rowCount(), columnCount());
+    if (!valid)
+        LOG(LogTypes::IMPORT_EXPORT,
+            "Row groups do not match data, all rows will be parsed.");
+    return {valid, groups};
+}
 
-    // First element need to be empty.
-    sharedStrings_.append(QVariant(QString()));
-    for (const auto& currentString : strings)
-        sharedStrings_.append(QVariant(QString::fromUtf8(currentString)));
+bool DatasetInner::rowGroupMatchesPredicates(const RowGroup& group) const
+{
+    if (group.firstRow_ + group.rowCount_ <= firstParsedRow_)
+        return false;
 
+    for (const auto& predicate : query_.rangePredicates_)
+        if (group.max_[predicate.column_] < predicate.min_ ||
+            group.min_[predicate.column_] > predicate.max_)
+            return false;
     return true;
 }
 
+std::tuple<bool, QVector<QVector<QVariant>>>
+DatasetInner::fillDataUsingRowGroups(QuaZip& zip,
+                                     const QVector<RowGroup>& groups)
+{
+    QuaZipFile zipFile(&zip);
+    zip.setCurrentFile(DatasetUtilities::getDatasetDataFilename());
+    int method{0};
+    int level{0};
+    if (!zipFile.open(QIODevice::ReadOnly, &method, &level, true))
+        return {false, {}};
+
+    prepareColumnConditions(false);
+    unsigned int lastEmittedPercent{0};
+    int skippedGroups{0};
+    QVector<QVector<QVariant>> data;
+    for (const auto& group : groups)
+    {
+        if (group.firstRow_ >= endParsedRow_ || isLoadingCancelled())
+            break;
+
+        // Groups are stored one after another, skipped ones are only read.
+        const QByteArray compressed{zipFile.read(group.compressedSize_)};
+        if (compressed.size() != group.compressedSize_)
+            return {false, {}};
+
+        updateProgress(group.firstRow_ + group.rowCount_ - 1, rowCount(),
+                       lastEmittedPercent);
+        if (!rowGroupMatchesPredicates(group))
+        {
+            skippedGroups++;
+            continue;
+        }
+
+        auto [inflated, content] = CompressionUtilities::inflateChunk(
+            compressed, group.uncompressedSize_);
+        if (!inflated)
+            return {false, {}};
+
+        const char* lineBegin{content.constData()};
+        const char* contentEnd{lineBegin + content.size()};
+        unsigned int lineNumber{group.firstRow_};
+        while (lineBegin < contentEnd)
+        {
+            const auto* lineEnd{static_cast<const char*>(
+                std::memchr(lineBegin, '\n',
+                            static_cast<size_t>(contentEnd - lineBegin)))};
+            if (lineEnd == nullptr)
+                lineEnd = contentEnd;
+            addLine(lineBegin, lineEnd, lineNumber++, data);
+            lineBegin = lineEnd + 1;
+        }
+    }
+    finishParsing(data);
+
+    LOG(LogTypes::IMPORT_EXPORT,
+        "Loaded " + QString::number(data.size()) + " rows, skipped " +
+            QString::number(skippedGroups) + " of " +
+            QString::number(groups.size()) + " row groups.");
+
+    return {true, data};
+}
+
 void DatasetInner::updateProgress(unsigned int currentRow,
                                   unsigned int rowCount,
                                   unsigned int& lastEmittedPercent)
@@ -165,14 +404,13 @@ void DatasetInner::updateProgress(unsigned int currentRow,
         static_cast<unsigned int>(100. * (currentRow + 1) / rowCount)};
     if (currentPercent > lastEmittedPercent)
     {
-        Q_EMIT loadingPercentChanged(currentPercent);
+        setLoadingPercent(currentPercent);
         lastEmittedPercent = currentPercent;
-        QCoreApplication::processEvents();
     }
 }
 
 QVariant DatasetInner::getElementAsVariant(ColumnType columnFormat,
-                                           const QString& element)
+                                           const QByteArray& element)
 {
     QVariant elementAsVariant;
     if (element.isEmpty())
@@ -222,40 +460,250 @@ QVariant DatasetInner::getDefaultVariantForFormat(const ColumnType format)
     return QVariant(QVariant::String);
 }
 
-QVector<QVariant> DatasetInner::fillRow(const QStringList& line,
-                                        bool fillSamplesOnly)
+void DatasetInner::prepareColumnConditions(bool fillSamplesOnly)
 {
-    QVector<QVariant> row;
+    parsingMode_ = (fillSamplesOnly ? LoadMode::ALL_ROWS : query_.mode_);
+    firstParsedRow_ =
+        (parsingMode_ == LoadMode::ROW_RANGE ? query_.firstRow_ : 0);
+    endParsedRow_ = rowCount();
+    if (fillSamplesOnly)
+        endParsedRow_ = std::min(SAMPLE_SIZE, rowCount());
+    if (parsingMode_ == LoadMode::ROW_RANGE)
+        endParsedRow_ = static_cast<unsigned int>(
+            std::min(static_cast<quint64>(rowCount()),
+                     quint64(query_.firstRow_) + query_.rowLimit_));
+    matchedRows_ = 0;
+    sampleSourceRows_.clear();
+    publishRows_ = (!fillSamplesOnly && isProgressiveLoading() &&
+                    parsingMode_ != LoadMode::RANDOM_SAMPLE);
+    publishedRows_ = 0;
+
+    columnConditions_.clear();
+    columnConditions_.resize(static_cast<int>(columnCount()));
+    rowSize_ = 0;
     for (Column column = 0; column < static_cast<int>(columnCount()); ++column)
     {
-        if (!fillSamplesOnly && !activeColumns_[column])
+        columnConditions_[column].active_ =
+            (fillSamplesOnly || activeColumns_[column]);
+        if (columnConditions_[column].active_)
+            rowSize_++;
+    }
+
+    if (!fillSamplesOnly)
+    {
+        for (const auto& predicate : query_.rangePredicates_)
+        {
+            ColumnCondition& condition{columnConditions_[predicate.column_]};
+            condition.min_ = (condition.ranged_
+                                  ? std::max(condition.min_, predicate.min_)
+                                  : predicate.min_);
+            condition.max_ = (condition.ranged_
+                                  ? std::min(condition.max_, predicate.max_)
+                                  : predicate.max_);
+            condition.ranged_ = true;
+        }
+
+        for (const auto& predicate : query_.stringPredicates_)
+        {
+            ColumnCondition& condition{columnConditions_[predicate.column_]};
+            const QSet<int> indexes{
+                findStringIndexes(predicate.acceptedStrings_)};
+            if (condition.stringsRestricted_)
+                condition.acceptedStrings_.intersect(indexes);
+            else
+                condition.acceptedStrings_ = indexes;
+            condition.stringsRestricted_ = true;
+        }
+    }
+
+    lastNeededColumn_ = Constants::NOT_SET_COLUMN;
+    for (Column column = 0; column < columnConditions_.size(); ++column)
+    {
+        const ColumnCondition& condition{columnConditions_[column]};
+        if (condition.active_ || condition.ranged_ ||
+            condition.stringsRestricted_)
+            lastNeededColumn_ = column;
+    }
+}
+
+QSet<int> DatasetInner::findStringIndexes(const QStringList& strings) const
+{
+    // Compare encoded strings with arena, nothing is decoded.
+    QSet<QByteArray> encodedStrings;
+    for (const QString& string : strings)
+        encodedStrings.insert(
+            QString(string).replace('\n', QLatin1String("\t")).toUtf8());
+
+    QSet<int> indexes;
+    if (strings.contains(QString()))
+        indexes.insert(0);
+    for (int index = 1; index < stringsOffsets_.size(); ++index)
+    {
+        const int begin{stringsOffsets_[index - 1]};
+        const int end{stringsOffsets_[index] - 1};
+        if (encodedStrings.contains(QByteArray::fromRawData(
+                stringsArena_.constData() + begin, end - begin)))
+            indexes.insert(index);
+    }
+    return indexes;
+}
+
+bool DatasetInner::matchesCondition(const ColumnCondition& condition,
+                                    ColumnType columnFormat,
+                                    const QByteArray& element)
+{
+    if (condition.ranged_)
+    {
+        // Empty dates never match, empty numbers are treated as zero.
+        if (element.isEmpty() && columnFormat == ColumnType::DATE)
+            return false;
+        const double value{element.toDouble()};
+        if (value < condition.min_ || value > condition.max_)
+            return false;
+    }
+
+    return !condition.stringsRestricted_ ||
+           condition.acceptedStrings_.contains(element.toInt());
+}
+
+bool DatasetInner::parseRow(const char* begin, const char* end,
+                            QVector<QVariant>& row) const
+{
+    if (end != begin && *(end - 1) == '\r')
+        --end;
+
+    const char* position{begin};
+    int rowColumn{0};
+    for (Column column = 0; column <= lastNeededColumn_; ++column)
+    {
+        const auto* fieldEnd{static_cast<const char*>(
+            std::memchr(position, ';', static_cast<size_t>(end - position)))};
+        if (fieldEnd == nullptr)
+            fieldEnd = end;
+
+        // Fields which are not needed are skipped without conversion.
+        const ColumnCondition& condition{columnConditions_[column]};
+        if (condition.active_ || condition.ranged_ ||
+            condition.stringsRestricted_)
+        {
+            const QByteArray element{QByteArray::fromRawData(
+                position, static_cast<int>(fieldEnd - position))};
+            const ColumnType columnFormat{getColumnFormat(column)};
+            if (!matchesCondition(condition, columnFormat, element))
+                return false;
+            if (condition.active_)
+                row[rowColumn++] = getElementAsVariant(columnFormat, element);
+        }
+        position = (fieldEnd == end ? end : fieldEnd + 1);
+    }
+    return true;
+}
+
+void DatasetInner::addLine(const char* begin, const char* end,
+                           unsigned int lineNumber,
+                           QVector<QVector<QVariant>>& data)
+{
+    if (lineNumber < firstParsedRow_ || lineNumber >= endParsedRow_)
+        return;
+
+    QVector<QVariant> row(rowSize_);
+    if (parsingMode_ != LoadMode::RANDOM_SAMPLE)
+    {
+        if (parseRow(begin, end, row))
+            data.append(row);
+        if (publishRows_)
+            publishLoadedRows(data);
+        return;
+    }
+
+    // Without predicates slot is drawn first, so skipped rows are not parsed.
+    int slot{NOT_SAMPLED};
+    if (query_.hasPredicates())
+    {
+        if (!parseRow(begin, end, row))
+            return;
+        slot = getReservoirSlot(matchedRows_++);
+    }
+    else
+    {
+        slot = getReservoirSlot(matchedRows_++);
+        if (slot != NOT_SAMPLED)
+            parseRow(begin, end, row);
+    }
+
+    if (slot == NOT_SAMPLED)
+        return;
+
+    if (slot == data.size())
+    {
+        data.append(row);
+        sampleSourceRows_.append(lineNumber);
+    }
+    else
+    {
+        data[slot] = row;
+        sampleSourceRows_[slot] = lineNumber;
+    }
+}
+
+void DatasetInner::publishLoadedRows(const QVector<QVector<QVariant>>& data)
+{
+    const int chunkSize{publishedRows_ == 0 ? FIRST_LOADED_CHUNK_SIZE
+                                            : LOADED_CHUNK_SIZE};
+    if (data.size() - publishedRows_ < chunkSize)
+        return;
+
+    // Strings are resolved here as shared strings are not ready until end.
+    QVector<QVector<QVariant>> rows{data.mid(publishedRows_)};
+    publishedRows_ = data.size();
+    int dataColumn{0};
+    for (Column column = 0; column < static_cast<int>(columnCount()); ++column)
+    {
+        if (!activeColumns_[column])
             continue;
 
-        const QString& element{line.at(column)};
-        row.append(getElementAsVariant(getColumnFormat(column), element));
+        if (getColumnFormat(column) == ColumnType::STRING)
+        {
+            for (auto& row : rows)
+            {
+                const int index{row[dataColumn].toInt()};
+                row[dataColumn] =
+                    (index > 0 ? decodeString(index) : QVariant(QString()));
+            }
+        }
+        dataColumn++;
     }
-    return row;
+    Q_EMIT rowsLoaded(rows);
 }
 
-QVector<QVector<QVariant>> DatasetInner::parseData(QTextStream& stream,
+void DatasetInner::finishParsing(QVector<QVector<QVariant>>& data)
+{
+    if (parsingMode_ == LoadMode::RANDOM_SAMPLE)
+        orderSample(data, sampleSourceRows_);
+}
+
+QVector<QVector<QVariant>> DatasetInner::parseData(QuaZipFile& zipFile,
                                                    bool fillSamplesOnly)
 {
     unsigned int lastEmittedPercent{0};
     unsigned int lineCounter{0};
-    QVector<QVector<QVariant>> data{fillSamplesOnly
-                                        ? prepareContainerForSampleData()
-                                        : prepareContainerForAllData()};
-    while (!stream.atEnd() && lineCounter < rowCount())
-    {
-        if (fillSamplesOnly && lineCounter >= SAMPLE_SIZE)
-            break;
+    QVector<QVector<QVariant>> data;
+    if (fillSamplesOnly || (!query_.hasPredicates() && !query_.isPartial()))
+        data.reserve(static_cast<int>(endParsedRow_));
 
-        QStringList line{stream.readLine().split(';')};
-        data[static_cast<int>(lineCounter)] = fillRow(line, fillSamplesOnly);
+    while (!zipFile.atEnd() && lineCounter < endParsedRow_ &&
+           !isLoadingCancelled())
+    {
+        const QByteArray line{zipFile.readLine()};
+        const int lineLength{line.endsWith('\n') ? line.size() - 1
+                                                 : line.size()};
+        addLine(line.constData(), line.constData() + lineLength, lineCounter,
+                data);
         lineCounter++;
         if (!fillSamplesOnly)
-            updateProgress(lineCounter, rowCount(), lastEmittedPercent);
+            updateProgress(lineCounter, endParsedRow_, lastEmittedPercent);
     }
+    finishParsing(data);
     return data;
 }
 
@@ -267,32 +715,10 @@ std::tuple<bool, QVector<QVector<QVariant>>> DatasetInner::fillData(
     if (!openQuaZipFile(zipFile))
         return {false, {}};
 
-    QTextStream stream(&zipFile);
-    stream.setCodec("UTF-8");
-    QVector<QVector<QVariant>> data{parseData(stream, fillSamplesOnly)};
+    prepareColumnConditions(fillSamplesOnly);
+    QVector<QVector<QVariant>> data{parseData(zipFile, fillSamplesOnly)};
     LOG(LogTypes::IMPORT_EXPORT,
         "Loaded " + QString::number(data.size()) + " rows.");
 
     return {true, data};
 }
-
-QVector<QVector<QVariant>> DatasetInner::prepareContainerForAllData() const
-{
-    QVector<QVector<QVariant>> data;
-    data.resize(static_cast<int>(rowCount()));
-    const int activeColumnsCount{activeColumns_.size()};
-    for (auto& row : data)
-        row.resize(activeColumnsCount);
-    return data;
-}
-
-QVector<QVector<QVariant>> DatasetInner::prepareContainerForSampleData() const
-{
-    QVector<QVector<QVariant>> data;
-    const int rowsCountForSamples =
-        static_cast<int>((rowCount() > SAMPLE_SIZE ? SAMPLE_SIZE : rowCount()));
-    data.resize(rowsCountForSamples);
-    for (int i = 0; i < rowsCountForSamples; ++i)
-        data[i].resize(static_cast<int>(columnsCount_));
-    return data;
-}
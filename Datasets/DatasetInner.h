@@ -2,10 +2,12 @@
 
 #include "Dataset.h"
 
+#include <limits>
+
 #include <Qt5Quazip/quazip.h>
+#include <QSet>
 
 class QuaZipFile;
-class QTextStream;
 
 /**
  * @class DatasetInner
@@ -17,8 +19,31 @@ class DatasetInner : public Dataset
 public:
     explicit DatasetInner(const QString& name, QObject* parent = nullptr);
 
+    /**
+     * @brief Constructor of dataset stored outside of datasets dir.
+     * @param name Dataset name.
+     * @param filePath Path of .vbx file.
+     * @param parent Parent object.
+     */
+    DatasetInner(const QString& name, const QString& filePath,
+                 QObject* parent = nullptr);
+
     ~DatasetInner() override = default;
 
+    /**
+     * @brief Get identifier of .vbx file built from its path and time of
+     * last modification.
+     * @return Identifier of source.
+     */
+    QString getSourceId() const override;
+
+    /**
+     * @brief Get used memory including raw content of strings file kept
+     * while dataset is not loaded.
+     * @return Used bytes.
+     */
+    quint64 getUsedMemory() const override;
+
 protected:
     std::tuple<bool, QVector<QVector<QVariant>>> getSample() override;
 
@@ -28,7 +53,22 @@ protected:
 
     void closeZip() override;
 
+    void releaseLoadingBuffers() override;
+
 private:
+    /**
+     * @brief Conditions and projection for single column of parsed file.
+     */
+    struct ColumnCondition
+    {
+        bool active_{false};
+        bool ranged_{false};
+        double min_{0.};
+        double max_{0.};
+        bool stringsRestricted_{false};
+        QSet<int> acceptedStrings_{};
+    };
+
     bool openZip();
 
     static bool openQuaZipFile(QuaZipFile& zipFile);
@@ -41,11 +81,51 @@ private:
 
     static bool loadXmlFile(QByteArray& definitionContent, QuaZip& zip);
 
-    bool loadStrings(QuaZip& zip);
+    /**
+     * @brief Read raw content of strings file.
+     * @param zip Opened zip.
+     * @param neededStrings Number of first strings needed. Content after them
+     * is read only when all strings are needed.
+     * @return True if success, false otherwise.
+     */
+    bool loadStrings(QuaZip& zip, int neededStrings = ALL_STRINGS);
+
+    int getLastSampleStringIndex(
+        const QVector<QVector<QVariant>>& sample) const;
+
+    void decodeReferencedStrings(const QVector<QVector<QVariant>>& data,
+                                 bool fillSamplesOnly);
+
+    QVariant decodeString(int index) const;
+
+    void loadIndexes(QuaZip& zip);
+
+    std::tuple<bool, QVector<RowGroup>> loadRowGroups(QuaZip& zip);
+
+    bool rowGroupMatchesPredicates(const RowGroup& group) const;
+
+    std::tuple<bool, QVector<QVector<QVariant>>> fillDataUsingRowGroups(
+        QuaZip& zip, const QVector<RowGroup>& groups);
+
+    void prepareColumnConditions(bool fillSamplesOnly);
+
+    QSet<int> findStringIndexes(const QStringList& strings) const;
+
+    bool parseRow(const char* begin, const char* end,
+                  QVector<QVariant>& row) const;
 
-    QVector<QVariant> fillRow(const QStringList& line, bool fillSamplesOnly);
+    static bool matchesCondition(const ColumnCondition& condition,
+                                 ColumnType columnFormat,
+                                 const QByteArray& element);
 
-    QVector<QVector<QVariant>> parseData(QTextStream& stream,
+    void addLine(const char* begin, const char* end, unsigned int lineNumber,
+                 QVector<QVector<QVariant>>& data);
+
+    void publishLoadedRows(const QVector<QVector<QVariant>>& data);
+
+    void finishParsing(QVector<QVector<QVariant>>& data);
+
+    QVector<QVector<QVariant>> parseData(QuaZipFile& zipFile,
                                          bool fillSamplesOnly);
 
     std::tuple<bool, QVector<QVector<QVariant>>> fillData(QuaZip& zip,
@@ -55,15 +135,48 @@ private:
                         unsigned int& lastEmittedPercent);
 
     static QVariant getElementAsVariant(ColumnType columnFormat,
-                                        const QString& element);
+                                        const QByteArray& element);
 
     static QVariant getDefaultVariantForFormat(const ColumnType format);
 
-    QVector<QVector<QVariant>> prepareContainerForAllData() const;
+    QuaZip zip_;
+
+    /// Raw UTF-8 content of strings file. Decoded on demand.
+    QByteArray stringsArena_;
 
-    QVector<QVector<QVariant>> prepareContainerForSampleData() const;
+    /// Start of each string in arena plus position after last one.
+    QVector<int> stringsOffsets_;
 
-    QuaZip zip_;
+    static constexpr int ALL_STRINGS{std::numeric_limits<int>::max()};
+
+    /// Size of parts in which beginning of strings file is read.
+    static constexpr qint64 STRINGS_READ_SIZE{64 * 1024};
+
+    /// Conditions for each column of data file built from load query.
+    QVector<ColumnCondition> columnConditions_;
+
+    /// Last column which needs to be read from each line.
+    Column lastNeededColumn_{0};
+
+    /// Number of columns in parsed rows.
+    int rowSize_{0};
+
+    /// Rows taken during current parsing.
+    LoadMode parsingMode_{LoadMode::ALL_ROWS};
+    unsigned int firstParsedRow_{0};
+    unsigned int endParsedRow_{0};
+
+    /// Rows matching predicates seen so far, used for sampling.
+    unsigned int matchedRows_{0};
+
+    /// Line numbers of sampled rows, used to restore order of source.
+    QVector<unsigned int> sampleSourceRows_;
+
+    /// Rows are emitted in chunks while parsing when set.
+    bool publishRows_{false};
+
+    /// Number of parsed rows already emitted.
+    int publishedRows_{0};
 
     const QString datasetsDir_;
 };
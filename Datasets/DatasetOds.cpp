@@ -6,11 +6,11 @@ DatasetOds::DatasetOds(const QString& name, const QString& zipFileName,
                        QObject* parent)
     : DatasetSpreadsheet(name, zipFileName, parent)
 {
-    importer_ = std::make_unique<ImportOds>(zipFile_);
+    importer_ = createImporter(zipFile_);
 }
 
-bool DatasetOds::loadSpecificData()
+std::unique_ptr<ImportSpreadsheet> DatasetOds::createImporter(
+    QIODevice& ioDevice) const
 {
-    // Nothing specific for .ods.
-    return true;
+    return std::make_unique<ImportOds>(ioDevice);
 }
@@ -16,5 +16,6 @@ public:
     ~DatasetOds() override = default;
 
 protected:
-    bool loadSpecificData() override;
+    std::unique_ptr<ImportSpreadsheet> createImporter(
+        QIODevice& ioDevice) const override;
 };
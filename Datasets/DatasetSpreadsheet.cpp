@@ -1,5 +1,12 @@
 #include "DatasetSpreadsheet.h"
 
+#include <algorithm>
+#include <future>
+#include <vector>
+
+#include <QDate>
+#include <QLocale>
+
 #include <Logger.h>
 
 DatasetSpreadsheet::DatasetSpreadsheet(const QString& name,
@@ -9,37 +16,83 @@ DatasetSpreadsheet::DatasetSpreadsheet(const QString& name,
 {
 }
 
+void DatasetSpreadsheet::setCacheFilePath(const QString& cacheFilePath)
+{
+    cacheFilePath_ = cacheFilePath;
+}
+
+QString DatasetSpreadsheet::getCacheFilePath() const
+{
+    return completelyLoaded_ ? cacheFilePath_ : QString();
+}
+
+bool DatasetSpreadsheet::loadSheetNames()
+{
+    bool success{false};
+    std::tie(success, sheetNames_) = importer_->getSheetNames();
+    if (!success)
+        LOG(LogTypes::IMPORT_EXPORT, importer_->getLastError());
+    return success;
+}
+
+const QStringList& DatasetSpreadsheet::getSheetNames() const
+{
+    return sheetNames_;
+}
+
+void DatasetSpreadsheet::setSelectedSheets(const QStringList& sheets)
+{
+    selectedSheets_ = sheets;
+}
+
+void DatasetSpreadsheet::setSourceSheetColumn(bool sourceSheetColumn)
+{
+    sourceSheetColumn_ = sourceSheetColumn;
+}
+
 bool DatasetSpreadsheet::analyze()
 {
     importer_->setNameForEmptyColumn(QObject::tr("no name"));
-    QObject::connect(importer_.get(),
-                     &ImportSpreadsheet::progressPercentChanged, this,
-                     &Dataset::loadingPercentChanged);
+    // Importer reports progress from loading thread.
+    QObject::connect(
+        importer_.get(), &ImportSpreadsheet::progressPercentChanged, this,
+        [this](unsigned int percent) { setLoadingPercent(percent); },
+        Qt::DirectConnection);
 
-    if (!getSheetList() || !loadSpecificData() ||
-        !getColumnTypes(getSheetName()) || !getHeadersList(getSheetName()))
+    if (!loadSheetNames() || sheetNames_.isEmpty())
         return false;
 
-    columnsCount_ = importer_->getColumnCount(getSheetName()).second;
-    rowsCount_ = importer_->getRowCount(getSheetName()).second;
+    for (const QString& sheet : getSelectedSheets())
+    {
+        auto [typesRead, columnTypes] = importer_->getColumnTypes(sheet);
+        auto [namesRead, columnNames] = importer_->getColumnNames(sheet);
+        auto [rowsRead, rowCount] = importer_->getRowCount(sheet);
+        if (!typesRead || !namesRead || !rowsRead)
+        {
+            LOG(LogTypes::IMPORT_EXPORT, importer_->getLastError());
+            return false;
+        }
+
+        if (!addSheetDefinition(sheet, columnNames, columnTypes, rowCount))
+            return false;
+    }
+    addSourceSheetColumnDefinition();
 
     valid_ = true;
 
     return true;
 }
 
-const QString& DatasetSpreadsheet::getSheetName()
-{
-    return sheetNames_.constFirst();
-}
-
 std::tuple<bool, QVector<QVector<QVariant>>> DatasetSpreadsheet::getSample()
 {
-    auto [success, data] = getDataFromZip(getSheetName(), true);
+    // Sample is taken from first sheet.
+    auto [success, data] =
+        getDataFromZip(getSelectedSheets().constFirst(), true);
     if (!success)
         return {false, {}};
 
     updateSampleDataStrings(data);
+    appendSourceSheetColumn(data);
     return {true, data};
 }
 
@@ -49,7 +102,15 @@ std::tuple<bool, QVector<QVector<QVariant>>> DatasetSpreadsheet::getAllData()
         return {false, {}};
 
     QVector<QVector<QVariant>> data;
-    std::tie(valid_, data) = getDataFromZip(getSheetName(), false);
+    completelyLoaded_ = isCompleteLoad();
+    const QStringList sheets{getSelectedSheets()};
+    if (sheets.size() == 1)
+        std::tie(valid_, data) = getDataFromZip(sheets.constFirst(), false);
+    else
+        std::tie(valid_, data) = getDataFromSheets(sheets);
+
+    if (valid_)
+        appendSourceSheetColumn(data);
     return {valid_, data};
 }
 
@@ -59,37 +120,114 @@ void DatasetSpreadsheet::closeZip()
     importer_ = nullptr;
 }
 
-bool DatasetSpreadsheet::getSheetList()
+std::unique_ptr<ImportSpreadsheet> DatasetSpreadsheet::createImporter(
+    [[maybe_unused]] QIODevice& ioDevice) const
 {
-    bool success{false};
-    std::tie(success, sheetNames_) = importer_->getSheetNames();
-    if (!success)
-        LOG(LogTypes::IMPORT_EXPORT, importer_->getLastError());
-    return success;
+    return nullptr;
 }
 
-bool DatasetSpreadsheet::getHeadersList(const QString& sheetName)
+bool DatasetSpreadsheet::isCompleteLoad() const
 {
-    bool success{false};
-    std::tie(success, headerColumnNames_) =
-        importer_->getColumnNames(sheetName);
-    if (!success)
-        LOG(LogTypes::IMPORT_EXPORT, importer_->getLastError());
-    return success;
+    const QStringList sheets{getSelectedSheets()};
+    const bool firstSheetOnly{sheets.size() == 1 &&
+                              sheets.constFirst() == sheetNames_.value(0)};
+    return firstSheetOnly && !sourceSheetColumn_ &&
+           !activeColumns_.contains(false) && !query_.isPartial() &&
+           !query_.hasPredicates();
 }
 
-bool DatasetSpreadsheet::getColumnTypes(const QString& sheetName)
+QStringList DatasetSpreadsheet::getSelectedSheets() const
 {
-    bool success{false};
-    std::tie(success, columnTypes_) = importer_->getColumnTypes(sheetName);
-    if (!success)
+    QStringList sheets;
+    for (const QString& sheet : selectedSheets_)
+        if (sheetNames_.contains(sheet) && !sheets.contains(sheet))
+            sheets.append(sheet);
+    if (sheets.isEmpty() && !sheetNames_.isEmpty())
+        sheets.append(sheetNames_.constFirst());
+    return sheets;
+}
+
+bool DatasetSpreadsheet::addSheetDefinition(
+    const QString& sheet, const QStringList& columnNames,
+    const QVector<ColumnType>& columnTypes, unsigned int rowCount)
+{
+    if (sheetColumnTypes_.isEmpty())
     {
-        LOG(LogTypes::IMPORT_EXPORT, importer_->getLastError());
+        headerColumnNames_ = columnNames;
+        columnTypes_ = columnTypes;
+        columnsCount_ = static_cast<unsigned int>(columnNames.size());
+        rowsCount_ = 0;
+    }
+    else if (columnNames != headerColumnNames_ ||
+             columnTypes.size() != columnTypes_.size())
+    {
+        error_ = QObject::tr("Columns of sheet ") + sheet +
+                 QObject::tr(" differ from columns of sheet ") +
+                 getSelectedSheets().constFirst();
+        LOG(LogTypes::IMPORT_EXPORT, error_);
         return false;
     }
+
+    for (int column = 0; column < columnTypes_.size(); ++column)
+        if (columnTypes_[column] != columnTypes[column])
+            columnTypes_[column] = ColumnType::STRING;
+
+    sheetColumnTypes_.append(columnTypes);
+    sheetRowCounts_.append(rowCount);
+    rowsCount_ += rowCount;
     return true;
 }
 
+void DatasetSpreadsheet::addSourceSheetColumnDefinition()
+{
+    if (!sourceSheetColumn_)
+        return;
+
+    headerColumnNames_.append(QObject::tr("Sheet"));
+    columnTypes_.append(ColumnType::STRING);
+    ++columnsCount_;
+}
+
+int DatasetSpreadsheet::getSheetColumnCount() const
+{
+    return static_cast<int>(columnCount()) - (sourceSheetColumn_ ? 1 : 0);
+}
+
+void DatasetSpreadsheet::appendSourceSheetColumn(
+    QVector<QVector<QVariant>>& data) const
+{
+    // Columns not chosen yet while sample is retrieved.
+    if (!sourceSheetColumn_ ||
+        (!activeColumns_.isEmpty() && !activeColumns_.constLast()))
+        return;
+
+    // Rows of sheet share one name, rows past counted ones are of last sheet.
+    const QStringList sheets{getSelectedSheets()};
+    int row{0};
+    for (int sheet = 0; sheet < sheetRowCounts_.size(); ++sheet)
+    {
+        const QVariant sheetName{sheets.value(sheet)};
+        const int sheetEnd{static_cast<int>(std::min(
+            static_cast<unsigned int>(data.size()),
+            static_cast<unsigned int>(row) + sheetRowCounts_[sheet]))};
+        for (; row < sheetEnd; ++row)
+            data[row].append(sheetName);
+    }
+
+    const QVariant lastSheetName{sheets.value(sheets.size() - 1)};
+    for (; row < data.size(); ++row)
+        data[row].append(lastSheetName);
+}
+
+QVector<unsigned int> DatasetSpreadsheet::getExcludedColumns() const
+{
+    QVector<unsigned int> excludedColumns;
+    for (Column column = 0; column < getSheetColumnCount(); ++column)
+        if (!activeColumns_.at(column))
+            excludedColumns.append(static_cast<unsigned int>(column));
+    return excludedColumns;
+}
+
 std::tuple<bool, QVector<QVector<QVariant>>> DatasetSpreadsheet::getDataFromZip(
     const QString& sheetName, bool fillSamplesOnly)
 {
@@ -98,17 +236,24 @@ std::tuple<bool, QVector<QVector<QVariant>>> DatasetSpreadsheet::getDataFromZip(
     if (fillSamplesOnly)
     {
         std::tie(success, data) = importer_->getLimitedData(
-            sheetName, {}, SAMPLE_SIZE < rowCount() ? SAMPLE_SIZE : rowCount());
+            sheetName, {}, std::min(SAMPLE_SIZE, sheetRowCounts_.value(0)));
     }
     else
     {
-        QVector<unsigned int> excludedColumns;
-        for (Column column = 0; column < static_cast<Column>(columnCount());
-             ++column)
-            if (!activeColumns_.at(column))
-                excludedColumns.append(static_cast<unsigned int>(column));
-        std::tie(success, data) =
-            importer_->getData(sheetName, excludedColumns);
+        const QVector<unsigned int> excludedColumns{getExcludedColumns()};
+        if (query_.mode_ == LoadMode::ROW_RANGE)
+        {
+            // Rows before range are dropped later by generic query handling.
+            const quint64 rangeEnd{quint64(query_.firstRow_) +
+                                   query_.rowLimit_};
+            std::tie(success, data) = importer_->getLimitedData(
+                sheetName, excludedColumns,
+                static_cast<unsigned int>(
+                    std::min(static_cast<quint64>(rowCount()), rangeEnd)));
+        }
+        else
+            std::tie(success, data) =
+                importer_->getData(sheetName, excludedColumns);
     }
 
     if (!success)
@@ -119,10 +264,115 @@ std::tuple<bool, QVector<QVector<QVariant>>> DatasetSpreadsheet::getDataFromZip(
 
     if (!fillSamplesOnly)
     {
-        Q_ASSERT(rowCount() == static_cast<unsigned int>(data.size()));
+        QVector<QHash<QString, int>> stringIndexes;
+        internSheetStrings(data, stringIndexes);
+        Q_ASSERT(query_.isPartial() ||
+                 rowCount() == static_cast<unsigned int>(data.size()));
         LOG(LogTypes::IMPORT_EXPORT,
             "Loaded file having " + QString::number(rowsCount_) + " rows.");
     }
 
     return {true, data};
 }
+
+std::tuple<bool, QVector<QVector<QVariant>>>
+DatasetSpreadsheet::getDataFromSheets(const QStringList& sheets)
+{
+    // Each sheet is read by own importer on separate thread.
+    const QVector<unsigned int> excludedColumns{getExcludedColumns()};
+    std::vector<std::future<std::tuple<bool, QVector<QVector<QVariant>>>>>
+        sheetsData;
+    for (const QString& sheet : sheets)
+        sheetsData.push_back(std::async(
+            std::launch::async, &DatasetSpreadsheet::loadSheet, this, sheet,
+            excludedColumns));
+
+    QVector<QVector<QVariant>> data;
+    data.reserve(static_cast<int>(rowCount()));
+    QVector<QHash<QString, int>> stringIndexes;
+    bool success{true};
+    for (int sheetIndex = 0; sheetIndex < sheets.size(); ++sheetIndex)
+    {
+        auto [loaded, sheetData] = sheetsData[sheetIndex].get();
+        success = success && loaded && !isLoadingCancelled();
+        if (!success)
+            continue;
+
+        widenSheetColumns(sheetData, sheetIndex);
+        internSheetStrings(sheetData, stringIndexes);
+        data.append(sheetData);
+        setLoadingPercent(
+            static_cast<unsigned int>(100 * (sheetIndex + 1) / sheets.size()));
+    }
+
+    if (!success)
+        return {false, {}};
+
+    LOG(LogTypes::IMPORT_EXPORT, "Loaded " + QString::number(sheets.size()) +
+                                     " sheets having " +
+                                     QString::number(data.size()) + " rows.");
+    return {true, data};
+}
+
+std::tuple<bool, QVector<QVector<QVariant>>> DatasetSpreadsheet::loadSheet(
+    const QString& sheetName,
+    const QVector<unsigned int>& excludedColumns) const
+{
+    QFile file(zipFile_.fileName());
+    const std::unique_ptr<ImportSpreadsheet> importer{createImporter(file)};
+    if (importer == nullptr)
+        return {false, {}};
+
+    importer->setNameForEmptyColumn(QObject::tr("no name"));
+    auto [success, data] = importer->getData(sheetName, excludedColumns);
+    if (!success)
+        LOG(LogTypes::IMPORT_EXPORT, importer->getLastError());
+    return {success, data};
+}
+
+void DatasetSpreadsheet::widenSheetColumns(QVector<QVector<QVariant>>& data,
+                                           int sheetIndex) const
+{
+    const QVector<ColumnType>& sheetTypes{sheetColumnTypes_[sheetIndex]};
+    int dataColumn{0};
+    for (Column column = 0; column < getSheetColumnCount(); ++column)
+    {
+        if (!activeColumns_.at(column))
+            continue;
+
+        if (columnTypes_[column] == ColumnType::STRING &&
+            sheetTypes[column] != ColumnType::STRING)
+            for (auto& row : data)
+            {
+                QVariant& value{row[dataColumn]};
+                if (value.isNull())
+                    continue;
+                value = (sheetTypes[column] == ColumnType::DATE
+                             ? value.toDate().toString(Qt::ISODate)
+                             : QString::number(value.toDouble(), 'g',
+                                               QLocale::FloatingPointShortest));
+            }
+        ++dataColumn;
+    }
+}
+
+void DatasetSpreadsheet::internSheetStrings(
+    QVector<QVector<QVariant>>& data,
+    QVector<QHash<QString, int>>& stringIndexes)
+{
+    if (query_.hasPredicates() || query_.isPartial())
+        return;
+
+    int dataColumn{0};
+    for (Column column = 0; column < getSheetColumnCount(); ++column)
+    {
+        if (!activeColumns_.at(column))
+            continue;
+
+        if (stringIndexes.size() <= dataColumn)
+            stringIndexes.resize(dataColumn + 1);
+        if (columnTypes_[column] == ColumnType::STRING)
+            internColumnStrings(data, dataColumn, stringIndexes[dataColumn]);
+        ++dataColumn;
+    }
+}
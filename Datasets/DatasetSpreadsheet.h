@@ -8,6 +8,9 @@
 /**
  * @class DatasetSpreadsheet
  * @brief Dataset class for spreadsheets.
+ *
+ * Several sheets having same columns can be selected. Their rows are loaded
+ * concurrently and concatenated in order of selection.
  */
 class DatasetSpreadsheet : public Dataset
 {
@@ -18,28 +21,148 @@ public:
 
     ~DatasetSpreadsheet() override = default;
 
+    /**
+     * @brief Set file to which loaded data can be cached.
+     * @param cacheFilePath Path of cache file.
+     */
+    void setCacheFilePath(const QString& cacheFilePath);
+
+    /**
+     * @brief Get file to which loaded data can be cached.
+     * @return Path of cache file, empty if not all data was loaded.
+     */
+    QString getCacheFilePath() const;
+
+    /**
+     * @brief Read names of sheets in file. Done also during initialization.
+     * @return True if succeed, false otherwise.
+     */
+    virtual bool loadSheetNames();
+
+    /**
+     * @brief Get names of sheets in file.
+     * @return Sheet names.
+     */
+    const QStringList& getSheetNames() const;
+
+    /**
+     * @brief Set sheets to load. Need to be called before initialization.
+     * First sheet is loaded when none of given sheets exists.
+     * @param sheets Names of sheets.
+     */
+    void setSelectedSheets(const QStringList& sheets);
+
+    /**
+     * @brief Add column with name of sheet from which each row comes.
+     * Need to be called before initialization.
+     * @param sourceSheetColumn Flag indicating column should be added.
+     */
+    void setSourceSheetColumn(bool sourceSheetColumn);
+
 protected:
     bool analyze() override;
 
-    virtual bool loadSpecificData() = 0;
-
     std::tuple<bool, QVector<QVector<QVariant>>> getSample() override;
 
     std::tuple<bool, QVector<QVector<QVariant>>> getAllData() override;
 
     void closeZip() override;
 
+    /**
+     * @brief Create importer reading given device.
+     * @param ioDevice Device with spreadsheet.
+     * @return Importer or nullptr when dataset does not use importers.
+     */
+    virtual std::unique_ptr<ImportSpreadsheet> createImporter(
+        QIODevice& ioDevice) const;
+
+    /**
+     * @brief Check if all rows and columns are going to be loaded.
+     * @return True if load is complete, false otherwise.
+     */
+    bool isCompleteLoad() const;
+
+    /**
+     * @brief Get sheets to load.
+     * @return Names of selected sheets existing in file.
+     */
+    QStringList getSelectedSheets() const;
+
+    /**
+     * @brief Add definition of next selected sheet. Columns of first sheet
+     * are used, other sheets need to have same column names. Columns having
+     * different types in sheets become string columns.
+     * @param sheet Sheet name.
+     * @param columnNames Names of columns in sheet.
+     * @param columnTypes Types of columns in sheet.
+     * @param rowCount Number of rows in sheet.
+     * @return True if sheet matches previous ones, false otherwise.
+     */
+    bool addSheetDefinition(const QString& sheet,
+                            const QStringList& columnNames,
+                            const QVector<ColumnType>& columnTypes,
+                            unsigned int rowCount);
+
+    /**
+     * @brief Add source sheet column to definition if requested.
+     */
+    void addSourceSheetColumnDefinition();
+
+    /**
+     * @brief Get number of columns coming from sheets.
+     * @return Number of columns without source sheet column.
+     */
+    int getSheetColumnCount() const;
+
+    /**
+     * @brief Append source sheet column to rows when it is requested and
+     * active.
+     * @param data Rows of concatenated sheets.
+     */
+    void appendSourceSheetColumn(QVector<QVector<QVariant>>& data) const;
+
     QFile zipFile_;
     std::unique_ptr<ImportSpreadsheet> importer_{nullptr};
 
+    /// Set when all rows and columns were loaded, so data can be cached.
+    bool completelyLoaded_{false};
+
+    QStringList sheetNames_;
+
 private:
-    bool getSheetList();
-    bool getHeadersList(const QString& sheetName);
-    bool getColumnTypes(const QString& sheetName);
+    QVector<unsigned int> getExcludedColumns() const;
+
     std::tuple<bool, QVector<QVector<QVariant>>> getDataFromZip(
         const QString& sheetName, bool fillSamplesOnly);
 
-    const QString& getSheetName();
+    std::tuple<bool, QVector<QVector<QVariant>>> getDataFromSheets(
+        const QStringList& sheets);
 
-    QStringList sheetNames_;
+    std::tuple<bool, QVector<QVector<QVariant>>> loadSheet(
+        const QString& sheetName,
+        const QVector<unsigned int>& excludedColumns) const;
+
+    void widenSheetColumns(QVector<QVector<QVariant>>& data,
+                           int sheetIndex) const;
+
+    /**
+     * @brief Intern strings of loaded sheet rows unless rows are filtered
+     * later, as strings of dropped rows would be kept.
+     * @param data Rows of sheet with active columns.
+     * @param stringIndexes Dictionaries of columns kept between sheets.
+     */
+    void internSheetStrings(QVector<QVector<QVariant>>& data,
+                            QVector<QHash<QString, int>>& stringIndexes);
+
+    QString cacheFilePath_;
+
+    QStringList selectedSheets_;
+
+    bool sourceSheetColumn_{false};
+
+    /// Types of columns in each of loaded sheets.
+    QVector<QVector<ColumnType>> sheetColumnTypes_;
+
+    /// Number of rows in each of loaded sheets.
+    QVector<unsigned int> sheetRowCounts_;
 };
@@ -1,37 +1,491 @@
 #include "DatasetXlsx.h"
 
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <Qt5Quazip/quazip.h>
+#include <Qt5Quazip/quazipfile.h>
+#include <QSet>
+#include <QXmlStreamReader>
+
 #include <ImportXlsx.h>
 #include <Logger.h>
 
+#include "XlsxSheetParser.h"
+
 DatasetXlsx::DatasetXlsx(const QString& name, const QString& zipFileName,
                          QObject* parent)
     : DatasetSpreadsheet(name, zipFileName, parent)
 {
-    importer_ = std::make_unique<ImportXlsx>(zipFile_);
 }
 
-bool DatasetXlsx::loadSharedStrings()
+DatasetXlsx::~DatasetXlsx() = default;
+
+bool DatasetXlsx::loadSheetNames()
+{
+    if (importer_ != nullptr)
+        return DatasetSpreadsheet::loadSheetNames();
+
+    QuaZip zip(zipFile_.fileName());
+    return zip.open(QuaZip::mdUnzip) && readSheetPaths(zip);
+}
+
+void DatasetXlsx::setChunkSize(qint64 chunkSize) { chunkSize_ = chunkSize; }
+
+void DatasetXlsx::setUseImporter(bool useImporter)
+{
+    useImporter_ = useImporter;
+    importer_ = (useImporter_ ? createImporter(zipFile_) : nullptr);
+}
+
+quint64 DatasetXlsx::getUsedMemory() const
 {
-    const auto [success, sharedStringsList] =
+    return Dataset::getUsedMemory() +
+           (parser_ != nullptr ? parser_->getUsedMemory() : 0);
+}
+
+bool DatasetXlsx::analyze()
+{
+    if (useImporter_)
+        return analyzeUsingImporter();
+
+    QuaZip zip(zipFile_.fileName());
+    if (!zip.open(QuaZip::mdUnzip))
+    {
+        error_ = QObject::tr("Can not open file ") + zipFile_.fileName();
+        LOG(LogTypes::IMPORT_EXPORT, error_);
+        return false;
+    }
+
+    auto [stylesFound, dateStyles] = getDateStyles(zip);
+    const bool sheetsFound{readSheetPaths(zip) && !sheetNames_.isEmpty()};
+    if (!sheetsFound || !stylesFound || !loadSharedStrings(zip))
+    {
+        error_ = QObject::tr("File ") + zipFile_.fileName() +
+                 QObject::tr(" is damaged.");
+        LOG(LogTypes::IMPORT_EXPORT, error_);
+        return false;
+    }
+
+    // Each selected sheet is parsed by own reader of file on separate thread.
+    const QStringList sheets{getSelectedSheets()};
+    std::vector<std::future<std::unique_ptr<XlsxSheetParser>>> sheetParsers;
+    for (const QString& sheet : sheets)
+        sheetParsers.push_back(
+            std::async(std::launch::async, &DatasetXlsx::parseSheet,
+                       zipFile_.fileName(), sheetPaths_.value(sheet),
+                       dateStyles, chunkSize_));
+
+    std::vector<std::unique_ptr<XlsxSheetParser>> parsedSheets;
+    for (auto& sheetParser : sheetParsers)
+        parsedSheets.push_back(sheetParser.get());
+
+    if (std::any_of(parsedSheets.cbegin(), parsedSheets.cend(),
+                    [](const auto& parser) { return parser == nullptr; }))
+    {
+        LOG(LogTypes::IMPORT_EXPORT, "Can not parse sheets of " +
+                                         zipFile_.fileName() +
+                                         ", reading them using importer.");
+        return analyzeUsingImporter();
+    }
+
+    for (std::size_t sheet = 0; sheet < parsedSheets.size(); ++sheet)
+        if (!mergeSheet(sheets[static_cast<int>(sheet)],
+                        std::move(parsedSheets[sheet])))
+            return false;
+
+    // Merged parser widens columns differing between sheets or empty in some.
+    columnTypes_ = parser_->getColumnTypes();
+    addSourceSheetColumnDefinition();
+    valid_ = true;
+
+    return true;
+}
+
+std::tuple<bool, QVector<QVector<QVariant>>> DatasetXlsx::getSample()
+{
+    if (useImporter_)
+        return DatasetSpreadsheet::getSample();
+
+    const int sampleRows{
+        static_cast<int>(std::min(SAMPLE_SIZE, rowCount()))};
+    QVector<QVector<QVariant>> data(
+        sampleRows, QVector<QVariant>(parser_->getColumnCount()));
+    for (int column = 0; column < parser_->getColumnCount(); ++column)
+    {
+        const QVector<QVariant>& values{parser_->getColumn(column)};
+        for (int row = 0; row < sampleRows; ++row)
+            data[row][column] = values[row];
+    }
+
+    updateSampleDataStrings(data);
+    appendSourceSheetColumn(data);
+    return {true, data};
+}
+
+std::tuple<bool, QVector<QVector<QVariant>>> DatasetXlsx::getAllData()
+{
+    if (useImporter_)
+        return DatasetSpreadsheet::getAllData();
+
+    // Parsed values are released on every path, also on cancel.
+    const std::unique_ptr<XlsxSheetParser> parser{std::move(parser_)};
+    if (!isValid() || parser == nullptr)
+        return {false, {}};
+
+    completelyLoaded_ = isCompleteLoad();
+
+    // Columns are released one by one to limit peak memory usage. Strings
+    // are interned per column unless rows are filtered later.
+    const bool internWhileLoading{!query_.hasPredicates() &&
+                                  !query_.isPartial()};
+    QVector<QVector<QVariant>> data(
+        static_cast<int>(rowCount()),
+        QVector<QVariant>(
+            activeColumns_.mid(0, parser->getColumnCount()).count(true)));
+    int dataColumn{0};
+    for (Column column = 0; column < parser->getColumnCount(); ++column)
+    {
+        if (isLoadingCancelled())
+            return {false, {}};
+
+        if (!activeColumns_.at(column))
+            continue;
+
+        const QVector<QVariant> values{parser->takeColumn(column)};
+        for (int row = 0; row < values.size(); ++row)
+            data[row][dataColumn] = values[row];
+        if (internWhileLoading && columnTypes_[column] == ColumnType::STRING)
+        {
+            QHash<QString, int> stringIndexes;
+            internColumnStrings(data, dataColumn, stringIndexes);
+        }
+        dataColumn++;
+    }
+    appendSourceSheetColumn(data);
+    setLoadingPercent(100);
+
+    return {true, data};
+}
+
+std::unique_ptr<ImportSpreadsheet> DatasetXlsx::createImporter(
+    QIODevice& ioDevice) const
+{
+    return std::make_unique<ImportXlsx>(ioDevice);
+}
+
+void DatasetXlsx::releaseLoadingBuffers() { parser_ = nullptr; }
+
+bool DatasetXlsx::analyzeUsingImporter()
+{
+    useImporter_ = true;
+    parser_ = nullptr;
+    if (importer_ == nullptr)
+        importer_ = createImporter(zipFile_);
+
+    const auto [success, sharedStrings] =
         qobject_cast<ImportXlsx*>(importer_.get())->getSharedStrings();
     if (!success)
     {
         LOG(LogTypes::IMPORT_EXPORT, importer_->getLastError());
+        error_ = QObject::tr("File ") + zipFile_.fileName() +
+                 QObject::tr(" is damaged.");
         return false;
     }
-    for (const auto& sharedString : sharedStringsList)
+
+    sharedStrings_.clear();
+    for (const auto& sharedString : sharedStrings)
         sharedStrings_.append(QVariant(sharedString));
-    return success;
+    return DatasetSpreadsheet::analyze();
 }
 
-bool DatasetXlsx::loadSpecificData()
+std::tuple<bool, QByteArray> DatasetXlsx::readFile(QuaZip& zip,
+                                                   const QString& fileName)
 {
-    if (!loadSharedStrings())
+    QuaZipFile zipFile(&zip);
+    if (!zip.setCurrentFile(fileName) || !zipFile.open(QIODevice::ReadOnly))
     {
-        error_ = QObject::tr("File ") + zipFile_.fileName() +
-                 QObject::tr(" is damaged.");
+        LOG(LogTypes::IMPORT_EXPORT, "Can not open file " + fileName + ".");
+        return {false, {}};
+    }
+    return {true, zipFile.readAll()};
+}
+
+bool DatasetXlsx::readSheetPaths(QuaZip& zip)
+{
+    auto [workbookRead, workbook] =
+        readFile(zip, QStringLiteral("xl/workbook.xml"));
+    auto [relationsRead, relations] =
+        readFile(zip, QStringLiteral("xl/_rels/workbook.xml.rels"));
+    if (!workbookRead || !relationsRead)
         return false;
+
+    QHash<QString, QString> targets;
+    QXmlStreamReader relationsReader(relations);
+    while (!relationsReader.atEnd())
+    {
+        if (!relationsReader.readNextStartElement() ||
+            relationsReader.name() != QLatin1String("Relationship"))
+            continue;
+
+        // Targets are relative to xl directory unless absolute.
+        const QXmlStreamAttributes attributes{relationsReader.attributes()};
+        const QString target{
+            attributes.value(QLatin1String("Target")).toString()};
+        targets[attributes.value(QLatin1String("Id")).toString()] =
+            (target.startsWith('/') ? target.mid(1) : "xl/" + target);
+    }
+
+    sheetNames_.clear();
+    sheetPaths_.clear();
+    QXmlStreamReader workbookReader(workbook);
+    while (!workbookReader.atEnd())
+    {
+        if (!workbookReader.readNextStartElement() ||
+            workbookReader.name() != QLatin1String("sheet"))
+            continue;
+
+        QString name;
+        QString sheetId;
+        for (const auto& attribute : workbookReader.attributes())
+        {
+            if (attribute.name() == QLatin1String("name"))
+                name = attribute.value().toString();
+            if (attribute.name() == QLatin1String("id"))
+                sheetId = attribute.value().toString();
+        }
+        if (!targets.contains(sheetId))
+            return false;
+        sheetNames_.append(name);
+        sheetPaths_[name] = targets.value(sheetId);
+    }
+    return !workbookReader.hasError() && !relationsReader.hasError();
+}
+
+bool DatasetXlsx::loadSharedStrings(QuaZip& zip)
+{
+    sharedStrings_.clear();
+    const QString fileName{QStringLiteral("xl/sharedStrings.xml")};
+    if (!zip.setCurrentFile(fileName))
+        return true;
+
+    auto [success, content] = readFile(zip, fileName);
+    if (!success)
+        return false;
+
+    // Rich text strings are split into runs, phonetic hints are skipped.
+    QXmlStreamReader reader(content);
+    QString currentString;
+    while (!reader.atEnd())
+    {
+        reader.readNext();
+        if (reader.isStartElement() && reader.name() == QLatin1String("rPh"))
+            reader.skipCurrentElement();
+        else if (reader.isStartElement() &&
+                 reader.name() == QLatin1String("t"))
+            currentString.append(reader.readElementText());
+        else if (reader.isEndElement() && reader.name() == QLatin1String("si"))
+        {
+            sharedStrings_.append(QVariant(currentString));
+            currentString.clear();
+        }
+    }
+    return !reader.hasError();
+}
+
+std::tuple<bool, QVector<bool>> DatasetXlsx::getDateStyles(QuaZip& zip)
+{
+    auto [success, content] = readFile(zip, QStringLiteral("xl/styles.xml"));
+    if (!success)
+        return {false, {}};
+
+    // Built-in date formats and custom ones using day, month or year parts.
+    QSet<int> dateFormats{14, 15, 16, 17, 22};
+    QVector<bool> dateStyles;
+    bool inCellFormats{false};
+    QXmlStreamReader reader(content);
+    while (!reader.atEnd())
+    {
+        reader.readNext();
+        if (reader.isEndElement() && reader.name() == QLatin1String("cellXfs"))
+            inCellFormats = false;
+        if (!reader.isStartElement())
+            continue;
+
+        const QXmlStreamAttributes attributes{reader.attributes()};
+        const int formatId{
+            attributes.value(QLatin1String("numFmtId")).toInt()};
+        if (reader.name() == QLatin1String("numFmt"))
+        {
+            if (XlsxSheetParser::isDateFormat(
+                    attributes.value(QLatin1String("formatCode")).toString()))
+                dateFormats.insert(formatId);
+        }
+        else if (reader.name() == QLatin1String("cellXfs"))
+            inCellFormats = true;
+        else if (inCellFormats && reader.name() == QLatin1String("xf"))
+            dateStyles.append(dateFormats.contains(formatId));
+    }
+    return {!reader.hasError(), dateStyles};
+}
+
+std::unique_ptr<XlsxSheetParser> DatasetXlsx::parseSheet(
+    const QString& zipFileName, const QString& sheetPath,
+    const QVector<bool>& dateStyles, qint64 chunkSize)
+{
+    QuaZip zip(zipFileName);
+    QuaZipFile zipFile(&zip);
+    if (!zip.open(QuaZip::mdUnzip) || !zip.setCurrentFile(sheetPath) ||
+        !zipFile.open(QIODevice::ReadOnly))
+    {
+        LOG(LogTypes::IMPORT_EXPORT, "Can not open sheet " + sheetPath + ".");
+        return nullptr;
+    }
+
+    std::unique_ptr<XlsxSheetParser> parser{nullptr};
+    const std::size_t maxPendingChunks{
+        std::max(1U, std::thread::hardware_concurrency())};
+    std::deque<std::future<std::unique_ptr<XlsxSheetParser>>> pendingChunks;
+    bool success{true};
+    auto mergeOldestChunk{[&parser, &pendingChunks, &success]() {
+        std::unique_ptr<XlsxSheetParser> chunkParser{
+            pendingChunks.front().get()};
+        pendingChunks.pop_front();
+        success = success && chunkParser;
+        if (!success)
+            return;
+        if (parser == nullptr)
+            parser = std::move(chunkParser);
+        else
+            parser->append(std::move(*chunkParser));
+    }};
+    auto addChunk{[&](QByteArray rows) {
+        if (pendingChunks.size() >= maxPendingChunks)
+            mergeOldestChunk();
+        const bool withHeader{pendingChunks.empty() && parser == nullptr};
+        pendingChunks.push_back(std::async(
+            std::launch::async,
+            [rows = std::move(rows), dateStyles, withHeader]() {
+                auto chunkParser{
+                    std::make_unique<XlsxSheetParser>(dateStyles, withHeader)};
+                if (!chunkParser->parseRows(rows))
+                    chunkParser.reset();
+                return chunkParser;
+            }));
+    }};
+
+    // Inflate next block while chunks of sheet cut at row boundaries are
+    // parsed concurrently.
+    auto readBlock{[&zipFile]() { return zipFile.read(BLOCK_SIZE); }};
+    std::future<QByteArray> nextBlock{
+        std::async(std::launch::async, readBlock)};
+    QByteArray pending;
+    bool rowsFound{false};
+    const int minChunkSize{static_cast<int>(std::max(chunkSize, qint64{1}))};
+    while (success)
+    {
+        const QByteArray block{nextBlock.get()};
+        if (block.isEmpty())
+            break;
+        nextBlock = std::async(std::launch::async, readBlock);
+        pending.append(block);
+        if (!rowsFound)
+        {
+            const int firstRowStart{findRowStart(pending, 0, true)};
+            if (firstRowStart == -1)
+                continue;
+            pending.remove(0, firstRowStart);
+            rowsFound = true;
+        }
+
+        // Chunk ends where first row starting after chunk size begins.
+        int chunkStart{0};
+        while (pending.size() - chunkStart > minChunkSize)
+        {
+            const int chunkEnd{
+                findRowStart(pending, chunkStart + minChunkSize, true)};
+            if (chunkEnd == -1)
+                break;
+            addChunk(pending.mid(chunkStart, chunkEnd - chunkStart));
+            chunkStart = chunkEnd;
+        }
+        pending.remove(0, chunkStart);
+    }
+    nextBlock.wait();
+
+    if (rowsFound)
+    {
+        const int sheetDataEnd{pending.indexOf("</sheetData>")};
+        success = success && sheetDataEnd != -1;
+        if (success)
+            addChunk(pending.left(sheetDataEnd));
     }
+    while (!pendingChunks.empty())
+        mergeOldestChunk();
 
+    if (success && !rowsFound)
+    {
+        success = pending.contains("<sheetData");
+        parser = std::make_unique<XlsxSheetParser>(dateStyles);
+    }
+
+    if (!success)
+        return nullptr;
+    return parser;
+}
+
+int DatasetXlsx::findRowStart(const QByteArray& xml, int from, bool forward)
+{
+    const QByteArray rowTag{QByteArrayLiteral("<row")};
+    int index{forward ? xml.indexOf(rowTag, from)
+                      : xml.lastIndexOf(rowTag, from)};
+    while (index != -1)
+    {
+        // Skip other elements starting with same letters, like <rowBreaks>.
+        const int next{index + rowTag.size()};
+        const char nextChar{next < xml.size() ? xml[next] : '\0'};
+        if (nextChar == '>' || nextChar == '/' || QChar(nextChar).isSpace())
+            return index;
+        index = (forward ? xml.indexOf(rowTag, next)
+                         : (index > 0 ? xml.lastIndexOf(rowTag, index - 1)
+                                      : -1));
+    }
+    return -1;
+}
+
+bool DatasetXlsx::mergeSheet(const QString& sheet,
+                            std::unique_ptr<XlsxSheetParser> sheetParser)
+{
+    if (!addSheetDefinition(sheet, getHeaderNames(*sheetParser),
+                            sheetParser->getColumnTypes(),
+                            static_cast<unsigned int>(
+                                sheetParser->getRowCount())))
+        return false;
+
+    if (parser_ == nullptr)
+        parser_ = std::move(sheetParser);
+    else
+        parser_->append(std::move(*sheetParser));
     return true;
 }
+
+QStringList DatasetXlsx::getHeaderNames(const XlsxSheetParser& parser) const
+{
+    const QVector<QVariant>& header{parser.getHeader()};
+    QStringList headerNames;
+    for (int column = 0; column < parser.getColumnCount(); ++column)
+    {
+        QString name;
+        if (column < header.size() && header[column].type() == QVariant::Int)
+            name = sharedStrings_.value(header[column].toInt()).toString();
+        else if (column < header.size())
+            name = header[column].toString();
+        if (name.isEmpty())
+            name = QObject::tr("no name");
+        headerNames.append(name);
+    }
+    return headerNames;
+}
@@ -1,10 +1,24 @@
 #pragma once
 
+#include <memory>
+
+#include <QHash>
+
 #include "DatasetSpreadsheet.h"
 
+class QuaZip;
+class XlsxSheetParser;
+
 /**
  * @class DatasetXlsx
  * @brief Dataset definition for .xlsx files.
+ *
+ * Sheet is read once during analysis. Column types, row count and values
+ * are gathered in single pass and values are kept until data is loaded.
+ * Sheet is inflated on separate thread while already inflated parts, cut at
+ * row boundaries, are parsed concurrently. Selected sheets are parsed in
+ * parallel and appended in order of selection. Files which own parser can
+ * not read are read using ImportXlsx.
  */
 class DatasetXlsx : public DatasetSpreadsheet
 {
@@ -13,11 +27,78 @@ public:
     DatasetXlsx(const QString& name, const QString& zipFileName,
                 QObject* parent = nullptr);
 
-    ~DatasetXlsx() override = default;
+    ~DatasetXlsx() override;
+
+    bool loadSheetNames() override;
+
+    /**
+     * @brief Set approximate size of sheet part parsed on separate thread.
+     * Need to be called before initialization.
+     * @param chunkSize Size in bytes.
+     */
+    void setChunkSize(qint64 chunkSize);
+
+    /**
+     * @brief Read sheets using ImportXlsx instead of own parser. Need to be
+     * called before initialization.
+     * @param useImporter Flag indicating importer should be used.
+     */
+    void setUseImporter(bool useImporter);
+
+    /**
+     * @brief Get used memory including parsed values kept between analysis
+     * and load.
+     * @return Used bytes.
+     */
+    quint64 getUsedMemory() const override;
 
 protected:
-    bool loadSpecificData() override;
+    bool analyze() override;
+
+    std::tuple<bool, QVector<QVector<QVariant>>> getSample() override;
+
+    std::tuple<bool, QVector<QVector<QVariant>>> getAllData() override;
+
+    std::unique_ptr<ImportSpreadsheet> createImporter(
+        QIODevice& ioDevice) const override;
+
+    void releaseLoadingBuffers() override;
 
 private:
-    bool loadSharedStrings();
+    bool analyzeUsingImporter();
+
+    static std::tuple<bool, QByteArray> readFile(QuaZip& zip,
+                                                 const QString& fileName);
+
+    bool readSheetPaths(QuaZip& zip);
+
+    bool loadSharedStrings(QuaZip& zip);
+
+    static std::tuple<bool, QVector<bool>> getDateStyles(QuaZip& zip);
+
+    static std::unique_ptr<XlsxSheetParser> parseSheet(
+        const QString& zipFileName, const QString& sheetPath,
+        const QVector<bool>& dateStyles, qint64 chunkSize);
+
+    bool mergeSheet(const QString& sheet,
+                    std::unique_ptr<XlsxSheetParser> sheetParser);
+
+    static int findRowStart(const QByteArray& xml, int from, bool forward);
+
+    QStringList getHeaderNames(const XlsxSheetParser& parser) const;
+
+    std::unique_ptr<XlsxSheetParser> parser_{nullptr};
+
+    /// Paths of sheets in archive by sheet names.
+    QHash<QString, QString> sheetPaths_;
+
+    /// Size of inflated sheet block passed to parser.
+    static constexpr qint64 BLOCK_SIZE{1024 * 1024};
+
+    /// Minimal size of sheet part parsed on separate thread.
+    static constexpr qint64 CHUNK_SIZE{8 * 1024 * 1024};
+
+    qint64 chunkSize_{CHUNK_SIZE};
+
+    bool useImporter_{false};
 };
@@ -0,0 +1,206 @@
+#include "DsvParser.h"
+
+#include <algorithm>
+
+#include <QMap>
+
+DsvParser::DsvParser(char separator, char quote)
+    : separator_(separator), quote_(quote)
+{
+}
+
+const char* DsvParser::parseRecord(const char* begin, const char* end,
+                                   QVector<QByteArray>& fields) const
+{
+    fields.clear();
+    if (begin < end && *begin == '\n')
+        return begin + 1;
+    if (end - begin >= 2 && begin[0] == '\r' && begin[1] == '\n')
+        return begin + 2;
+
+    const char* position{begin};
+    while (true)
+    {
+        const char* fieldStart{position};
+        QByteArray quotedField;
+        const bool quoted{quote_ != '\0' && position < end &&
+                          *position == quote_};
+        if (quoted)
+        {
+            fieldStart = ++position;
+            while (position < end)
+            {
+                if (*position != quote_)
+                {
+                    ++position;
+                    continue;
+                }
+                if (position + 1 < end && position[1] == quote_)
+                {
+                    quotedField.append(fieldStart,
+                                       static_cast<int>(position + 1 -
+                                                        fieldStart));
+                    position += 2;
+                    fieldStart = position;
+                    continue;
+                }
+                break;
+            }
+            quotedField.append(fieldStart,
+                               static_cast<int>(position - fieldStart));
+            if (position < end)
+                ++position;
+            fieldStart = position;
+        }
+
+        while (position < end && *position != separator_ && *position != '\n')
+            ++position;
+        const char* fieldEnd{position};
+        if (fieldEnd > fieldStart && fieldEnd[-1] == '\r' &&
+            (position == end || *position == '\n'))
+            --fieldEnd;
+
+        const int fieldSize{static_cast<int>(fieldEnd - fieldStart)};
+        if (quoted)
+            fields.append(quotedField.append(fieldStart, fieldSize));
+        else
+            fields.append(QByteArray::fromRawData(fieldStart, fieldSize));
+
+        if (position >= end)
+            return end;
+        if (*position == '\n')
+            return position + 1;
+        ++position;
+    }
+}
+
+DsvParser::Scan DsvParser::scan(const char* data, const char* begin,
+                                const char* end) const
+{
+    // State at beginning of part is unknown, all are followed at once.
+    Scan scan;
+    State* states{scan.endState_};
+    for (const char* position = begin; position < end; ++position)
+    {
+        for (int start = 0; start < STATES_COUNT; ++start)
+        {
+            const State state{states[start]};
+            states[start] = nextState(state, *position);
+            if (*position != '\n' || state == QUOTED_FIELD)
+                continue;
+
+            if (scan.firstRecordEnd_[start] == -1)
+                scan.firstRecordEnd_[start] = position + 1 - data;
+            if (!isEmptyLine(data, position))
+                ++scan.records_[start];
+        }
+    }
+    return scan;
+}
+
+const char* DsvParser::findLastRecordEnd(const char* begin,
+                                         const char* end) const
+{
+    const char* recordEnd{begin};
+    State state{FIELD_START};
+    for (const char* position = begin; position < end; ++position)
+    {
+        if (*position == '\n' && state != QUOTED_FIELD)
+            recordEnd = position + 1;
+        state = nextState(state, *position);
+    }
+    return recordEnd;
+}
+
+DsvParser DsvParser::sniff(const char* begin, const char* end)
+{
+    const QByteArray separators{",;\t|"};
+
+    char quote{'\0'};
+    for (const char candidate : {'"', '\''})
+        if (quote == '\0' && isQuoteUsed(candidate, separators, begin, end))
+            quote = candidate;
+
+    // Separator giving same and highest number of fields in records wins.
+    char bestSeparator{','};
+    int bestFieldsCount{1};
+    for (const char separator : separators)
+    {
+        const DsvParser parser(separator, quote);
+        QMap<int, int> recordsWithFieldsCount;
+        QVector<QByteArray> fields;
+        const char* position{begin};
+        for (int record = 0; record < SNIFFED_RECORDS && position < end;)
+        {
+            position = parser.parseRecord(position, end, fields);
+            // Last record of sample can be cut.
+            if (fields.isEmpty() || position == end)
+                continue;
+            ++recordsWithFieldsCount[fields.size()];
+            ++record;
+        }
+
+        if (recordsWithFieldsCount.size() != 1)
+            continue;
+        const int fieldsCount{recordsWithFieldsCount.firstKey()};
+        if (fieldsCount > bestFieldsCount)
+        {
+            bestFieldsCount = fieldsCount;
+            bestSeparator = separator;
+        }
+    }
+    return {bestSeparator, quote};
+}
+
+char DsvParser::getSeparator() const { return separator_; }
+
+char DsvParser::getQuote() const { return quote_; }
+
+bool DsvParser::isEmptyLine(const char* data, const char* lineEnd)
+{
+    if (lineEnd == data || lineEnd[-1] == '\n')
+        return true;
+    return lineEnd[-1] == '\r' && (lineEnd - 1 == data || lineEnd[-2] == '\n');
+}
+
+DsvParser::State DsvParser::nextState(State state, char character) const
+{
+    if (state == QUOTED_FIELD)
+        return character == quote_ ? AFTER_CLOSING_QUOTE : QUOTED_FIELD;
+
+    if (character == separator_ || character == '\n')
+        return FIELD_START;
+
+    // Quote after closing one is doubled quote inside of quoted field.
+    if (character == quote_ && quote_ != '\0' &&
+        (state == FIELD_START || state == AFTER_CLOSING_QUOTE))
+        return QUOTED_FIELD;
+    return UNQUOTED_FIELD;
+}
+
+bool DsvParser::isQuoteUsed(char quote, const QByteArray& separators,
+                            const char* begin, const char* end)
+{
+    // Quote is used when some field both starts and ends with it.
+    for (const char* position = begin; position < end; ++position)
+    {
+        const bool fieldStart{position == begin || position[-1] == '\n' ||
+                              separators.contains(position[-1])};
+        if (*position != quote || !fieldStart)
+            continue;
+
+        // Doubled quotes inside of field are skipped.
+        const char* closing{std::find(position + 1, end, quote)};
+        while (end - closing > 1 && closing[1] == quote)
+            closing = std::find(closing + 2, end, quote);
+        if (closing == end)
+            return false;
+
+        const char* next{closing + 1};
+        if (next == end || *next == '\n' || *next == '\r' ||
+            separators.contains(*next))
+            return true;
+        position = closing;
+    }
+    return false;
+}
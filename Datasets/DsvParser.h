@@ -0,0 +1,107 @@
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * @class DsvParser
+ * @brief Parser of delimiter separated values.
+ *
+ * Fields can be enclosed in quotes, quotes inside such fields are doubled.
+ * Quote starts quoted field only at beginning of field, elsewhere it is
+ * part of value. Records end with \n or \r\n and span several lines when
+ * line break is quoted. Empty lines are skipped.
+ */
+class DsvParser
+{
+public:
+    /// Quoting state at position in data.
+    enum State
+    {
+        FIELD_START,
+        UNQUOTED_FIELD,
+        QUOTED_FIELD,
+        AFTER_CLOSING_QUOTE,
+        STATES_COUNT
+    };
+
+    /**
+     * @brief Record ends found in part of data. Record ends and state at end
+     * of part are given for each state part can start in.
+     */
+    struct Scan
+    {
+        qint64 records_[STATES_COUNT]{0, 0, 0, 0};
+        qint64 firstRecordEnd_[STATES_COUNT]{-1, -1, -1, -1};
+        State endState_[STATES_COUNT]{FIELD_START, UNQUOTED_FIELD,
+                                      QUOTED_FIELD, AFTER_CLOSING_QUOTE};
+    };
+
+    /**
+     * @brief Constructor.
+     * @param separator Field separator.
+     * @param quote Quote character, zero when fields are not quoted.
+     */
+    DsvParser(char separator, char quote);
+
+    /**
+     * @brief Parse single record.
+     * @param begin Beginning of record.
+     * @param end End of data.
+     * @param fields Fields of record, empty for empty line. Unquoted fields
+     * refer to parsed data.
+     * @return Beginning of next record.
+     */
+    const char* parseRecord(const char* begin, const char* end,
+                            QVector<QByteArray>& fields) const;
+
+    /**
+     * @brief Count record ends in part of data.
+     * @param data Beginning of whole data.
+     * @param begin Beginning of part.
+     * @param end End of part.
+     * @return Scan of part with offsets relative to beginning of data.
+     */
+    Scan scan(const char* data, const char* begin, const char* end) const;
+
+    /**
+     * @brief Find end of last complete record.
+     * @param begin Beginning of record.
+     * @param end End of data.
+     * @return Position after line break ending last complete record, begin
+     * when there is no complete record.
+     */
+    const char* findLastRecordEnd(const char* begin, const char* end) const;
+
+    /**
+     * @brief Guess separator and quote character using beginning of data.
+     * @param begin Beginning of data.
+     * @param end End of sample.
+     * @return Parser for guessed format.
+     */
+    static DsvParser sniff(const char* begin, const char* end);
+
+    char getSeparator() const;
+
+    char getQuote() const;
+
+private:
+    static bool isEmptyLine(const char* data, const char* lineEnd);
+
+    /**
+     * @brief Get state after character, same way as parseRecord reads it.
+     * @param state State before character.
+     * @param character Character of data.
+     * @return State after character, FIELD_START after end of record.
+     */
+    State nextState(State state, char character) const;
+
+    static bool isQuoteUsed(char quote, const QByteArray& separators,
+                            const char* begin, const char* end);
+
+    char separator_;
+
+    char quote_;
+
+    static constexpr int SNIFFED_RECORDS{50};
+};
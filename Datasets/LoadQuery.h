@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QStringList>
+#include <QVector>
+
+typedef int Column;
+
+/**
+ * @brief Range of accepted values in numeric or date column used while
+ * loading. Dates are given as julian days.
+ */
+struct RangePredicate
+{
+    Column column_{0};
+    double min_{0.};
+    double max_{0.};
+};
+
+/**
+ * @brief Accepted values of string column used while loading.
+ */
+struct StringPredicate
+{
+    Column column_{0};
+    QStringList acceptedStrings_{};
+};
+
+/**
+ * @brief Part of rows to load.
+ */
+enum class LoadMode : unsigned char
+{
+    ALL_ROWS = 0,
+    ROW_RANGE,
+    RANDOM_SAMPLE
+};
+
+/**
+ * @brief Description of data to load: projection of columns, conditions
+ * rows need to meet and part of rows to take. Range is applied to rows of
+ * source, sample is drawn from rows matching predicates. Columns used in
+ * predicates need to be active.
+ */
+struct LoadQuery
+{
+    /// Flags of columns to load. Empty means currently set active columns.
+    QVector<bool> activeColumns_{};
+
+    /// Ranges of accepted values in numeric and date columns.
+    QVector<RangePredicate> rangePredicates_{};
+
+    /// Accepted values in string columns.
+    QVector<StringPredicate> stringPredicates_{};
+
+    /// Load all rows, range of rows or uniform random sample of rows.
+    LoadMode mode_{LoadMode::ALL_ROWS};
+
+    /// First row of range, counted from 0.
+    unsigned int firstRow_{0};
+
+    /// Number of rows in range or in sample.
+    unsigned int rowLimit_{0};
+
+    bool hasPredicates() const
+    {
+        return !rangePredicates_.isEmpty() || !stringPredicates_.isEmpty();
+    }
+
+    bool isPartial() const { return mode_ != LoadMode::ALL_ROWS; }
+};
@@ -0,0 +1,341 @@
+#include "XlsxSheetParser.h"
+
+#include <QByteArray>
+#include <QDate>
+#include <QLocale>
+#include <QXmlStreamReader>
+
+#include <MemoryUtilities.h>
+
+XlsxSheetParser::XlsxSheetParser(QVector<bool> dateStyles, bool withHeader)
+    : dateStyles_(std::move(dateStyles)),
+      continuation_(!withHeader),
+      headerRead_(!withHeader)
+{
+}
+
+bool XlsxSheetParser::parse(QXmlStreamReader& reader)
+{
+    while (!reader.atEnd())
+    {
+        switch (reader.readNext())
+        {
+            case QXmlStreamReader::StartElement:
+                startElement(reader);
+                break;
+            case QXmlStreamReader::EndElement:
+                endElement(reader);
+                break;
+            case QXmlStreamReader::Characters:
+                if (inCellText_)
+                    cell_.text_.append(reader.text());
+                break;
+            default:
+                break;
+        }
+    }
+
+    return !reader.hasError();
+}
+
+bool XlsxSheetParser::parseRows(const QByteArray& rows)
+{
+    // Rows are wrapped in root element. Namespaces are declared in cut off
+    // worksheet element, so their processing is disabled.
+    QXmlStreamReader reader;
+    reader.setNamespaceProcessing(false);
+    reader.addData(QByteArrayLiteral("<sheetData>"));
+    reader.addData(rows);
+    reader.addData(QByteArrayLiteral("</sheetData>"));
+    return parse(reader);
+}
+
+void XlsxSheetParser::append(XlsxSheetParser&& other)
+{
+    // Rows skipped between parts of one sheet are empty rows.
+    if (other.continuation_ && lastRowNumber_ > 0 &&
+        other.firstRowNumber_ > lastRowNumber_ + 1)
+        rowCount_ += other.firstRowNumber_ - lastRowNumber_ - 1;
+    if (other.lastRowNumber_ > 0)
+        lastRowNumber_ = other.lastRowNumber_;
+    if (firstRowNumber_ == 0)
+        firstRowNumber_ = other.firstRowNumber_;
+
+    addColumnsUpTo(other.getColumnCount() - 1);
+    for (int column = 0; column < getColumnCount(); ++column)
+    {
+        QVector<QVariant>& values{columns_[column]};
+        values.resize(rowCount_);
+        if (column >= other.getColumnCount())
+        {
+            values.resize(rowCount_ + other.rowCount_);
+            continue;
+        }
+
+        const ColumnType otherType{other.columnTypes_[column]};
+        ColumnType& columnType{columnTypes_[column]};
+        if (columnType == ColumnType::UNKNOWN)
+            columnType = otherType;
+        if (otherType != ColumnType::UNKNOWN && otherType != columnType)
+        {
+            if (columnType != ColumnType::STRING)
+                widenToString(column);
+            if (otherType != ColumnType::STRING)
+                other.widenToString(column);
+        }
+
+        QVector<QVariant>& otherValues{other.columns_[column]};
+        otherValues.resize(other.rowCount_);
+        values.append(otherValues);
+        otherValues.clear();
+    }
+    rowCount_ += other.rowCount_;
+}
+
+int XlsxSheetParser::getColumnCount() const { return columns_.size(); }
+
+int XlsxSheetParser::getRowCount() const { return rowCount_; }
+
+const QVector<QVariant>& XlsxSheetParser::getHeader() const
+{
+    return header_;
+}
+
+QVector<ColumnType> XlsxSheetParser::getColumnTypes() const
+{
+    QVector<ColumnType> columnTypes{columnTypes_};
+    for (auto& columnType : columnTypes)
+        if (columnType == ColumnType::UNKNOWN)
+            columnType = ColumnType::STRING;
+    return columnTypes;
+}
+
+const QVector<QVariant>& XlsxSheetParser::getColumn(int column) const
+{
+    return columns_[column];
+}
+
+QVector<QVariant> XlsxSheetParser::takeColumn(int column)
+{
+    return std::move(columns_[column]);
+}
+
+quint64 XlsxSheetParser::getUsedMemory() const
+{
+    quint64 usedMemory{MemoryUtilities::getVectorMemory(header_) +
+                       MemoryUtilities::getVectorMemory(columns_)};
+    for (const auto& values : columns_)
+        usedMemory += MemoryUtilities::getVectorMemory(values);
+    return usedMemory;
+}
+
+bool XlsxSheetParser::isDateFormat(const QString& formatCode)
+{
+    bool day{false};
+    bool month{false};
+    bool year{false};
+    bool quoted{false};
+    bool bracketed{false};
+    // Quoted text, escaped, padding or repeated characters and bracketed
+    // colors, locales or elapsed times are not date parts.
+    for (int i = 0; i < formatCode.size(); ++i)
+    {
+        const QChar character{formatCode[i].toLower()};
+        if (character == QLatin1Char('"'))
+            quoted = !quoted;
+        else if (quoted)
+            continue;
+        else if (character == QLatin1Char('[') ||
+                 character == QLatin1Char(']'))
+            bracketed = (character == QLatin1Char('['));
+        else if (bracketed)
+            continue;
+        else if (character == QLatin1Char('\\') ||
+                 character == QLatin1Char('_') || character == QLatin1Char('*'))
+            ++i;
+        else
+        {
+            day = day || character == QLatin1Char('d');
+            month = month || character == QLatin1Char('m');
+            year = year || character == QLatin1Char('y');
+        }
+    }
+    return (day && month) || (month && year) || (day && year);
+}
+
+void XlsxSheetParser::startElement(const QXmlStreamReader& reader)
+{
+    const QStringRef name{reader.name()};
+    if (name == QLatin1String("row"))
+    {
+        openRow(reader);
+        return;
+    }
+
+    if (name == QLatin1String("c"))
+    {
+        const QXmlStreamAttributes attributes{reader.attributes()};
+        const QStringRef reference{attributes.value(QLatin1String("r"))};
+        cell_ = Cell();
+        cell_.column_ =
+            (reference.isEmpty() ? nextColumn_ : getColumnIndex(reference));
+        cell_.type_ = attributes.value(QLatin1String("t")).toString();
+        cell_.style_ = attributes.value(QLatin1String("s")).toInt();
+        nextColumn_ = cell_.column_ + 1;
+        return;
+    }
+
+    if (name == QLatin1String("rPh"))
+    {
+        inPhonetic_ = true;
+        return;
+    }
+
+    // Inline strings keep text in nested <t> elements, others in <v>.
+    if (!inPhonetic_ &&
+        (name == QLatin1String("v") || name == QLatin1String("t")))
+    {
+        inCellText_ = true;
+        cell_.valueFound_ = true;
+    }
+}
+
+void XlsxSheetParser::endElement(const QXmlStreamReader& reader)
+{
+    const QStringRef name{reader.name()};
+    if (name == QLatin1String("v") || name == QLatin1String("t"))
+        inCellText_ = false;
+    else if (name == QLatin1String("rPh"))
+        inPhonetic_ = false;
+    else if (name == QLatin1String("c"))
+        closeCell();
+    else if (name == QLatin1String("row"))
+        closeRow();
+}
+
+void XlsxSheetParser::closeCell()
+{
+    const QString& text{cell_.text_};
+    const QString& type{cell_.type_};
+    if (!cell_.valueFound_ ||
+        (text.isEmpty() && type != QLatin1String("inlineStr")))
+        return;
+
+    const int column{cell_.column_};
+    addColumnsUpTo(column);
+    if (!headerRead_)
+    {
+        if (header_.size() <= column)
+            header_.resize(column + 1);
+        header_[column] = (type == QLatin1String("s") ? QVariant(text.toInt())
+                                                      : QVariant(text));
+        return;
+    }
+
+    if (type == QLatin1String("s"))
+        setValue(column, ColumnType::STRING, QVariant(text.toInt()));
+    else if (type == QLatin1String("str") || type == QLatin1String("e") ||
+             type == QLatin1String("b") || type == QLatin1String("inlineStr"))
+        setValue(column, ColumnType::STRING, QVariant(text));
+    else if (cell_.style_ < dateStyles_.size() && dateStyles_[cell_.style_])
+        setValue(column, ColumnType::DATE,
+                 QVariant(dateFromSerial(text.toDouble())));
+    else
+        setValue(column, ColumnType::NUMBER, QVariant(text.toDouble()));
+}
+
+void XlsxSheetParser::addColumnsUpTo(int column)
+{
+    while (columns_.size() <= column)
+    {
+        columns_.append(QVector<QVariant>(rowCount_));
+        columnTypes_.append(ColumnType::UNKNOWN);
+    }
+}
+
+void XlsxSheetParser::setValue(int column, ColumnType type, QVariant value)
+{
+    ColumnType& columnType{columnTypes_[column]};
+    if (columnType == ColumnType::UNKNOWN)
+        columnType = type;
+    if (columnType != type && columnType != ColumnType::STRING)
+        widenToString(column);
+    if (columnType == ColumnType::STRING && type != ColumnType::STRING)
+        value = (type == ColumnType::DATE
+                     ? QVariant(value.toDate().toString(Qt::ISODate))
+                     : QVariant(QString::number(
+                           value.toDouble(), 'g',
+                           QLocale::FloatingPointShortest)));
+
+    QVector<QVariant>& values{columns_[column]};
+    if (values.size() <= rowCount_)
+        values.resize(rowCount_ + 1);
+    values[rowCount_] = std::move(value);
+}
+
+void XlsxSheetParser::widenToString(int column)
+{
+    const ColumnType previousType{columnTypes_[column]};
+    columnTypes_[column] = ColumnType::STRING;
+    for (auto& value : columns_[column])
+    {
+        if (value.isNull())
+            continue;
+        if (previousType == ColumnType::DATE)
+            value = value.toDate().toString(Qt::ISODate);
+        else
+            value = QString::number(value.toDouble(), 'g',
+                                    QLocale::FloatingPointShortest);
+    }
+}
+
+void XlsxSheetParser::openRow(const QXmlStreamReader& reader)
+{
+    nextColumn_ = 0;
+    const QStringRef number{reader.attributes().value(QLatin1String("r"))};
+    if (!number.isEmpty())
+        rowNumber_ = number.toInt();
+    else
+        rowNumber_ = (lastRowNumber_ > 0 ? lastRowNumber_ + 1 : 0);
+
+    if (firstRowNumber_ == 0)
+        firstRowNumber_ = rowNumber_;
+
+    // Rows skipped in numbering are empty rows.
+    if (headerRead_ && lastRowNumber_ > 0 && rowNumber_ > lastRowNumber_ + 1)
+        rowCount_ += rowNumber_ - lastRowNumber_ - 1;
+}
+
+void XlsxSheetParser::closeRow()
+{
+    lastRowNumber_ = rowNumber_;
+    if (!headerRead_)
+    {
+        headerRead_ = true;
+        return;
+    }
+
+    ++rowCount_;
+    for (auto& values : columns_)
+        if (values.size() < rowCount_)
+            values.resize(rowCount_);
+}
+
+int XlsxSheetParser::getColumnIndex(const QStringRef& cellReference)
+{
+    int index{0};
+    for (const QChar character : cellReference)
+    {
+        if (!character.isLetter())
+            break;
+        const int letter{character.toUpper().unicode() - 'A' + 1};
+        index = index * LETTERS_COUNT + letter;
+    }
+    return index - 1;
+}
+
+QDate XlsxSheetParser::dateFromSerial(double serial)
+{
+    // Day 0 in spreadsheets is 30.12.1899 due to 1900 leap year bug.
+    return QDate(1899, 12, 30).addDays(static_cast<qint64>(serial));
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <ColumnType.h>
+#include <QVariant>
+#include <QVector>
+
+class QByteArray;
+class QXmlStreamReader;
+
+/**
+ * @class XlsxSheetParser
+ * @brief Parser of .xlsx sheet rows giving column types, row count and values
+ * in single pass.
+ *
+ * Values are stored per column and typed provisionally. When value of other
+ * type shows up in column, column is widened to string and values parsed so
+ * far are converted. Strings from shared strings are kept as indexes.
+ * Parts of sheet can be parsed separately and appended in row order. Rows
+ * skipped in row numbering are kept as empty rows.
+ */
+class XlsxSheetParser
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param dateStyles Flags indicating cell styles formatted as dates.
+     * @param withHeader First parsed row is header.
+     */
+    explicit XlsxSheetParser(QVector<bool> dateStyles, bool withHeader = true);
+
+    /**
+     * @brief Parse complete rows cut out of sheet xml. First row is used as
+     * header when parser was created with header.
+     * @param rows Consecutive <row> elements.
+     * @return True if succeed, false otherwise.
+     */
+    bool parseRows(const QByteArray& rows);
+
+    /**
+     * @brief Append rows parsed by other parser. Columns of different types
+     * are widened to string.
+     * @param other Parser of rows following rows of this parser.
+     */
+    void append(XlsxSheetParser&& other);
+
+    /**
+     * @brief Get number of columns found in sheet.
+     * @return Number of columns.
+     */
+    int getColumnCount() const;
+
+    /**
+     * @brief Get number of rows without header.
+     * @return Number of rows.
+     */
+    int getRowCount() const;
+
+    /**
+     * @brief Get cells of header, string or shared string index.
+     * @return Header cells.
+     */
+    const QVector<QVariant>& getHeader() const;
+
+    /**
+     * @brief Get inferred column types. Empty columns are strings.
+     * @return Column types.
+     */
+    QVector<ColumnType> getColumnTypes() const;
+
+    /**
+     * @brief Get values of given column.
+     * @param column Column index.
+     * @return Values of column, null for empty cells.
+     */
+    const QVector<QVariant>& getColumn(int column) const;
+
+    /**
+     * @brief Release values of given column.
+     * @param column Column index.
+     * @return Values of column, null for empty cells.
+     */
+    QVector<QVariant> takeColumn(int column);
+
+    /**
+     * @brief Get memory allocated for parsed values, without memory owned by
+     * strings.
+     * @return Allocated bytes.
+     */
+    quint64 getUsedMemory() const;
+
+    /**
+     * @brief Check if custom number format shows dates. Format needs at least
+     * two of day, month and year parts outside of literals and brackets.
+     * @param formatCode Code of number format.
+     * @return True if format shows dates, false otherwise.
+     */
+    static bool isDateFormat(const QString& formatCode);
+
+private:
+    /**
+     * @brief Cell being parsed.
+     */
+    struct Cell
+    {
+        int column_{0};
+        QString type_{};
+        int style_{0};
+        QString text_{};
+        bool valueFound_{false};
+    };
+
+    bool parse(QXmlStreamReader& reader);
+
+    void startElement(const QXmlStreamReader& reader);
+
+    void endElement(const QXmlStreamReader& reader);
+
+    void closeCell();
+
+    void addColumnsUpTo(int column);
+
+    void setValue(int column, ColumnType type, QVariant value);
+
+    void widenToString(int column);
+
+    void openRow(const QXmlStreamReader& reader);
+
+    void closeRow();
+
+    static int getColumnIndex(const QStringRef& cellReference);
+
+    static QDate dateFromSerial(double serial);
+
+    const QVector<bool> dateStyles_;
+
+    /// Parser of sheet part following other part, without header.
+    const bool continuation_;
+
+    bool headerRead_{false};
+
+    Cell cell_;
+
+    bool inCellText_{false};
+
+    /// Phonetic runs of inline strings are not part of value.
+    bool inPhonetic_{false};
+
+    /// Column of next cell when its reference is not given.
+    int nextColumn_{0};
+
+    QVector<QVariant> header_;
+
+    int rowCount_{0};
+
+    /// Sheet row numbers of current, first and last parsed rows, 0 if unknown.
+    int rowNumber_{0};
+    int firstRowNumber_{0};
+    int lastRowNumber_{0};
+
+    QVector<ColumnType> columnTypes_;
+
+    QVector<QVector<QVariant>> columns_;
+
+    static constexpr int LETTERS_COUNT{'Z' - 'A' + 1};
+};
@@ -0,0 +1,138 @@
+#include "CompressedSpool.h"
+
+#include <algorithm>
+
+#include <Qt5Quazip/quazip.h>
+#include <Qt5Quazip/quazipfile.h>
+
+CompressedSpool::CompressedSpool(int chunkSize)
+    : chunkSize_(chunkSize),
+      deflater_([this](const QByteArray& chunk) {
+          compressedChunkSizes_.append(chunk.size());
+          return file_.write(chunk) == chunk.size();
+      })
+{
+    success_ = file_.open();
+    buffer_.reserve(chunkSize_);
+}
+
+bool CompressedSpool::append(const QByteArray& data)
+{
+    buffer_.append(data);
+    if (buffer_.size() >= chunkSize_)
+        return flushBuffer();
+    return success_;
+}
+
+bool CompressedSpool::finish()
+{
+    return flushBuffer() && deflater_.finish();
+}
+
+bool CompressedSpool::writeAsZipEntry(QuaZip& zip, const QString& fileName)
+{
+    if (!success_ || !file_.seek(0))
+        return false;
+
+    QuaZipNewInfo info(fileName);
+    info.uncompressedSize = deflater_.getUncompressedSize();
+    QuaZipFile zipFile(&zip);
+    if (!zipFile.open(QIODevice::WriteOnly, info, nullptr, deflater_.getCrc(),
+                      Z_DEFLATED, Z_DEFAULT_COMPRESSION, true))
+        return false;
+
+    if (!copyCompressedStream(zipFile))
+        return false;
+
+    zipFile.close();
+    return zipFile.getZipError() == ZIP_OK;
+}
+
+bool CompressedSpool::writeAsContinuedZipEntry(QuaZip& zip,
+                                               const QString& fileName,
+                                               QuaZip& sourceZip)
+{
+    QuaZipFileInfo sourceInfo;
+    if (!success_ || !file_.seek(0) || !sourceZip.setCurrentFile(fileName) ||
+        !sourceZip.getCurrentFileInfo(&sourceInfo))
+        return false;
+
+    int method{0};
+    int level{0};
+    QuaZipFile sourceFile(&sourceZip);
+    if (!sourceFile.open(QIODevice::ReadOnly, &method, &level, true) ||
+        method != Z_DEFLATED)
+        return false;
+
+    // Streams of older files may end with data, those can not be continued.
+    const QByteArray closingBlock{
+        CompressionUtilities::deflateChunk({}, true).second.data_};
+    const qint64 chunksSize{static_cast<qint64>(sourceInfo.compressedSize) -
+                            closingBlock.size()};
+    if (chunksSize < 0)
+        return false;
+
+    QuaZipNewInfo info(fileName);
+    info.uncompressedSize = static_cast<qint64>(sourceInfo.uncompressedSize) +
+                            deflater_.getUncompressedSize();
+    const quint32 crc{CompressionUtilities::combineCrc(
+        sourceInfo.crc, deflater_.getCrc(), deflater_.getUncompressedSize())};
+    QuaZipFile zipFile(&zip);
+    if (!zipFile.open(QIODevice::WriteOnly, info, nullptr, crc, Z_DEFLATED,
+                      level, true))
+        return false;
+
+    for (qint64 copied = 0; copied < chunksSize;)
+    {
+        const QByteArray piece{
+            sourceFile.read(std::min<qint64>(CHUNK_SIZE, chunksSize - copied))};
+        if (piece.isEmpty() || zipFile.write(piece) != piece.size())
+            return false;
+        copied += piece.size();
+    }
+
+    if (sourceFile.read(closingBlock.size()) != closingBlock ||
+        !copyCompressedStream(zipFile))
+        return false;
+
+    zipFile.close();
+    return zipFile.getZipError() == ZIP_OK;
+}
+
+quint32 CompressedSpool::getCrc() const { return deflater_.getCrc(); }
+
+int CompressedSpool::getChunkCount() const { return chunkSizes_.size(); }
+
+const QVector<qint64>& CompressedSpool::getChunkSizes() const
+{
+    return chunkSizes_;
+}
+
+const QVector<qint64>& CompressedSpool::getCompressedChunkSizes() const
+{
+    return compressedChunkSizes_;
+}
+
+bool CompressedSpool::copyCompressedStream(QuaZipFile& zipFile)
+{
+    // Already compressed data is copied in pieces to keep memory bounded.
+    while (!file_.atEnd())
+    {
+        const QByteArray piece{file_.read(CHUNK_SIZE)};
+        if (piece.isEmpty() || zipFile.write(piece) != piece.size())
+            return false;
+    }
+    return true;
+}
+
+bool CompressedSpool::flushBuffer()
+{
+    if (!success_ || buffer_.isEmpty())
+        return success_;
+
+    chunkSizes_.append(buffer_.size());
+    success_ = deflater_.addChunk(buffer_);
+    buffer_ = QByteArray();
+    buffer_.reserve(chunkSize_);
+    return success_;
+}
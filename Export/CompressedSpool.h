@@ -0,0 +1,113 @@
+#pragma once
+
+#include <QByteArray>
+#include <QTemporaryFile>
+#include <QVector>
+
+#include "ParallelDeflater.h"
+
+class QuaZip;
+class QuaZipFile;
+
+/**
+ * @class CompressedSpool
+ * @brief Collects data in bounded buffers, compresses it in parallel and
+ * keeps compressed stream in temporary file until it can be stored as zip
+ * entry. Memory used does not depend on amount of data passed.
+ */
+class CompressedSpool
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param chunkSize Size of data compressed as one piece.
+     */
+    explicit CompressedSpool(int chunkSize = CHUNK_SIZE);
+
+    ~CompressedSpool() = default;
+
+    CompressedSpool& operator=(const CompressedSpool& other) = delete;
+    CompressedSpool(const CompressedSpool& other) = delete;
+
+    CompressedSpool& operator=(CompressedSpool&& other) = delete;
+    CompressedSpool(CompressedSpool&& other) = delete;
+
+    /**
+     * @brief Append data. Compression starts when buffer is full.
+     * @param data Data to append.
+     * @return True on success, false otherwise.
+     */
+    bool append(const QByteArray& data);
+
+    /**
+     * @brief Compress remaining data and close compressed stream.
+     * @return True on success, false otherwise.
+     */
+    bool finish();
+
+    /**
+     * @brief Store compressed stream as new entry of opened zip.
+     * @param zip Zip opened for writing.
+     * @param fileName Name of entry.
+     * @return True on success, false otherwise.
+     */
+    bool writeAsZipEntry(QuaZip& zip, const QString& fileName);
+
+    /**
+     * @brief Store compressed stream as entry continuing entry of same name
+     * from other zip. Compressed chunks of existing entry are copied without
+     * decompression, only block closing its stream is dropped.
+     * @param zip Zip opened for writing.
+     * @param fileName Name of entry.
+     * @param sourceZip Zip with existing entry opened for reading.
+     * @return True on success, false otherwise.
+     */
+    bool writeAsContinuedZipEntry(QuaZip& zip, const QString& fileName,
+                                  QuaZip& sourceZip);
+
+    /**
+     * @brief Get crc of data passed to spool.
+     * @return Crc of uncompressed data.
+     */
+    quint32 getCrc() const;
+
+    /**
+     * @brief Get number of chunks passed to compression so far.
+     * @return Number of chunks.
+     */
+    int getChunkCount() const;
+
+    /**
+     * @brief Get sizes of chunks before compression.
+     * @return Uncompressed sizes.
+     */
+    const QVector<qint64>& getChunkSizes() const;
+
+    /**
+     * @brief Get sizes of compressed chunks. Last one closes stream.
+     * @return Compressed sizes.
+     */
+    const QVector<qint64>& getCompressedChunkSizes() const;
+
+    /// Default approximate size of data compressed as one piece.
+    static constexpr int CHUNK_SIZE{1024 * 1024};
+
+private:
+    bool flushBuffer();
+
+    bool copyCompressedStream(QuaZipFile& zipFile);
+
+    const int chunkSize_;
+
+    QTemporaryFile file_;
+
+    ParallelDeflater deflater_;
+
+    QByteArray buffer_;
+
+    QVector<qint64> chunkSizes_;
+
+    QVector<qint64> compressedChunkSizes_;
+
+    bool success_{true};
+};
@@ -1,11 +1,18 @@
 #include "ExportVbx.h"
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
 #include <FilteringProxyModel.h>
 #include <Qt5Quazip/quazipfile.h>
 #include <QAbstractItemView>
+#include <QDataStream>
 #include <QFile>
 #include <QVariant>
 
+#include <Common/CompressionUtilities.h>
+#include <Common/DatasetIndex.h>
 #include <Common/DatasetUtilities.h>
 #include <ModelsAndViews/TableModel.h>
 #include <Shared/Logger.h>
@@ -14,14 +21,79 @@ ExportVbx::ExportVbx(QObject* parent) : ExportData(parent) {}
 
 bool ExportVbx::generateVbx(const QAbstractItemView& view, QIODevice& ioDevice)
 {
-    return exportView(view, ioDevice) && exportStrings(ioDevice) &&
-           exportDefinition(view, ioDevice);
+    resetExportState();
+    if (!compressRows(view, ioDevice))
+        return false;
+
+    QuaZip outZip(&ioDevice);
+    if (!outZip.open(QuaZip::mdCreate))
+        return false;
+
+    return dataSpool_->writeAsZipEntry(
+               outZip, DatasetUtilities::getDatasetDataFilename()) &&
+           stringsSpool_->writeAsZipEntry(
+               outZip, DatasetUtilities::getDatasetStringsFilename()) &&
+           exportDefinition(view, outZip, lines_) && exportRowGroups(outZip) &&
+           (!writeIndexes_ || exportIndexes(view, outZip));
 }
 
-bool ExportVbx::writeContent(const QByteArray& content, QIODevice& ioDevice)
+bool ExportVbx::appendVbx(const QAbstractItemView& view,
+                          QIODevice& existingVbx, QIODevice& ioDevice)
 {
-    return write(ioDevice, DatasetUtilities::getDatasetDataFilename(), content,
-                 QuaZip::mdCreate);
+    resetExportState();
+    QuaZip existingZip(&existingVbx);
+    if (!existingZip.open(QuaZip::mdUnzip))
+    {
+        LOG(LogTypes::IMPORT_EXPORT, "Can not open appended dataset.");
+        return false;
+    }
+
+    const auto [columnsMatch, existingRowCount] =
+        loadAppendedDefinition(view, existingZip);
+    if (!columnsMatch || !loadExistingStrings(existingZip) ||
+        !compressRows(view, ioDevice))
+        return false;
+
+    QuaZip outZip(&ioDevice);
+    if (!outZip.open(QuaZip::mdCreate))
+        return false;
+
+    if (!dataSpool_->writeAsContinuedZipEntry(
+            outZip, DatasetUtilities::getDatasetDataFilename(),
+            existingZip) ||
+        !stringsSpool_->writeAsContinuedZipEntry(
+            outZip, DatasetUtilities::getDatasetStringsFilename(),
+            existingZip))
+    {
+        LOG(LogTypes::IMPORT_EXPORT,
+            "Content of dataset can not be continued. Dataset needs to be "
+            "saved again before appending.");
+        return false;
+    }
+
+    // Indexes rank all rows, they are dropped and recomputed on opening.
+    return exportDefinition(view, outZip, existingRowCount + lines_) &&
+           exportAppendedRowGroups(
+               outZip, existingZip, existingRowCount,
+               static_cast<unsigned int>(view.model()->columnCount()));
+}
+
+void ExportVbx::setWriteIndexes(bool writeIndexes)
+{
+    writeIndexes_ = writeIndexes;
+}
+
+void ExportVbx::setSpoolChunkSize(int chunkSize)
+{
+    spoolChunkSize_ = chunkSize;
+}
+
+bool ExportVbx::writeContent([[maybe_unused]] const QByteArray& content,
+                             [[maybe_unused]] QIODevice& ioDevice)
+{
+    // Rows are streamed into spool while generated, content is empty. Zip
+    // is written once spools are finished.
+    return spoolsSuccess_;
 }
 
 QByteArray ExportVbx::getEmptyContent() { return QByteArrayLiteral(""); }
@@ -36,39 +108,396 @@ QByteArray ExportVbx::generateRowContent(const QAbstractItemModel& model,
                                          int row,
                                          [[maybe_unused]] int skippedRowsCount)
 {
+    currentRowKeys_.resize(model.columnCount());
+
     QByteArray rowContent;
     for (int j = 0; j < model.columnCount(); ++j)
     {
         QVariant actualField = model.index(row, j).data();
         if (!actualField.isNull())
             variantToString(actualField, rowContent, separator_);
+        currentRowKeys_[j] = getKey(actualField);
         if (j != model.columnCount() - 1)
             rowContent.append(separator_);
     }
 
+    // Only rows are remembered, keys are read again column by column when
+    // indexes are built.
+    if (writeIndexes_)
+    {
+        if (!exportedRows_.isEmpty() && exportedRows_.last().second == row - 1)
+            exportedRows_.last().second = row;
+        else
+            exportedRows_.append({row, row});
+    }
+
     rowContent.append(QByteArrayLiteral("\n"));
     lines_++;
 
-    return rowContent;
+    // Row goes straight to spool, so exportView() gathers no content.
+    spoolsSuccess_ = spoolsSuccess_ && dataSpool_->append(rowContent);
+    updateRowGroup();
+    return {};
 }
 
 QByteArray ExportVbx::getContentEnding() { return QByteArrayLiteral(""); }
 
-bool ExportVbx::exportStrings(QIODevice& ioDevice)
+bool ExportVbx::compressRows(const QAbstractItemView& view,
+                             QIODevice& ioDevice)
+{
+    const bool rowsExported{exportView(view, ioDevice)};
+    if (lines_ > groupFirstRow_)
+        closeRowGroup();
+
+    if (!rowsExported || !dataSpool_->finish() || !stringsSpool_->finish())
+    {
+        LOG(LogTypes::IMPORT_EXPORT, "Error while compressing data.");
+        return false;
+    }
+    return true;
+}
+
+bool ExportVbx::exportDefinition(const QAbstractItemView& view, QuaZip& zip,
+                                 unsigned int rowCount) const
+{
+    const TableModel* parentModel =
+        (qobject_cast<FilteringProxyModel*>(view.model()))->getParentModel();
+    QByteArray definitionContent{parentModel->definitionToXml(rowCount)};
+
+    return write(zip, DatasetUtilities::getDatasetDefinitionFilename(),
+                 definitionContent);
+}
+
+bool ExportVbx::exportIndexes(const QAbstractItemView& view,
+                              QuaZip& zip) const
+{
+    const QString fileName{DatasetUtilities::getDatasetIndexFilename()};
+    QuaZipFile zipFile(&zip);
+    if (!zipFile.open(QIODevice::WriteOnly, QuaZipNewInfo(fileName)))
+    {
+        LOG(LogTypes::IMPORT_EXPORT,
+            "Error while saving file " + fileName + ".");
+        return false;
+    }
+
+    // Index of each column is built and written before next one, so only
+    // keys of single column are kept in memory.
+    const QAbstractItemModel& model{*view.model()};
+    const TableModel* parentModel =
+        (qobject_cast<FilteringProxyModel*>(view.model()))->getParentModel();
+    QDataStream stream(&zipFile);
+    DatasetIndex::writeHeader(stream, dataSpool_->getCrc(), lines_,
+                              static_cast<unsigned int>(model.columnCount()));
+    QVector<quint32> stringsSortRanks;
+    for (int column = 0; column < model.columnCount(); ++column)
+        stream << buildColumnIndex(model, parentModel->getColumnFormat(column),
+                                   column, stringsSortRanks);
+
+    zipFile.close();
+    return stream.status() == QDataStream::Ok &&
+           zipFile.getZipError() == ZIP_OK;
+}
+
+double ExportVbx::getKey(const QVariant& field) const
+{
+    switch (field.type())
+    {
+        case QVariant::Date:
+        case QVariant::DateTime:
+            // Empty dates are sorted before all others.
+            return (field.isNull()
+                        ? std::numeric_limits<double>::lowest()
+                        : static_cast<double>(field.toDate().toJulianDay()));
+
+        case QVariant::String:
+            // Zone maps are used for numeric and date columns only.
+            return 0.;
+
+        default:
+            return field.toDouble();
+    }
+}
+
+QVector<double> ExportVbx::getColumnKeys(const QAbstractItemModel& model,
+                                         int column) const
+{
+    QVector<double> keys;
+    keys.reserve(static_cast<int>(lines_));
+    for (const auto& [firstRow, lastRow] : exportedRows_)
+    {
+        for (int row = firstRow; row <= lastRow; ++row)
+        {
+            const QVariant field{model.index(row, column).data()};
+            if (field.type() == QVariant::String)
+                keys.append(field.isNull() ? 0.
+                                           : stringsMap_.value(toStoredString(
+                                                 field.toString())));
+            else
+                keys.append(getKey(field));
+        }
+    }
+    return keys;
+}
+
+void ExportVbx::updateRowGroup()
+{
+    if (groupMin_.isEmpty())
+    {
+        groupMin_.fill(std::numeric_limits<double>::max(),
+                       currentRowKeys_.size());
+        groupMax_.fill(std::numeric_limits<double>::lowest(),
+                       currentRowKeys_.size());
+    }
+
+    for (int column = 0; column < currentRowKeys_.size(); ++column)
+    {
+        const double key{currentRowKeys_[column]};
+        if (key == std::numeric_limits<double>::lowest())
+            continue;
+        groupMin_[column] = std::min(groupMin_[column], key);
+        groupMax_[column] = std::max(groupMax_[column], key);
+    }
+
+    // Spool compresses rows in chunks, each chunk becomes row group.
+    if (dataSpool_->getChunkCount() > rowGroups_.size())
+        closeRowGroup();
+}
+
+void ExportVbx::closeRowGroup()
 {
-    return write(ioDevice, DatasetUtilities::getDatasetStringsFilename(),
-                 stringsContent_, QuaZip::mdAdd);
+    RowGroup group;
+    group.firstRow_ = groupFirstRow_;
+    group.rowCount_ = lines_ - groupFirstRow_;
+    group.min_ = groupMin_;
+    group.max_ = groupMax_;
+    rowGroups_.append(group);
+
+    groupFirstRow_ = lines_;
+    groupMin_.clear();
+    groupMax_.clear();
 }
 
-bool ExportVbx::exportDefinition(const QAbstractItemView& view,
-                                 QIODevice& ioDevice) const
+bool ExportVbx::fillRowGroupsPositions()
 {
+    const QVector<qint64>& chunkSizes{dataSpool_->getChunkSizes()};
+    const QVector<qint64>& compressedSizes{
+        dataSpool_->getCompressedChunkSizes()};
+    if (chunkSizes.size() != rowGroups_.size() ||
+        compressedSizes.size() < rowGroups_.size())
+        return false;
+
+    qint64 compressedOffset{0};
+    for (int i = 0; i < rowGroups_.size(); ++i)
+    {
+        rowGroups_[i].compressedOffset_ = compressedOffset;
+        rowGroups_[i].compressedSize_ = compressedSizes[i];
+        rowGroups_[i].uncompressedSize_ = chunkSizes[i];
+        compressedOffset += compressedSizes[i];
+    }
+    return true;
+}
+
+bool ExportVbx::exportRowGroups(QuaZip& zip)
+{
+    if (!fillRowGroupsPositions())
+        return true;
+
+    return write(zip, DatasetUtilities::getDatasetRowGroupsFilename(),
+                 DatasetIndex::rowGroupsToByteArray(dataSpool_->getCrc(),
+                                                    rowGroups_));
+}
+
+std::tuple<bool, unsigned int> ExportVbx::loadAppendedDefinition(
+    const QAbstractItemView& view, QuaZip& existingZip) const
+{
+    const auto [definitionRead, definitionContent] =
+        read(existingZip, DatasetUtilities::getDatasetDefinitionFilename());
+    if (!definitionRead)
+        return {false, 0};
+
     const TableModel* parentModel =
         (qobject_cast<FilteringProxyModel*>(view.model()))->getParentModel();
-    QByteArray definitionContent{parentModel->definitionToXml(lines_)};
+    const auto [columnsMatch, rowCount] =
+        parentModel->matchDefinitionXml(definitionContent);
+    if (!columnsMatch)
+        LOG(LogTypes::IMPORT_EXPORT,
+            "Columns of appended data differ from columns of dataset.");
+    return {columnsMatch, rowCount};
+}
 
-    return write(ioDevice, DatasetUtilities::getDatasetDefinitionFilename(),
-                 definitionContent, QuaZip::mdAdd);
+bool ExportVbx::loadExistingStrings(QuaZip& existingZip)
+{
+    const auto [stringsRead, stringsContent] =
+        read(existingZip, DatasetUtilities::getDatasetStringsFilename());
+    if (!stringsRead)
+        return false;
+
+    // Only strings table is read, new strings get next free indexes.
+    stringsMap_.clear();
+    nextIndex_ = 1;
+    if (stringsContent.isEmpty())
+        return true;
+
+    for (const QByteArray& string : stringsContent.split(newLine_))
+    {
+        const QString key{QString::fromUtf8(string)};
+        if (!stringsMap_.contains(key))
+            stringsMap_.insert(key, nextIndex_);
+        nextIndex_++;
+    }
+    return true;
+}
+
+bool ExportVbx::exportAppendedRowGroups(QuaZip& zip, QuaZip& existingZip,
+                                        unsigned int existingRowCount,
+                                        unsigned int columnCount)
+{
+    // Row groups are optional, without them all rows are parsed on loading.
+    QuaZipFileInfo dataFileInfo;
+    if (!fillRowGroupsPositions() ||
+        !existingZip.setCurrentFile(
+            DatasetUtilities::getDatasetDataFilename()) ||
+        !existingZip.getCurrentFileInfo(&dataFileInfo))
+        return true;
+
+    const auto [groupsRead, groupsContent] =
+        read(existingZip, DatasetUtilities::getDatasetRowGroupsFilename());
+    auto [valid, groups] = DatasetIndex::rowGroupsFromByteArray(
+        groupsContent, dataFileInfo.crc, existingRowCount, columnCount);
+    if (!groupsRead || !valid)
+        return true;
+
+    // New chunks start where last existing chunk ends.
+    const qint64 compressedOffset{
+        groups.isEmpty()
+            ? 0
+            : groups.last().compressedOffset_ + groups.last().compressedSize_};
+    for (RowGroup group : rowGroups_)
+    {
+        group.firstRow_ += existingRowCount;
+        group.compressedOffset_ += compressedOffset;
+        groups.append(group);
+    }
+
+    const QVector<qint64>& chunkSizes{dataSpool_->getChunkSizes()};
+    const quint32 crc{CompressionUtilities::combineCrc(
+        dataFileInfo.crc, dataSpool_->getCrc(),
+        std::accumulate(chunkSizes.constBegin(), chunkSizes.constEnd(),
+                        qint64{0}))};
+    return write(zip, DatasetUtilities::getDatasetRowGroupsFilename(),
+                 DatasetIndex::rowGroupsToByteArray(crc, groups));
+}
+
+ColumnIndex ExportVbx::buildColumnIndex(
+    const QAbstractItemModel& model, ColumnType columnType, int column,
+    QVector<quint32>& stringsSortRanks) const
+{
+    const double emptyDate{std::numeric_limits<double>::lowest()};
+    const QVector<double> keys{getColumnKeys(model, column)};
+    ColumnIndex index;
+    switch (columnType)
+    {
+        case ColumnType::NUMBER:
+        {
+            const auto [min, max] =
+                std::minmax_element(keys.constBegin(), keys.constEnd());
+            index.min_ = (keys.isEmpty() ? 0. : *min);
+            index.max_ = (keys.isEmpty() ? 0. : *max);
+            index.sortRanks_ = DatasetIndex::computeSortRanks(keys);
+            break;
+        }
+
+        case ColumnType::DATE:
+        {
+            QDate minDate;
+            QDate maxDate;
+            for (const double key : keys)
+            {
+                if (key == emptyDate)
+                {
+                    index.emptyValues_ = true;
+                    continue;
+                }
+                const QDate date{
+                    QDate::fromJulianDay(static_cast<qint64>(key))};
+                if (!minDate.isValid() || date < minDate)
+                    minDate = date;
+                if (!maxDate.isValid() || date > maxDate)
+                    maxDate = date;
+            }
+            index.min_ = minDate;
+            index.max_ = maxDate;
+            index.sortRanks_ = DatasetIndex::computeSortRanks(keys);
+            break;
+        }
+
+        case ColumnType::STRING:
+        {
+            if (stringsSortRanks.isEmpty())
+                stringsSortRanks = getStringsSortRanks();
+            QVector<int> counts(nextIndex_, 0);
+            index.sortRanks_.reserve(keys.size());
+            for (const double key : keys)
+            {
+                // Indexes are given in order of first occurrence in column,
+                // empty strings are skipped.
+                const int stringIndex{static_cast<int>(key)};
+                if (stringIndex > 0 && counts[stringIndex] == 0)
+                    index.distinctStrings_.append(stringIndex);
+                counts[stringIndex]++;
+                index.sortRanks_.append(stringsSortRanks[stringIndex]);
+            }
+            for (const int stringIndex : index.distinctStrings_)
+                index.distinctCounts_.append(counts[stringIndex]);
+            break;
+        }
+
+        case ColumnType::UNKNOWN:
+            break;
+    }
+    return index;
+}
+
+QVector<quint32> ExportVbx::getStringsSortRanks() const
+{
+    // Strings are compared in form in which they are saved.
+    QVector<QString> strings(nextIndex_);
+    for (auto it = stringsMap_.constBegin(); it != stringsMap_.constEnd(); ++it)
+        strings[it.value()] = it.key();
+
+    QVector<int> order(nextIndex_);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&strings](int left, int right) {
+                         return strings[left] < strings[right];
+                     });
+
+    QVector<quint32> ranks(nextIndex_);
+    quint32 rank{0};
+    for (int i = 0; i < order.size(); ++i)
+    {
+        if (i > 0 && strings[order[i - 1]] < strings[order[i]])
+            rank++;
+        ranks[order[i]] = rank;
+    }
+    return ranks;
+}
+
+void ExportVbx::resetExportState()
+{
+    // Object can be used for many exports, nothing is carried over.
+    stringsMap_.clear();
+    dataSpool_ = std::make_unique<CompressedSpool>(spoolChunkSize_);
+    stringsSpool_ = std::make_unique<CompressedSpool>(spoolChunkSize_);
+    spoolsSuccess_ = true;
+    exportedRows_.clear();
+    currentRowKeys_.clear();
+    rowGroups_.clear();
+    groupMin_.clear();
+    groupMax_.clear();
+    groupFirstRow_ = 0;
+    nextIndex_ = 1;
+    lines_ = 0;
 }
 
 void ExportVbx::variantToString(const QVariant& variant,
@@ -94,16 +523,18 @@ void ExportVbx::variantToString(const QVariant& variant,
 
         case QVariant::String:
         {
-            QString tmpString(variant.toString());
+            // Strings read from existing file are already in stored form.
+            const QString tmpString{toStoredString(variant.toString())};
             int& index = stringsMap_[tmpString];
             if (index == 0)
             {
                 index = nextIndex_;
-                tmpString.replace(newLine_, QLatin1String("\t"));
                 // No new line for first string.
-                if (nextIndex_ != 1)
-                    stringsContent_.append(newLine_);
-                stringsContent_.append(tmpString);
+                QByteArray stringEntry{nextIndex_ != 1 ? QByteArray(1, newLine_)
+                                                       : QByteArray()};
+                stringEntry.append(tmpString.toUtf8());
+                spoolsSuccess_ =
+                    spoolsSuccess_ && stringsSpool_->append(stringEntry);
                 nextIndex_++;
             }
             destinationArray.append(QByteArray::number(index));
@@ -118,15 +549,10 @@ void ExportVbx::variantToString(const QVariant& variant,
     }
 }
 
-bool ExportVbx::write(QIODevice& ioDevice, const QString& fileName,
-                      const QByteArray& data, QuaZip::Mode mode)
+bool ExportVbx::write(QuaZip& zip, const QString& fileName,
+                      const QByteArray& data)
 {
-    QuaZip outZip(&ioDevice);
-    bool openSuccess = outZip.open(mode);
-    if (!openSuccess)
-        return false;
-
-    QuaZipFile zipFile(&outZip);
+    QuaZipFile zipFile(&zip);
     bool result = zipFile.open(QIODevice::WriteOnly, QuaZipNewInfo(fileName));
     if (!result || zipFile.write(data) == -1)
     {
@@ -137,3 +563,22 @@ bool ExportVbx::write(QIODevice& ioDevice, const QString& fileName,
 
     return true;
 }
+
+std::tuple<bool, QByteArray> ExportVbx::read(QuaZip& zip,
+                                             const QString& fileName)
+{
+    QuaZipFile zipFile(&zip);
+    if (!zip.setCurrentFile(fileName) || !zipFile.open(QIODevice::ReadOnly))
+    {
+        LOG(LogTypes::IMPORT_EXPORT,
+            "Error while reading file " + fileName + ".");
+        return {false, {}};
+    }
+
+    return {true, zipFile.readAll()};
+}
+
+QString ExportVbx::toStoredString(QString string)
+{
+    return string.replace(newLine_, QLatin1String("\t"));
+}
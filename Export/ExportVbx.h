@@ -1,16 +1,26 @@
 #pragma once
 
+#include <memory>
+#include <tuple>
+#include <utility>
+
 #include <QVector>
 
+#include <ColumnType.h>
 #include <ExportData.h>
 #include <QHash>
 
 #include <Qt5Quazip/quazip.h>
 
+#include "CompressedSpool.h"
+
 class QAbstractItemModel;
 class QAbstractItemView;
 class QIODevice;
 class QuaZipFile;
+class TableModel;
+struct ColumnIndex;
+struct RowGroup;
 
 /**
  * @class ExportVbx
@@ -24,13 +34,41 @@ public:
     ~ExportVbx() override = default;
 
     /**
-     * @brief Generate inner Volbx format of data (.vbx).
+     * @brief Generate inner Volbx format of data (.vbx). Rows and strings are
+     * streamed through compressed spools, so no entry is kept whole in memory.
      * @param view View with selected data to export.
      * @param ioDevice Device to write to.
      * @return True on success, false otherwise.
      */
     bool generateVbx(const QAbstractItemView& view, QIODevice& ioDevice);
 
+    /**
+     * @brief Generate .vbx file containing rows of existing .vbx followed by
+     * rows of view. Only new rows and strings not stored yet are compressed,
+     * compressed content of existing file is copied as is. Columns of view
+     * need to match columns of existing file.
+     * @param view View with selected data to append.
+     * @param existingVbx Device with existing .vbx file.
+     * @param ioDevice Device to write to.
+     * @return True on success, false otherwise.
+     */
+    bool appendVbx(const QAbstractItemView& view, QIODevice& existingVbx,
+                   QIODevice& ioDevice);
+
+    /**
+     * @brief Enable storing of sort ranks, distinct values and ranges of
+     * columns, so they do not need to be recomputed when dataset is opened.
+     * @param writeIndexes Flag indicating indexes should be written.
+     */
+    void setWriteIndexes(bool writeIndexes);
+
+    /**
+     * @brief Set size of data compressed as one piece. Each piece of rows
+     * becomes row group.
+     * @param chunkSize Size of piece in bytes.
+     */
+    void setSpoolChunkSize(int chunkSize);
+
 protected:
     bool writeContent(const QByteArray& content, QIODevice& ioDevice) override;
 
@@ -44,20 +82,77 @@ protected:
     QByteArray getContentEnding() override;
 
 private:
+    void resetExportState();
+
     void variantToString(const QVariant& variant, QByteArray& destinationArray,
                          char separator);
 
-    bool exportStrings(QIODevice& ioDevice);
+    bool compressRows(const QAbstractItemView& view, QIODevice& ioDevice);
+
+    bool exportDefinition(const QAbstractItemView& view, QuaZip& zip,
+                          unsigned int rowCount) const;
+
+    bool exportIndexes(const QAbstractItemView& view, QuaZip& zip) const;
+
+    double getKey(const QVariant& field) const;
 
-    bool exportDefinition(const QAbstractItemView& view,
-                          QIODevice& ioDevice) const;
+    QVector<double> getColumnKeys(const QAbstractItemModel& model,
+                                  int column) const;
 
-    static bool write(QIODevice& ioDevice, const QString& fileName,
-                      const QByteArray& data, QuaZip::Mode mode);
+    void updateRowGroup();
+
+    void closeRowGroup();
+
+    bool fillRowGroupsPositions();
+
+    bool exportRowGroups(QuaZip& zip);
+
+    std::tuple<bool, unsigned int> loadAppendedDefinition(
+        const QAbstractItemView& view, QuaZip& existingZip) const;
+
+    bool loadExistingStrings(QuaZip& existingZip);
+
+    bool exportAppendedRowGroups(QuaZip& zip, QuaZip& existingZip,
+                                 unsigned int existingRowCount,
+                                 unsigned int columnCount);
+
+    ColumnIndex buildColumnIndex(const QAbstractItemModel& model,
+                                 ColumnType columnType, int column,
+                                 QVector<quint32>& stringsSortRanks) const;
+
+    QVector<quint32> getStringsSortRanks() const;
+
+    static bool write(QuaZip& zip, const QString& fileName,
+                      const QByteArray& data);
+
+    static std::tuple<bool, QByteArray> read(QuaZip& zip,
+                                             const QString& fileName);
+
+    static QString toStoredString(QString string);
 
     static constexpr char separator_{';'};
+
+    /// Indexes of strings in form in which they are stored.
     QHash<QString, int> stringsMap_;
-    QByteArray stringsContent_;
+    std::unique_ptr<CompressedSpool> dataSpool_{nullptr};
+    std::unique_ptr<CompressedSpool> stringsSpool_{nullptr};
+    int spoolChunkSize_{CompressedSpool::CHUNK_SIZE};
+    bool spoolsSuccess_{true};
+    bool writeIndexes_{false};
+
+    /// Ranges of exported rows of model, used to build indexes once rows
+    /// are streamed.
+    QVector<std::pair<int, int>> exportedRows_;
+
+    /// Values of last generated row used for indexes and zone maps.
+    QVector<double> currentRowKeys_;
+
+    /// Rows of each compressed chunk of data with their value ranges.
+    QVector<RowGroup> rowGroups_;
+
+    QVector<double> groupMin_;
+    QVector<double> groupMax_;
+    unsigned int groupFirstRow_{0};
     int nextIndex_{1};
     unsigned int lines_{0};
     static constexpr char newLine_{'\n'};
@@ -0,0 +1,60 @@
+#include "ParallelDeflater.h"
+
+#include <algorithm>
+
+#include <QThread>
+
+ParallelDeflater::ParallelDeflater(
+    std::function<bool(const QByteArray&)> consumer)
+    : consumer_(std::move(consumer)),
+      maxPendingChunks_(
+          static_cast<std::size_t>(std::max(1, QThread::idealThreadCount())))
+{
+}
+
+bool ParallelDeflater::addChunk(QByteArray chunk)
+{
+    if (pendingChunks_.size() >= maxPendingChunks_ && !consumeOldestChunk())
+        return false;
+
+    pendingChunks_.push_back(
+        std::async(std::launch::async, [data = std::move(chunk)]() {
+            return CompressionUtilities::deflateChunk(data, false);
+        }));
+    return success_;
+}
+
+bool ParallelDeflater::finish()
+{
+    // All futures need to be waited for, even after failure.
+    while (!pendingChunks_.empty())
+        consumeOldestChunk();
+
+    // Empty final block closes stream of fully flushed chunks.
+    return consume(CompressionUtilities::deflateChunk({}, true));
+}
+
+quint32 ParallelDeflater::getCrc() const { return crc_; }
+
+qint64 ParallelDeflater::getUncompressedSize() const
+{
+    return uncompressedSize_;
+}
+
+bool ParallelDeflater::consume(
+    const std::pair<bool, CompressionUtilities::DeflatedChunk>& deflatedChunk)
+{
+    const auto& [deflated, chunk] = deflatedChunk;
+    success_ = success_ && deflated && consumer_(chunk.data_);
+    crc_ = CompressionUtilities::combineCrc(crc_, chunk.crc_,
+                                            chunk.uncompressedSize_);
+    uncompressedSize_ += chunk.uncompressedSize_;
+    return success_;
+}
+
+bool ParallelDeflater::consumeOldestChunk()
+{
+    auto deflatedChunk{pendingChunks_.front().get()};
+    pendingChunks_.pop_front();
+    return consume(deflatedChunk);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <future>
+
+#include <Common/CompressionUtilities.h>
+
+/**
+ * @class ParallelDeflater
+ * @brief Compresses consecutive chunks of data using all available cores.
+ * Compressed chunks are passed to consumer in original order and together
+ * form single raw deflate stream.
+ */
+class ParallelDeflater
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param consumer Function receiving compressed chunks in original order.
+     */
+    explicit ParallelDeflater(std::function<bool(const QByteArray&)> consumer);
+
+    ~ParallelDeflater() = default;
+
+    ParallelDeflater& operator=(const ParallelDeflater& other) = delete;
+    ParallelDeflater(const ParallelDeflater& other) = delete;
+
+    ParallelDeflater& operator=(ParallelDeflater&& other) = delete;
+    ParallelDeflater(ParallelDeflater&& other) = delete;
+
+    /**
+     * @brief Queue chunk for compression. Each chunk is compressed by own
+     * task, at most one task per core is in flight. When limit is reached
+     * call blocks until oldest chunk is compressed and consumed.
+     * @param chunk Data to compress.
+     * @return True on success, false otherwise.
+     */
+    bool addChunk(QByteArray chunk);
+
+    /**
+     * @brief Wait for queued chunks and close deflate stream.
+     * @return True on success, false otherwise.
+     */
+    bool finish();
+
+    /**
+     * @brief Get crc of all data passed so far.
+     * @return Crc.
+     */
+    quint32 getCrc() const;
+
+    /**
+     * @brief Get size of all data passed so far.
+     * @return Size before compression.
+     */
+    qint64 getUncompressedSize() const;
+
+private:
+    bool consume(const std::pair<bool, CompressionUtilities::DeflatedChunk>&
+                     deflatedChunk);
+
+    bool consumeOldestChunk();
+
+    std::function<bool(const QByteArray&)> consumer_;
+
+    std::deque<
+        std::future<std::pair<bool, CompressionUtilities::DeflatedChunk>>>
+        pendingChunks_;
+
+    /// Limit of chunks compressed at the same time.
+    const std::size_t maxPendingChunks_;
+
+    quint32 crc_{0};
+
+    qint64 uncompressedSize_{0};
+
+    bool success_{true};
+};
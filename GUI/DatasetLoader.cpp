@@ -0,0 +1,142 @@
+#include "DatasetLoader.h"
+
+#include <ProgressBarCounter.h>
+#include <QPushButton>
+#include <QThread>
+#include <QVBoxLayout>
+
+#include <Common/Constants.h>
+#include <Datasets/Dataset.h>
+#include <ModelsAndViews/TableModel.h>
+#include <Shared/Logger.h>
+
+DatasetLoader::DatasetLoader(std::unique_ptr<Dataset> dataset,
+                             QObject* parent)
+    : QObject(parent),
+      dataset_(std::move(dataset)),
+      datasetName_(dataset_->getName()),
+      model_(new TableModel(*dataset_))
+{
+    qRegisterMetaType<QVector<QVector<QVariant>>>();
+    dataset_->setProgressiveLoading(true);
+    connect(dataset_.get(), &Dataset::rowsLoaded, this,
+            &DatasetLoader::appendLoadedRows, Qt::QueuedConnection);
+    connect(model_, &QObject::destroyed, this,
+            &DatasetLoader::modelDestroyed);
+
+    const QString barTitle{
+        Constants::getProgressBarTitle(Constants::BarTitle::LOADING)};
+    progressWindow_.setWindowTitle(barTitle);
+    progressWindow_.setWindowFlags(Qt::Tool | Qt::WindowTitleHint);
+
+    auto* layout{new QVBoxLayout(&progressWindow_)};
+    bar_ = new ProgressBarCounter(
+        barTitle, Constants::getProgressBarFullCounter(), &progressWindow_);
+    layout->addWidget(bar_);
+    cancelButton_ = new QPushButton(tr("Cancel"), &progressWindow_);
+    layout->addWidget(cancelButton_, 0, Qt::AlignHCenter);
+
+    connect(cancelButton_, &QPushButton::clicked, this,
+            &DatasetLoader::cancelClicked);
+
+    connect(&progressTimer_, &QTimer::timeout, this,
+            &DatasetLoader::updateProgress);
+}
+
+DatasetLoader::~DatasetLoader()
+{
+    if (thread_ != nullptr)
+    {
+        dataset_->cancelLoading();
+        thread_->wait();
+    }
+
+    if (model_ != nullptr && model_->parent() == nullptr)
+        delete model_;
+}
+
+void DatasetLoader::start()
+{
+    performanceTimer_.start();
+    progressWindow_.show();
+
+    thread_.reset(QThread::create([this]() { runLoading(); }));
+    connect(thread_.get(), &QThread::finished, this,
+            &DatasetLoader::threadFinished, Qt::QueuedConnection);
+    progressTimer_.start(PROGRESS_POLL_INTERVAL);
+    thread_->start();
+}
+
+DatasetLoader::Result DatasetLoader::getResult() const { return result_; }
+
+std::unique_ptr<Dataset> DatasetLoader::retrieveDataset()
+{
+    return std::move(dataset_);
+}
+
+TableModel* DatasetLoader::getModel() const { return model_; }
+
+const QString& DatasetLoader::getDatasetName() const { return datasetName_; }
+
+void DatasetLoader::runLoading()
+{
+    try
+    {
+        if (dataset_->loadData())
+            result_ = Result::LOADED;
+        else if (dataset_->isLoadingCancelled())
+            result_ = Result::CANCELLED;
+        else
+            result_ = Result::FAILED;
+    }
+    catch (std::bad_alloc&)
+    {
+        result_ = Result::OUT_OF_MEMORY;
+    }
+}
+
+void DatasetLoader::updateProgress()
+{
+    bar_->updateProgress(dataset_->getLoadingPercent());
+}
+
+void DatasetLoader::appendLoadedRows(const QVector<QVector<QVariant>>& rows)
+{
+    if (model_ == nullptr || thread_ == nullptr)
+        return;
+
+    const bool firstRows{model_->rowCount() == 0};
+    model_->appendLoadedRows(rows);
+    if (firstRows)
+        Q_EMIT firstRowsLoaded();
+}
+
+void DatasetLoader::modelDestroyed()
+{
+    // Tab showing rows was closed, loaded data would not be used.
+    if (thread_ != nullptr)
+        dataset_->cancelLoading();
+}
+
+void DatasetLoader::cancelClicked()
+{
+    cancelButton_->setEnabled(false);
+    dataset_->cancelLoading();
+}
+
+void DatasetLoader::threadFinished()
+{
+    thread_->wait();
+    thread_ = nullptr;
+    progressTimer_.stop();
+    progressWindow_.hide();
+
+    if (result_ == Result::LOADED)
+        LOG(LogTypes::IMPORT_EXPORT,
+            "Loaded file having " + QString::number(dataset_->rowCount()) +
+                " rows in time " +
+                Constants::timeFromTimeToSeconds(performanceTimer_) +
+                " seconds.");
+
+    Q_EMIT loadingFinished();
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <memory>
+
+#include <QObject>
+#include <QPointer>
+#include <QTime>
+#include <QTimer>
+#include <QWidget>
+
+class Dataset;
+class ProgressBarCounter;
+class QPushButton;
+class QThread;
+class TableModel;
+
+/**
+ * @brief Loads dataset on worker thread showing progress and cancel button.
+ * Rows loaded so far are appended to model which can be shown before end.
+ */
+class DatasetLoader : public QObject
+{
+    Q_OBJECT
+public:
+    enum class Result : unsigned char
+    {
+        LOADED = 0,
+        FAILED,
+        CANCELLED,
+        OUT_OF_MEMORY
+    };
+
+    explicit DatasetLoader(std::unique_ptr<Dataset> dataset,
+                           QObject* parent = nullptr);
+
+    ~DatasetLoader() override;
+
+    /**
+     * @brief Start loading on worker thread.
+     */
+    void start();
+
+    /**
+     * @brief Get result of loading, valid after loadingFinished().
+     * @return Result of loading.
+     */
+    Result getResult() const;
+
+    /**
+     * @brief Retrieve loaded dataset (dataset is moved).
+     * @return Dataset.
+     */
+    std::unique_ptr<Dataset> retrieveDataset();
+
+    /**
+     * @brief Get model filled with rows while loading.
+     * @return Model or nullptr when it was already deleted.
+     */
+    TableModel* getModel() const;
+
+    /**
+     * @brief Get name of loaded dataset.
+     * @return Dataset name.
+     */
+    const QString& getDatasetName() const;
+
+private:
+    void runLoading();
+
+    std::unique_ptr<Dataset> dataset_;
+
+    const QString datasetName_;
+
+    /// Owned by loader until it gets parent (tab showing it).
+    QPointer<TableModel> model_;
+
+    /// Written by worker thread, read after it finished.
+    Result result_{Result::FAILED};
+
+    /// Window with progress bar and cancel button.
+    QWidget progressWindow_;
+
+    ProgressBarCounter* bar_{nullptr};
+
+    QPushButton* cancelButton_{nullptr};
+
+    /// Polls progress published by dataset.
+    QTimer progressTimer_;
+
+    std::unique_ptr<QThread> thread_{nullptr};
+
+    QTime performanceTimer_;
+
+    static constexpr int PROGRESS_POLL_INTERVAL{50};
+
+private Q_SLOTS:
+    void updateProgress();
+
+    void appendLoadedRows(const QVector<QVector<QVariant>>& rows);
+
+    void modelDestroyed();
+
+    void cancelClicked();
+
+    void threadFinished();
+
+Q_SIGNALS:
+    /**
+     * Emitted in GUI thread when first rows were appended to model.
+     */
+    void firstRowsLoaded();
+
+    /**
+     * Emitted in GUI thread when loading ended or was cancelled.
+     */
+    void loadingFinished();
+};
@@ -19,9 +19,17 @@ FiltersDock::FiltersDock(QWidget* parent)
 
 void FiltersDock::addFiltersForModel(const FilteringProxyModel* model)
 {
-    if (model == nullptr)
+    if (model == nullptr || modelsMap_.key(model) != nullptr)
         return;
 
+    // Filters are built from profiles of columns computed after load.
+    if (!model->getParentModel()->isProfileReady())
+    {
+        addFiltersWhenProfileReady(model);
+        return;
+    }
+    pendingModels_.remove(model);
+
     auto* mainWidget{new QWidget()};
     modelsMap_[mainWidget] = model;
 
@@ -31,7 +39,21 @@ void FiltersDock::addFiltersForModel(const FilteringProxyModel* model)
     mainLayout->addWidget(createScrollAreaWithFilters(model, mainWidget));
 
     stackedWidget_.addWidget(mainWidget);
-    showFiltersForModel(model);
+    if (model == shownModel_ || stackedWidget_.count() == 1)
+        stackedWidget_.setCurrentWidget(mainWidget);
+}
+
+void FiltersDock::addFiltersWhenProfileReady(const FilteringProxyModel* model)
+{
+    if (pendingModels_.contains(model))
+        return;
+
+    pendingModels_.insert(model);
+    connect(model->getParentModel(), &TableModel::profileReady, this,
+            [this, model]() {
+                if (pendingModels_.contains(model))
+                    addFiltersForModel(model);
+            });
 }
 
 QWidget* FiltersDock::createFiltersWidgets(const FilteringProxyModel* model)
@@ -115,7 +137,7 @@ FilterStrings* FiltersDock::createStringsFilter(const TableModel* parentModel,
                                                 int index)
 {
     const QString columnName{getColumnName(parentModel, index)};
-    QStringList list{parentModel->getStringList(index)};
+    QStringList list{parentModel->getColumnProfile(index).strings_};
     const int itemCount{list.size()};
     list.sort();
     auto* filter{new FilterStrings(columnName, std::move(list))};
@@ -135,9 +157,10 @@ FilterDates* FiltersDock::createDatesFilter(const TableModel* parentModel,
                                             int index)
 {
     const QString columnName{getColumnName(parentModel, index)};
-    const auto [minDate, maxDate,
-                haveEmptyDates]{parentModel->getDateRange(index)};
-    auto* filter{new FilterDates(columnName, minDate, maxDate, haveEmptyDates)};
+    const ColumnProfile& profile{parentModel->getColumnProfile(index)};
+    auto* filter{new FilterDates(columnName, profile.min_.toDate(),
+                                 profile.max_.toDate(),
+                                 profile.emptyValues_ > 0)};
     auto emitChangeForColumn{[=](QDate from, QDate to, bool filterEmptyDates) {
         Q_EMIT filterDates(index, from, to, filterEmptyDates);
     }};
@@ -150,8 +173,9 @@ FilterNumbers* FiltersDock::createNumbersFilter(const TableModel* parentModel,
                                                 int index)
 {
     const QString columnName{getColumnName(parentModel, index)};
-    const auto [min, max]{parentModel->getNumericRange(index)};
-    auto* filter{new FilterDoubles(columnName, min, max)};
+    const ColumnProfile& profile{parentModel->getColumnProfile(index)};
+    auto* filter{new FilterDoubles(columnName, profile.min_.toDouble(),
+                                   profile.max_.toDouble())};
     auto emitChangeForColumn{
         [=](double from, double to) { Q_EMIT filterNumbers(index, from, to); }};
     connect(filter, &FilterDoubles::newNumericFilter, this,
@@ -162,10 +186,14 @@ FilterNumbers* FiltersDock::createNumbersFilter(const TableModel* parentModel,
 
 void FiltersDock::removeFiltersForModel(const FilteringProxyModel* model)
 {
-    if (model == nullptr)
-        return;
+    pendingModels_.remove(model);
+    if (model == shownModel_)
+        shownModel_ = nullptr;
 
     QWidget* widgetToDelete{modelsMap_.key(model)};
+    if (widgetToDelete == nullptr)
+        return;
+
     modelsMap_.remove(widgetToDelete);
     stackedWidget_.removeWidget(widgetToDelete);
     delete widgetToDelete;
@@ -173,8 +201,10 @@ void FiltersDock::removeFiltersForModel(const FilteringProxyModel* model)
 
 void FiltersDock::showFiltersForModel(const FilteringProxyModel* model)
 {
-    if (model != nullptr)
-        stackedWidget_.setCurrentWidget(modelsMap_.key(model));
+    // Models of tabs still loading or profiling got no filters yet.
+    shownModel_ = model;
+    if (QWidget* filtersWidget{modelsMap_.key(model)}; filtersWidget != nullptr)
+        stackedWidget_.setCurrentWidget(filtersWidget);
 }
 
 void FiltersDock::searchTextChanged(const QString& arg1)
@@ -2,6 +2,7 @@
 
 #include <QDate>
 #include <QMap>
+#include <QSet>
 #include <QStackedWidget>
 
 #include "GUI/Dock.h"
@@ -33,6 +34,8 @@ public:
     void showFiltersForModel(const FilteringProxyModel* model);
 
 private:
+    void addFiltersWhenProfileReady(const FilteringProxyModel* model);
+
     FilterStrings* createStringsFilter(const TableModel* parentModel,
                                        int index);
 
@@ -55,6 +58,12 @@ private:
 
     QMap<QWidget*, const FilteringProxyModel*> modelsMap_;
 
+    /// Models waiting for profiles of columns to create filters.
+    QSet<const FilteringProxyModel*> pendingModels_;
+
+    /// Model of current tab.
+    const FilteringProxyModel* shownModel_{nullptr};
+
     QStackedWidget stackedWidget_;
 
 private Q_SLOTS:
@@ -0,0 +1,99 @@
+#include "MemoryUsage.h"
+
+#include <QTabWidget>
+
+#include <Common/MemoryBudget.h>
+#include <Common/MemoryUtilities.h>
+#include <ModelsAndViews/DataView.h>
+#include <ModelsAndViews/FilteringProxyModel.h>
+#include <ModelsAndViews/TableModel.h>
+
+#include "Tab.h"
+#include "ui_MemoryUsage.h"
+
+MemoryUsage::MemoryUsage(const QTabWidget& tabWidget, QWidget* parent)
+    : QDialog(parent), ui(new Ui::MemoryUsage), tabWidget_(tabWidget)
+{
+    ui->setupUi(this);
+
+    connect(ui->refresh, &QPushButton::clicked, this, &MemoryUsage::refresh);
+    connect(ui->releaseCaches, &QPushButton::clicked, this,
+            &MemoryUsage::releaseCachesClicked);
+    connect(ui->close, &QPushButton::clicked, this, &MemoryUsage::accept);
+
+    setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint);
+
+    refresh();
+}
+
+MemoryUsage::~MemoryUsage() { delete ui; }
+
+void MemoryUsage::refresh()
+{
+    ui->usageTree->clear();
+    for (int i = 0; i < tabWidget_.count(); ++i)
+        if (const auto* tab{qobject_cast<const Tab*>(tabWidget_.widget(i))};
+            tab != nullptr)
+            ui->usageTree->addTopLevelItem(
+                createTabItem(*tab, tabWidget_.tabText(i)));
+    ui->usageTree->header()->resizeSections(QHeaderView::ResizeToContents);
+
+    const MemoryBudget& budget{MemoryBudget::getInstance()};
+    QString summary{
+        tr("Used: ") +
+        locale().formattedDataSize(
+            static_cast<qint64>(budget.getUsedMemory())) +
+        tr(", limit: ") +
+        locale().formattedDataSize(static_cast<qint64>(budget.getLimit()))};
+    if (const quint64 available{MemoryUtilities::getAvailableMemory()};
+        available != 0)
+        summary.append(
+            tr(", available: ") +
+            locale().formattedDataSize(static_cast<qint64>(available)));
+    ui->summary->setText(summary);
+}
+
+QTreeWidgetItem* MemoryUsage::createTabItem(const Tab& tab,
+                                            const QString& name) const
+{
+    const TableModel* model{tab.getCurrentTableModel()};
+    const FilteringProxyModel* proxyModel{tab.getCurrentProxyModel()};
+    const DataView* view{tab.getCurrentDataView()};
+    const PlotDataProvider& plotDataProvider{view->getPlotDataProvider()};
+
+    auto* dataItem{createItem(tr("Data"), model->getUsedMemory())};
+    for (int column = 0; column < model->columnCount(); ++column)
+        dataItem->addChild(createItem(
+            model->headerData(column, Qt::Horizontal).toString(),
+            model->getColumnUsedMemory(column)));
+    dataItem->addChild(
+        createItem(tr("Shared strings"), model->getStringsUsedMemory()));
+
+    const quint64 tabMemory{
+        model->getUsedMemory() + proxyModel->getUsedMemory() +
+        view->getUsedMemory() + plotDataProvider.getUsedMemory()};
+    auto* tabItem{createItem(name, tabMemory)};
+    tabItem->addChild(dataItem);
+    tabItem->addChild(
+        createItem(tr("Filtering and sorting"), proxyModel->getUsedMemory()));
+    tabItem->addChild(createItem(tr("Selection"), view->getUsedMemory()));
+    tabItem->addChild(
+        createItem(tr("Plots"), plotDataProvider.getUsedMemory()));
+    tabItem->setExpanded(true);
+    return tabItem;
+}
+
+QTreeWidgetItem* MemoryUsage::createItem(const QString& name,
+                                         quint64 bytes) const
+{
+    auto* item{new QTreeWidgetItem(
+        {name, locale().formattedDataSize(static_cast<qint64>(bytes))})};
+    item->setTextAlignment(1, Qt::AlignRight);
+    return item;
+}
+
+void MemoryUsage::releaseCachesClicked()
+{
+    MemoryBudget::getInstance().releaseCaches();
+    refresh();
+}
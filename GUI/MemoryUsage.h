@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QDialog>
+
+class QTabWidget;
+class QTreeWidgetItem;
+class Tab;
+
+namespace Ui
+{
+class MemoryUsage;
+}  // namespace Ui
+
+/**
+ * @brief Dialog showing memory used by each tab, its columns and views
+ * together with memory budget.
+ */
+class MemoryUsage : public QDialog
+{
+    Q_OBJECT
+public:
+    explicit MemoryUsage(const QTabWidget& tabWidget,
+                         QWidget* parent = nullptr);
+
+    ~MemoryUsage() override;
+
+private:
+    void refresh();
+
+    QTreeWidgetItem* createTabItem(const Tab& tab, const QString& name) const;
+
+    QTreeWidgetItem* createItem(const QString& name, quint64 bytes) const;
+
+    Ui::MemoryUsage* ui;
+
+    const QTabWidget& tabWidget_;
+
+private Q_SLOTS:
+    void releaseCachesClicked();
+};
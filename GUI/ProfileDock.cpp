@@ -0,0 +1,90 @@
+#include "ProfileDock.h"
+
+#include <algorithm>
+
+#include <QHeaderView>
+
+#include <ModelsAndViews/TableModel.h>
+
+ProfileDock::ProfileDock(const TableModel& model, QWidget* parent,
+                         Qt::WindowFlags flags)
+    : Dock(tr("Profiles"), parent, flags), model_(model), table_(this)
+{
+    table_.setColumnCount(7);
+    table_.setHorizontalHeaderLabels({tr("Column"), tr("Empty"),
+                                      tr("Distinct"), tr("Minimum"),
+                                      tr("Maximum"), tr("Most frequent"),
+                                      tr("Histogram")});
+    table_.setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table_.verticalHeader()->hide();
+    setWidget(&table_);
+
+    connect(&model_, &TableModel::profileReady, this, &ProfileDock::refresh);
+    refresh();
+}
+
+QString ProfileDock::formatValue(int column, const QVariant& value) const
+{
+    if (value.isNull())
+        return {};
+    if (model_.getColumnFormat(column) == ColumnType::DATE)
+        return locale().toString(value.toDate(), QLocale::ShortFormat);
+    if (model_.getColumnFormat(column) == ColumnType::NUMBER)
+        return locale().toString(value.toDouble());
+    return value.toString();
+}
+
+QString ProfileDock::formatTopValues(int column,
+                                     const ColumnProfile& profile) const
+{
+    QStringList topValues;
+    for (const auto& [value, count] : profile.topValues_)
+        topValues.append(formatValue(column, value) + " (" +
+                         QString::number(count) + ")");
+    return topValues.join(QStringLiteral(", "));
+}
+
+QString ProfileDock::formatHistogram(const ColumnProfile& profile)
+{
+    // Bars drawn with block characters of 8 heights.
+    const int highest{profile.histogram_.isEmpty()
+                          ? 0
+                          : *std::max_element(profile.histogram_.cbegin(),
+                                              profile.histogram_.cend())};
+    QString histogram;
+    for (const int count : profile.histogram_)
+    {
+        const int level{highest == 0 ? 0
+                                        : static_cast<int>(
+                                              static_cast<qint64>(count) *
+                                              7 / highest)};
+        histogram.append(QChar(0x2581 + level));
+    }
+    return histogram;
+}
+
+void ProfileDock::refresh()
+{
+    if (!model_.isProfileReady())
+    {
+        table_.setRowCount(0);
+        return;
+    }
+
+    table_.setRowCount(model_.columnCount());
+    for (int column = 0; column < model_.columnCount(); ++column)
+    {
+        const ColumnProfile& profile{model_.getColumnProfile(column)};
+        const QStringList texts{
+            model_.headerData(column, Qt::Horizontal).toString(),
+            QString::number(profile.emptyValues_),
+            QString::number(profile.distinctValues_),
+            formatValue(column, profile.min_),
+            formatValue(column, profile.max_),
+            formatTopValues(column, profile),
+            formatHistogram(profile)};
+        for (int i = 0; i < texts.size(); ++i)
+            table_.setItem(column, i, new QTableWidgetItem(texts[i]));
+    }
+    table_.resizeColumnsToContents();
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QTableWidget>
+
+#include "Dock.h"
+
+class TableModel;
+struct ColumnProfile;
+
+/**
+ * @brief Dock with profiles of columns of dataset, refreshed when model
+ * finishes profiling.
+ */
+class ProfileDock : public Dock
+{
+    Q_OBJECT
+public:
+    explicit ProfileDock(const TableModel& model, QWidget* parent = nullptr,
+                         Qt::WindowFlags flags = Qt::Widget);
+
+    ~ProfileDock() override = default;
+
+private:
+    QString formatValue(int column, const QVariant& value) const;
+
+    QString formatTopValues(int column, const ColumnProfile& profile) const;
+
+    static QString formatHistogram(const ColumnProfile& profile);
+
+    const TableModel& model_;
+
+    QTableWidget table_;
+
+private Q_SLOTS:
+    void refresh();
+};
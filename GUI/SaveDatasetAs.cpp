@@ -33,14 +33,22 @@ SaveDatasetAs::~SaveDatasetAs() { delete ui; }
 
 QString SaveDatasetAs::getDatasetName() { return ui->name->text(); }
 
+bool SaveDatasetAs::isAppendChosen() const { return appendChosen_; }
+
 bool SaveDatasetAs::overwriteDataset(const QString& name)
 {
     const QString title{QObject::tr("Overwrite dataset?")};
     const QString msg(QObject::tr("Dataset named ") + name +
-                      QObject::tr(" exist. Overwrite?"));
-    QMessageBox::StandardButton decision{QMessageBox::question(
-        this, title, msg, QMessageBox::Yes | QMessageBox::No)};
-    return decision == QMessageBox::Yes;
+                      QObject::tr(" exist. Overwrite or append rows?"));
+    QMessageBox question(QMessageBox::Question, title, msg,
+                         QMessageBox::Yes | QMessageBox::No, this);
+    const QAbstractButton* appendButton{
+        question.addButton(QObject::tr("Append"), QMessageBox::AcceptRole)};
+    question.exec();
+    appendChosen_ = (question.clickedButton() == appendButton);
+    return appendChosen_ ||
+           question.standardButton(question.clickedButton()) ==
+               QMessageBox::Yes;
 }
 
 bool SaveDatasetAs::nameIsUsed(const QString& name)
@@ -20,6 +20,12 @@ public:
 
     QString getDatasetName();
 
+    /**
+     * @brief Check if rows should be appended to existing dataset.
+     * @return True when user chose appending instead of overwriting.
+     */
+    bool isAppendChosen() const;
+
 private:
     bool overwriteDataset(const QString& name);
 
@@ -31,6 +37,8 @@ private:
 
     QStringList usedNames_;
 
+    bool appendChosen_{false};
+
 private Q_SLOTS:
     /**
      * @brief action on string/name change.
@@ -1,24 +1,32 @@
 #include "Tab.h"
 
-#include <Datasets/Dataset.h>
 #include <ModelsAndViews/DataView.h>
 #include <ModelsAndViews/FilteringProxyModel.h>
 #include <ModelsAndViews/TableModel.h>
 
 #include "DataViewDock.h"
+#include "ProfileDock.h"
 
-Tab::Tab(std::unique_ptr<Dataset> dataset, QWidget* parent)
+Tab::Tab(TableModel* model, const QString& name, QWidget* parent)
     : QMainWindow(parent)
 {
-    setWindowTitle(dataset->getName());
+    setWindowTitle(name);
 
     setDockNestingEnabled(true);
 
     auto* proxyModel{new FilteringProxyModel(this)};
-    auto* model{new TableModel(std::move(dataset), this)};
+    model->setParent(this);
     proxyModel->setSourceModel(model);
 
     addDockWidget(Qt::LeftDockWidgetArea, createDataViewDock(proxyModel));
+
+    auto* profileDock{new ProfileDock(*model, this)};
+    addDockWidget(Qt::BottomDockWidgetArea, profileDock);
+    profileDock->hide();
+
+    connect(model, &TableModel::aboutToHibernate, this,
+            &Tab::modelAboutToHibernate);
+    connect(model, &TableModel::wokenUp, this, &Tab::modelWokenUp);
 }
 
 FilteringProxyModel* Tab::getCurrentProxyModel() const
@@ -33,6 +41,8 @@ TableModel* Tab::getCurrentTableModel() const
 
 DataView* Tab::getCurrentDataView() const { return findChild<DataView*>(); }
 
+ProfileDock* Tab::getProfileDock() const { return findChild<ProfileDock*>(); }
+
 DataViewDock* Tab::createDataViewDock(FilteringProxyModel* proxyModel)
 {
     auto* dock{new DataViewDock(tr("Data"), this)};
@@ -41,3 +51,37 @@ DataViewDock* Tab::createDataViewDock(FilteringProxyModel* proxyModel)
     dock->setWidget(view);
     return dock;
 }
+
+void Tab::setActive(bool active)
+{
+    TableModel* model{getCurrentTableModel()};
+    if (active)
+    {
+        inactiveTimer_.invalidate();
+        model->wakeUp();
+    }
+    else if (!inactiveTimer_.isValid())
+    {
+        inactiveTimer_.start();
+    }
+    model->setHibernatable(!active);
+}
+
+qint64 Tab::getInactiveTime() const
+{
+    return inactiveTimer_.isValid() ? inactiveTimer_.elapsed() : 0;
+}
+
+void Tab::hibernate() { getCurrentTableModel()->hibernate(); }
+
+void Tab::modelAboutToHibernate()
+{
+    getCurrentProxyModel()->storeAcceptedRows();
+    getCurrentDataView()->storeSelection();
+}
+
+void Tab::modelWokenUp()
+{
+    getCurrentProxyModel()->applyStoredAcceptedRows();
+    getCurrentDataView()->restoreSelection();
+}
@@ -1,14 +1,13 @@
 #pragma once
 
-#include <memory>
-
+#include <QElapsedTimer>
 #include <QMainWindow>
 
-class Dataset;
 class TableModel;
 class DataView;
 class FilteringProxyModel;
 class DataViewDock;
+class ProfileDock;
 
 /**
  * @brief Tab containing models, view, dock widgets with data and plot.
@@ -17,7 +16,13 @@ class Tab : public QMainWindow
 {
     Q_OBJECT
 public:
-    explicit Tab(std::unique_ptr<Dataset> dataset, QWidget* parent = nullptr);
+    /**
+     * @brief Create tab for given model, tab takes ownership of it.
+     * @param model Model with data.
+     * @param name Name of dataset.
+     * @param parent Parent widget.
+     */
+    Tab(TableModel* model, const QString& name, QWidget* parent = nullptr);
 
     ~Tab() override = default;
 
@@ -27,6 +32,34 @@ public:
 
     DataView* getCurrentDataView() const;
 
+    ProfileDock* getProfileDock() const;
+
+    /**
+     * @brief Mark tab as shown or hidden. Shown tab is woken up, hidden one
+     * can be hibernated.
+     * @param active Flag indicating tab is shown.
+     */
+    void setActive(bool active);
+
+    /**
+     * @brief Get time since tab was hidden.
+     * @return Time in milliseconds, 0 for shown tab.
+     */
+    qint64 getInactiveTime() const;
+
+    /**
+     * @brief Move data of tab to spill file. Filters, sorting and selection
+     * are restored when tab is shown again.
+     */
+    void hibernate();
+
 private:
     DataViewDock* createDataViewDock(FilteringProxyModel* proxyModel);
+
+    QElapsedTimer inactiveTimer_;
+
+private Q_SLOTS:
+    void modelAboutToHibernate();
+
+    void modelWokenUp();
 };
@@ -5,6 +5,7 @@
 #include <HistogramPlotUI.h>
 #include <QApplication>
 
+#include <Common/Configuration.h>
 #include <Common/TimeLogger.h>
 #include <ModelsAndViews/DataView.h>
 #include <ModelsAndViews/FilteringProxyModel.h>
@@ -20,6 +21,35 @@ TabWidget::TabWidget(QWidget* parent) : QTabWidget(parent)
     setTabBar(new TabBar(this));
     setTabsClosable(true);
     setMovable(true);
+
+    // Connected first, so tab is woken up before others use its data.
+    connect(this, &TabWidget::currentChanged, this,
+            &TabWidget::currentTabChanged);
+    connect(&hibernationTimer_, &QTimer::timeout, this,
+            &TabWidget::hibernationTimerTimeout);
+    hibernationTimer_.start(HIBERNATION_CHECK_INTERVAL);
+}
+
+void TabWidget::currentTabChanged(int index)
+{
+    for (int i = 0; i < count(); ++i)
+        if (auto* tab{qobject_cast<Tab*>(widget(i))}; tab != nullptr)
+            tab->setActive(i == index);
+}
+
+void TabWidget::hibernationTimerTimeout()
+{
+    const int idleMinutes{
+        Configuration::getInstance().getHibernationIdleMinutes()};
+    if (idleMinutes <= 0)
+        return;
+
+    const qint64 idleTime{static_cast<qint64>(idleMinutes) * 60 * 1000};
+    for (int i = 0; i < count(); ++i)
+        if (auto* tab{qobject_cast<Tab*>(widget(i))};
+            tab != nullptr && i != currentIndex() &&
+            tab->getInactiveTime() >= idleTime)
+            tab->hibernate();
 }
 
 FilteringProxyModel* TabWidget::getCurrentProxyModel() const
@@ -4,6 +4,7 @@
 
 #include <QDate>
 #include <QTabWidget>
+#include <QTimer>
 
 class TableModel;
 class DataView;
@@ -64,4 +65,14 @@ private:
 
     template <class T>
     void showPlot();
+
+    /// Periodically hibernates tabs hidden for longer than configured time.
+    QTimer hibernationTimer_;
+
+    static constexpr int HIBERNATION_CHECK_INTERVAL{60 * 1000};
+
+private Q_SLOTS:
+    void currentTabChanged(int index);
+
+    void hibernationTimerTimeout();
 };
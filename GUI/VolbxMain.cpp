@@ -2,15 +2,22 @@
 
 #include <ProgressBarCounter.h>
 #include <QDir>
+#include <QFile>
 #include <QMessageBox>
 #include <QNetworkReply>
+#include <QPointer>
 #include <QProcess>
+#include <QPushButton>
 #include <QStyle>
 #include <QStyleFactory>
+#include <QTimer>
 
 #include <Common/Configuration.h>
 #include <Common/Constants.h>
 #include <Common/DatasetUtilities.h>
+#include <Common/ImportCache.h>
+#include <Common/MemoryBudget.h>
+#include <Datasets/DatasetSpreadsheet.h>
 #include <Export/ExportVbx.h>
 #include <Import/ImportData.h>
 #include <ModelsAndViews/FilteringProxyModel.h>
@@ -21,9 +28,12 @@
 
 #include "About.h"
 #include "CheckUpdates.h"
+#include "DatasetLoader.h"
 #include "DataView.h"
 #include "Export.h"
 #include "FiltersDock.h"
+#include "MemoryUsage.h"
+#include "ProfileDock.h"
 #include "SaveDatasetAs.h"
 #include "Tab.h"
 #include "TabWidget.h"
@@ -93,12 +103,18 @@ void VolbxMain::connectActions()
             [&]() { filters_.setVisible(!filters_.isVisible()); });
     connect(ui->actionLogs, &QAction::triggered, this,
             []() { Logger::getInstance().toggleVisibility(); });
+    connect(ui->actionMemoryUsage, &QAction::triggered, this,
+            &VolbxMain::actionMemoryUsageTriggered);
     connect(ui->actionAbout, &QAction::triggered, this,
             &VolbxMain::actionAboutTriggered);
     connect(ui->actionExport, &QAction::triggered, this,
             &VolbxMain::actionExportTriggered);
     connect(ui->actionSaveDatasetAs, &QAction::triggered, this,
             &VolbxMain::actionSaveDatasetAsTriggered);
+    connect(ui->actionOpenSelection, &QAction::triggered, this,
+            &VolbxMain::actionOpenSelectionTriggered);
+    connect(ui->actionProfiles, &QAction::triggered, this,
+            &VolbxMain::actionProfilesTriggered);
     connect(ui->actionImportData, &QAction::triggered, this,
             &VolbxMain::actionImportDataTriggered);
     connect(ui->actionCheckForNewVersion, &QAction::triggered, this,
@@ -237,6 +253,12 @@ void VolbxMain::actionAboutTriggered()
     about.exec();
 }
 
+void VolbxMain::actionMemoryUsageTriggered()
+{
+    MemoryUsage memoryUsage(tabWidget_, this);
+    memoryUsage.exec();
+}
+
 void VolbxMain::closeTab(int tab)
 {
     QWidget* tabToDelete{tabWidget_.widget(tab)};
@@ -274,11 +296,17 @@ void VolbxMain::setTooltipsForChartsActions(bool chartsActive)
 
 void VolbxMain::manageActions(bool tabExists)
 {
-    ui->actionExport->setEnabled(tabExists);
-    ui->actionSaveDatasetAs->setEnabled(tabExists);
+    // Tab with dataset still loading shows data only.
+    const bool tabReady{tabExists &&
+                        !tabWidget_.getCurrentDataModel()->isLoading()};
+    ui->actionExport->setEnabled(tabReady);
+    ui->actionSaveDatasetAs->setEnabled(tabReady);
+    ui->actionOpenSelection->setEnabled(tabReady);
+    ui->actionProfiles->setEnabled(tabReady);
+    filters_.setEnabled(!tabExists || tabReady);
 
     const bool activateCharts{
-        tabExists && tabWidget_.getCurrentDataModel()->areTaggedColumnsSet()};
+        tabReady && tabWidget_.getCurrentDataModel()->areTaggedColumnsSet()};
     ui->actionBasic_plot->setEnabled(activateCharts);
     ui->actionHistogram->setEnabled(activateCharts);
     ui->actionGroup_plot->setEnabled(activateCharts);
@@ -291,30 +319,106 @@ void VolbxMain::saveDataset(const QString& datasetName)
     if (view == nullptr)
         return;
 
-    QString barTitle{
-        Constants::getProgressBarTitle(Constants::BarTitle::SAVING)};
+    LOG(LogTypes::IMPORT_EXPORT, "Saving dataset " + datasetName);
+    QFile file(DatasetUtilities::getDatasetsDir() + datasetName +
+               DatasetUtilities::getDatasetExtension());
+    writeVbxFile(*view, file);
+}
+
+bool VolbxMain::writeVbxFile(const DataView& view, QFile& file)
+{
+    return exportVbxWithProgress(
+        Constants::getProgressBarTitle(Constants::BarTitle::SAVING),
+        [&view, &file](ExportVbx& exportVbx) {
+            exportVbx.setWriteIndexes(true);
+            return exportVbx.generateVbx(view, file);
+        });
+}
+
+bool VolbxMain::exportVbxWithProgress(
+    const QString& barTitle, const std::function<bool(ExportVbx&)>& runExport)
+{
     ProgressBarCounter bar(barTitle, Constants::getProgressBarFullCounter(),
                            nullptr);
     bar.showDetached();
 
-    LOG(LogTypes::IMPORT_EXPORT, "Saving dataset " + datasetName);
-    QString filePath{DatasetUtilities::getDatasetsDir() + datasetName +
-                     DatasetUtilities::getDatasetExtension()};
-
     QTime performanceTimer;
     performanceTimer.start();
 
-    QFile file(filePath);
     ExportVbx exportVbx;
     connect(&exportVbx, &ExportData::progressPercentChanged, &bar,
             &ProgressBarCounter::updateProgress);
-    if (exportVbx.generateVbx(*view, file))
-        LOG(LogTypes::IMPORT_EXPORT,
-            "File saved in " +
-                Constants::timeFromTimeToSeconds(performanceTimer) +
-                " seconds.");
-    else
+    if (!runExport(exportVbx))
+    {
         LOG(LogTypes::IMPORT_EXPORT, "Saving failed.");
+        return false;
+    }
+
+    LOG(LogTypes::IMPORT_EXPORT,
+        "File saved in " + Constants::timeFromTimeToSeconds(performanceTimer) +
+            " seconds.");
+    return true;
+}
+
+void VolbxMain::appendToDataset(const QString& datasetName)
+{
+    DataView* view{tabWidget_.getCurrentDataView()};
+    if (view == nullptr)
+        return;
+
+    LOG(LogTypes::IMPORT_EXPORT, "Appending rows to dataset " + datasetName);
+    QFile existingFile(DatasetUtilities::getDatasetsDir() + datasetName +
+                       DatasetUtilities::getDatasetExtension());
+    QFile file(existingFile.fileName() + ".part");
+    if (!existingFile.open(QIODevice::ReadOnly))
+        return;
+
+    const bool appended{exportVbxWithProgress(
+        Constants::getProgressBarTitle(Constants::BarTitle::SAVING),
+        [view, &existingFile, &file](ExportVbx& exportVbx) {
+            return exportVbx.appendVbx(*view, existingFile, file);
+        })};
+    existingFile.close();
+    file.close();
+
+    // Existing dataset is kept as backup until complete file replaces it.
+    const QString datasetPath{existingFile.fileName()};
+    const QString backupPath{datasetPath + ".bak"};
+    QFile::remove(backupPath);
+    bool replaced{appended && QFile::rename(datasetPath, backupPath)};
+    if (replaced && !QFile::rename(file.fileName(), datasetPath))
+    {
+        QFile::rename(backupPath, datasetPath);
+        replaced = false;
+    }
+    QFile::remove(replaced ? backupPath : file.fileName());
+
+    if (!replaced)
+        QMessageBox::critical(this, tr("Append error"),
+                              tr("Rows can not be appended to dataset ") +
+                                  datasetName + ".");
+}
+
+void VolbxMain::cacheImportedDataset(const DataView& view,
+                                     const QString& cacheFilePath)
+{
+    LOG(LogTypes::IMPORT_EXPORT, "Caching imported data in " + cacheFilePath);
+
+    // Cache file appears only when complete, as it is used when exists.
+    // Indexes are not written, so caching does not delay import much.
+    QFile file(cacheFilePath + ".part");
+    const bool written{exportVbxWithProgress(
+        Constants::getProgressBarTitle(Constants::BarTitle::CACHING),
+        [&view, &file](ExportVbx& exportVbx) {
+            return exportVbx.generateVbx(view, file);
+        })};
+    if (written && QFile::rename(file.fileName(), cacheFilePath))
+    {
+        ImportCache::removeStaleEntries(cacheFilePath);
+        ImportCache::removeLeastRecentlyUsed(cacheFilePath);
+    }
+    else
+        QFile::remove(file.fileName());
 }
 
 void VolbxMain::actionSaveDatasetAsTriggered()
@@ -329,7 +433,12 @@ void VolbxMain::actionSaveDatasetAsTriggered()
     }
 
     SaveDatasetAs saveAs(DatasetUtilities::getListOfAvailableDatasets());
-    if (saveAs.exec() == QDialog::Accepted)
+    if (saveAs.exec() != QDialog::Accepted)
+        return;
+
+    if (saveAs.isAppendChosen())
+        appendToDataset(saveAs.getDatasetName());
+    else
         saveDataset(saveAs.getDatasetName());
 }
 
@@ -343,40 +452,162 @@ void VolbxMain::importDataset(std::unique_ptr<Dataset> dataset)
         return;
     }
 
-    const QString barTitle{
-        Constants::getProgressBarTitle(Constants::BarTitle::LOADING)};
-    ProgressBarCounter bar(barTitle, Constants::getProgressBarFullCounter(),
-                           nullptr);
-    QObject::connect(dataset.get(), &Dataset::loadingPercentChanged, &bar,
-                     &ProgressBarCounter::updateProgress);
-    bar.showDetached();
+    if (openUsingDataOfOpenedTab(dataset))
+        return;
 
-    QApplication::processEvents();
+    // Caches of opened data are released first when new data would not fit.
+    if (const quint64 neededMemory{dataset->estimateLoadMemory()};
+        !MemoryBudget::getInstance().makeRoom(neededMemory) &&
+        !confirmLoadingOverLimit(*dataset, neededMemory))
+        return;
 
-    QTime performanceTimer;
-    performanceTimer.start();
+    auto* loader{new DatasetLoader(std::move(dataset), this)};
+    connect(loader, &DatasetLoader::firstRowsLoaded, this,
+            [this, loader]() { addMainTabForModel(loader); });
+    connect(loader, &DatasetLoader::loadingFinished, this,
+            [this, loader]() { datasetLoadingFinished(loader); });
+    loader->start();
+}
 
-    try
-    {
-        dataset->loadData();
-    }
-    catch (std::bad_alloc&)
-    {
-        QString message(tr("Not enough memory to open data. "));
-        message.append(tr("Close not needed data,"));
-        message.append(
-            tr(" pick smaller set or use another instance of application."));
-        QMessageBox::critical(this, tr("Memory problem"), message);
+bool VolbxMain::confirmLoadingOverLimit(Dataset& dataset,
+                                        quint64 neededMemory)
+{
+    LOG(LogTypes::IMPORT_EXPORT,
+        "Memory budget exceeded by loading of " + dataset.getName());
+
+    const MemoryBudget& budget{MemoryBudget::getInstance()};
+    const quint64 usedMemory{budget.getUsedMemory()};
+    const quint64 freeMemory{
+        budget.getLimit() > usedMemory ? budget.getLimit() - usedMemory : 0};
+
+    // Rows of sample are estimated from memory needed by rows to load.
+    LoadQuery query{dataset.getLoadQuery()};
+    unsigned int rowsToLoad{dataset.rowCount()};
+    if (query.isPartial())
+        rowsToLoad = std::min(rowsToLoad, query.rowLimit_);
+    const auto sampleRows{static_cast<unsigned int>(
+        static_cast<double>(rowsToLoad) * static_cast<double>(freeMemory) /
+        static_cast<double>(std::max(neededMemory, quint64{1})))};
+
+    QMessageBox messageBox(
+        QMessageBox::Warning, tr("Memory limit"),
+        tr("Loading of ") + dataset.getName() + tr(" needs about ") +
+            locale().formattedDataSize(static_cast<qint64>(neededMemory)) +
+            tr(", only ") +
+            locale().formattedDataSize(static_cast<qint64>(freeMemory)) +
+            tr(" is available for data."),
+        QMessageBox::NoButton, this);
+    const QPushButton* loadButton{
+        messageBox.addButton(tr("Load anyway"), QMessageBox::AcceptRole)};
+    QPushButton* sampleButton{messageBox.addButton(
+        tr("Load sample of ") + QString::number(sampleRows) + " " + tr("rows"),
+        QMessageBox::AcceptRole)};
+    sampleButton->setEnabled(sampleRows > 0 &&
+                             query.mode_ != LoadMode::ROW_RANGE);
+    messageBox.addButton(QMessageBox::Cancel);
+    messageBox.exec();
+
+    if (messageBox.clickedButton() == loadButton)
+        return true;
+    if (messageBox.clickedButton() != sampleButton)
+        return false;
 
-        return;
-    }
+    query.mode_ = LoadMode::RANDOM_SAMPLE;
+    query.rowLimit_ = sampleRows;
+    dataset.setLoadQuery(query);
+    return true;
+}
+
+bool VolbxMain::openUsingDataOfOpenedTab(std::unique_ptr<Dataset>& dataset)
+{
+    // Tab can not take rows of tab which is not found or is hibernated.
+    bool shared{false};
+    for (int i = 0; i < tabWidget_.count() && !shared; ++i)
+        if (const auto* tab{qobject_cast<Tab*>(tabWidget_.widget(i))};
+            tab != nullptr)
+            shared = tab->getCurrentTableModel()->shareData(*dataset);
+    if (!shared)
+        return false;
 
     LOG(LogTypes::IMPORT_EXPORT,
-        "Loaded file having " + QString::number(dataset->rowCount()) +
-            " rows in time " +
-            Constants::timeFromTimeToSeconds(performanceTimer) + " seconds.");
+        "Data of " + dataset->getName() + " shared with opened tab.");
+    addTabForLoadedDataset(std::move(dataset));
+    return true;
+}
+
+void VolbxMain::addTabForLoadedDataset(std::unique_ptr<Dataset> dataset)
+{
+    const QString datasetName{dataset->getName()};
+    const QString nameForTabBar{createNameForTab(dataset)};
+    auto* model{new TableModel(std::move(dataset))};
+    auto* tab{new Tab(model, datasetName, &tabWidget_)};
+    tabWidget_.setCurrentIndex(tabWidget_.addTab(tab, nameForTabBar));
+    filters_.addFiltersForModel(tab->getCurrentProxyModel());
+    tabWasChanged(tabWidget_.currentIndex());
 
-    addMainTabForDataset(std::move(dataset));
+    ui->statusBar->showMessage(datasetName + " " + tr("loaded"));
+}
+
+void VolbxMain::actionOpenSelectionTriggered()
+{
+    const DataView* view{tabWidget_.getCurrentDataView()};
+    const TableModel* model{tabWidget_.getCurrentDataModel()};
+    if (view == nullptr || model == nullptr)
+        return;
+
+    const QString name{tabWidget_.currentWidget()->windowTitle() + " - " +
+                       tr("selection")};
+    std::unique_ptr<Dataset> dataset{
+        model->createDerivedDataset(name, view->getSelectedSourceRows())};
+    if (dataset == nullptr)
+        return;
+    addTabForLoadedDataset(std::move(dataset));
+}
+
+void VolbxMain::actionProfilesTriggered()
+{
+    if (auto* tab{qobject_cast<Tab*>(tabWidget_.currentWidget())};
+        tab != nullptr)
+        tab->getProfileDock()->show();
+}
+
+void VolbxMain::datasetLoadingFinished(DatasetLoader* loader)
+{
+    loader->deleteLater();
+    TableModel* model{loader->getModel()};
+    const DatasetLoader::Result result{loader->getResult()};
+    if (result != DatasetLoader::Result::LOADED && model != nullptr)
+        if (auto* tab{qobject_cast<Tab*>(model->parent())}; tab != nullptr)
+            closeTab(tabWidget_.indexOf(tab));
+
+    switch (result)
+    {
+        case DatasetLoader::Result::LOADED:
+            if (model != nullptr)
+                finishMainTab(loader);
+            MemoryBudget::getInstance().makeRoom(0);
+            break;
+        case DatasetLoader::Result::CANCELLED:
+            ui->statusBar->showMessage(tr("Loading cancelled"));
+            break;
+        case DatasetLoader::Result::FAILED:
+        {
+            const auto dataset{loader->retrieveDataset()};
+            QMessageBox::critical(
+                this, tr("Import error"),
+                tr("Import error encountered: ") + dataset->getLastError());
+            break;
+        }
+        case DatasetLoader::Result::OUT_OF_MEMORY:
+        {
+            QString message(tr("Not enough memory to open data. "));
+            message.append(tr("Close not needed data,"));
+            message.append(tr(
+                " pick smaller set or use another instance of application."));
+            QMessageBox::critical(this, tr("Memory problem"), message);
+            break;
+        }
+    }
 }
 
 void VolbxMain::actionImportDataTriggered()
@@ -392,22 +623,69 @@ QString VolbxMain::createNameForTab(const std::unique_ptr<Dataset>& dataset)
     if (auto [ok, column] = dataset->getTaggedColumn(ColumnTag::VALUE); ok)
         nameForTabBar.append(
             " (" + dataset->getHeaderName(static_cast<int>(column)) + ")");
+
+    const LoadQuery& query{dataset->getLoadQuery()};
+    if (query.mode_ == LoadMode::ROW_RANGE)
+        nameForTabBar.append(" [" + tr("rows") + " " +
+                             QString::number(query.firstRow_ + 1) + "-" +
+                             QString::number(query.firstRow_ +
+                                             dataset->rowCount()) +
+                             "]");
+    if (query.mode_ == LoadMode::RANDOM_SAMPLE)
+        nameForTabBar.append(" [" + tr("sample of") + " " +
+                             QString::number(dataset->rowCount()) + " " +
+                             tr("rows") + "]");
     return nameForTabBar;
 }
 
-void VolbxMain::addMainTabForDataset(std::unique_ptr<Dataset> dataset)
+void VolbxMain::addMainTabForModel(DatasetLoader* loader)
 {
-    const QString nameForTabBar{createNameForTab(dataset)};
-    const QString datasetName{dataset->getName()};
+    TableModel* model{loader->getModel()};
+    if (model == nullptr || model->parent() != nullptr)
+        return;
 
-    auto* mainTab{new Tab(std::move(dataset), &tabWidget_)};
-    filters_.addFiltersForModel(mainTab->getCurrentProxyModel());
-    const int newTabIndex{tabWidget_.addTab(mainTab, nameForTabBar)};
+    // Filters and plots are enabled when loading ends.
+    auto* mainTab{new Tab(model, loader->getDatasetName(), &tabWidget_)};
+    const int newTabIndex{tabWidget_.addTab(
+        mainTab, loader->getDatasetName() + " [" + tr("loading") + "]")};
     tabWidget_.setCurrentIndex(newTabIndex);
 
     manageActions(true);
+}
 
-    ui->statusBar->showMessage(datasetName + " " + tr("loaded"));
+void VolbxMain::finishMainTab(DatasetLoader* loader)
+{
+    addMainTabForModel(loader);
+    TableModel* model{loader->getModel()};
+    auto* mainTab{qobject_cast<Tab*>(model->parent())};
+
+    std::unique_ptr<Dataset> dataset{loader->retrieveDataset()};
+    QString nameForTabBar{createNameForTab(dataset)};
+    if (dataset->isFollowable())
+        nameForTabBar.append(" [" + tr("following") + "]");
+    QString cacheFilePath;
+    if (const auto* spreadsheet{
+            qobject_cast<const DatasetSpreadsheet*>(dataset.get())};
+        spreadsheet != nullptr)
+        cacheFilePath = spreadsheet->getCacheFilePath();
+    model->finishLoading(std::move(dataset));
+    filters_.addFiltersForModel(mainTab->getCurrentProxyModel());
+    model->setFollowing(model->isFollowable());
+    tabWidget_.setTabText(tabWidget_.indexOf(mainTab), nameForTabBar);
+
+    tabWasChanged(tabWidget_.currentIndex());
+
+    // Caching starts once tab is shown, tab can be closed in the meantime.
+    if (!cacheFilePath.isEmpty())
+        QTimer::singleShot(
+            0, this,
+            [this, view = QPointer<DataView>(mainTab->getCurrentDataView()),
+             cacheFilePath]() {
+                if (view != nullptr)
+                    cacheImportedDataset(*view, cacheFilePath);
+            });
+
+    ui->statusBar->showMessage(loader->getDatasetName() + " " + tr("loaded"));
 }
 
 void VolbxMain::setupStatusBar()
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include <QMainWindow>
@@ -15,6 +16,10 @@ class VolbxMain;
 
 class QActionGroup;
 class Dataset;
+class DatasetLoader;
+class DataView;
+class ExportVbx;
+class QFile;
 
 /**
  * @brief Volbx main window.
@@ -47,7 +52,9 @@ private:
 
     void addStyleToMenu(const QString& name, QActionGroup* actionsGroup) const;
 
-    void addMainTabForDataset(std::unique_ptr<Dataset> dataset);
+    void addMainTabForModel(DatasetLoader* loader);
+
+    void finishMainTab(DatasetLoader* loader);
 
     void manageActions(bool tabExists);
 
@@ -71,8 +78,40 @@ private:
 
     void saveDataset(const QString& datasetName);
 
+    static bool writeVbxFile(const DataView& view, QFile& file);
+
+    /**
+     * @brief Run export to vbx file showing progress and logging time.
+     * @param barTitle Title of progress bar.
+     * @param runExport Function running export using given exporter.
+     * @return True if export succeeded, false otherwise.
+     */
+    static bool exportVbxWithProgress(
+        const QString& barTitle,
+        const std::function<bool(ExportVbx&)>& runExport);
+
+    void appendToDataset(const QString& datasetName);
+
+    void cacheImportedDataset(const DataView& view,
+                              const QString& cacheFilePath);
+
     void importDataset(std::unique_ptr<Dataset> dataset);
 
+    /**
+     * @brief Ask user how to load dataset not fitting in memory limit.
+     * @param dataset Dataset to load, query is limited to sample when
+     * chosen.
+     * @param neededMemory Estimated memory needed for loading.
+     * @return True if loading should continue, false when cancelled.
+     */
+    bool confirmLoadingOverLimit(Dataset& dataset, quint64 neededMemory);
+
+    bool openUsingDataOfOpenedTab(std::unique_ptr<Dataset>& dataset);
+
+    void addTabForLoadedDataset(std::unique_ptr<Dataset> dataset);
+
+    void datasetLoadingFinished(DatasetLoader* loader);
+
     static QString createNameForTab(const std::unique_ptr<Dataset>& dataset);
 
     bool canUpdate(QNetworkReply* reply);
@@ -95,12 +134,18 @@ private Q_SLOTS:
 
     void actionAboutTriggered();
 
+    void actionMemoryUsageTriggered();
+
     void closeTab(int tab);
 
     void actionExportTriggered();
 
     void actionSaveDatasetAsTriggered();
 
+    void actionOpenSelectionTriggered();
+
+    void actionProfilesTriggered();
+
     void actionImportDataTriggered();
 
     void updateCheckReplyFinished(QNetworkReply* reply);
@@ -0,0 +1,108 @@
+#include "BatchImportTab.h"
+
+#include <QDir>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QMessageBox>
+#include <QSplitter>
+
+#include <Common/Configuration.h>
+#include <Datasets/DatasetBatch.h>
+
+#include "ColumnsPreview.h"
+#include "DatasetVisualization.h"
+#include "ui_BatchImportTab.h"
+
+BatchImportTab::BatchImportTab(QWidget* parent)
+    : ImportTab(parent), ui(new Ui::BatchImportTab)
+{
+    ui->setupUi(this);
+
+    connect(ui->openFilesButton, &QPushButton::clicked, this,
+            &BatchImportTab::openFilesButtonClicked);
+    connect(ui->filesLineEdit, &QLineEdit::returnPressed, this,
+            &BatchImportTab::analyzeFiles);
+    connect(ui->sourceFileCheckBox, &QCheckBox::toggled, this,
+            &BatchImportTab::analyzeFiles);
+
+    auto [visualization, columnsPreview] =
+        createVisualizationAndColumnPreview();
+
+    auto* centralSplitter{new QSplitter(Qt::Vertical, this)};
+    centralSplitter->addWidget(visualization);
+    centralSplitter->addWidget(columnsPreview);
+
+    ui->verticalLayout->addWidget(centralSplitter);
+}
+
+BatchImportTab::~BatchImportTab() { delete ui; }
+
+QStringList BatchImportTab::expandFiles(const QString& filesText)
+{
+    QStringList files;
+    const QStringList entries{filesText.split(QLatin1Char(';'),
+                                              QString::SkipEmptyParts)};
+    for (const QString& entry : entries)
+    {
+        const QFileInfo entryInfo(entry.trimmed());
+        const QString pattern{entryInfo.fileName()};
+        if (!pattern.contains(QRegExp(QStringLiteral("[*?\\[]"))))
+        {
+            files.append(entryInfo.filePath());
+            continue;
+        }
+
+        const QFileInfoList matchingFiles{
+            QDir(entryInfo.path())
+                .entryInfoList({pattern}, QDir::Files, QDir::Name)};
+        for (const QFileInfo& fileInfo : matchingFiles)
+            files.append(fileInfo.filePath());
+    }
+    return files;
+}
+
+void BatchImportTab::openFilesButtonClicked()
+{
+    const QStringList filePaths{QFileDialog::getOpenFileNames(
+        this, tr("Open files"),
+        Configuration::getInstance().getImportFilePath(),
+        tr("Data files (*.xlsx *.ods *.csv *.tsv *.txt)"))};
+    if (filePaths.isEmpty())
+        return;
+
+    Configuration::getInstance().setImportFilePath(
+        QFileInfo(filePaths.constFirst()).canonicalPath());
+    ui->filesLineEdit->setText(filePaths.join(QLatin1Char(';')));
+    analyzeFiles();
+}
+
+void BatchImportTab::analyzeFiles()
+{
+    const QStringList filePaths{expandFiles(ui->filesLineEdit->text())};
+    if (filePaths.isEmpty())
+        return;
+
+    for (const QString& filePath : filePaths)
+        if (!fileIsOk(QFileInfo(filePath)))
+        {
+            QMessageBox::information(this, tr("Access error"),
+                                     tr("Can not access file ") + filePath);
+            Q_EMIT datasetIsReady(false);
+            return;
+        }
+
+    auto batch{std::make_unique<DatasetBatch>(
+        getValidDatasetName(QFileInfo(filePaths.constFirst())), filePaths)};
+    batch->setSourceFileColumn(ui->sourceFileCheckBox->isChecked());
+    std::unique_ptr<Dataset> dataset{std::move(batch)};
+    analyzeFile(dataset);
+    if (!dataset->isValid())
+    {
+        QMessageBox::information(this, tr("Files not loaded"),
+                                 dataset->getLastError());
+        Q_EMIT datasetIsReady(false);
+        return;
+    }
+
+    setDataset(std::move(dataset));
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ImportTab.h"
+
+namespace Ui
+{
+class BatchImportTab;
+}  // namespace Ui
+
+/**
+ * @brief Ui class for importing many files having same columns as one
+ * dataset.
+ */
+class BatchImportTab : public ImportTab
+{
+    Q_OBJECT
+public:
+    explicit BatchImportTab(QWidget* parent = nullptr);
+
+    ~BatchImportTab() override;
+
+private:
+    /**
+     * @brief Get files matching given list of paths and wildcard patterns.
+     * @param filesText Paths or patterns separated by semicolons.
+     * @return Paths of matching files in order of list, sorted by name
+     * within pattern.
+     */
+    static QStringList expandFiles(const QString& filesText);
+
+    Ui::BatchImportTab* ui;
+
+private Q_SLOTS:
+    void openFilesButtonClicked();
+
+    void analyzeFiles();
+};
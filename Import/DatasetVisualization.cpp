@@ -1,6 +1,10 @@
 #include "DatasetVisualization.h"
 
+#include <algorithm>
+#include <limits>
+
 #include <Common/Constants.h>
+#include <Common/MemoryUtilities.h>
 #include <Datasets/Dataset.h>
 
 #include "ui_DatasetVisualization.h"
@@ -12,6 +16,17 @@ DatasetVisualization::DatasetVisualization(QWidget* parent)
 
     ui->columnsList->header()->setSectionsMovable(false);
 
+    ui->loadModeCombo->addItem(tr("All rows"),
+                               static_cast<int>(LoadMode::ALL_ROWS));
+    ui->loadModeCombo->addItem(tr("Row range"),
+                               static_cast<int>(LoadMode::ROW_RANGE));
+    ui->loadModeCombo->addItem(tr("Random sample"),
+                               static_cast<int>(LoadMode::RANDOM_SAMPLE));
+
+    connect(ui->loadModeCombo,
+            qOverload<int>(&QComboBox::currentIndexChanged), this,
+            &DatasetVisualization::loadModeChanged);
+
     connect(ui->searchLineEdit, &QLineEdit::textChanged, this,
             &DatasetVisualization::searchTextChanged);
 
@@ -25,6 +40,19 @@ DatasetVisualization::DatasetVisualization(QWidget* parent)
             qOverload<int>(&QComboBox::currentIndexChanged), this,
             &DatasetVisualization::refreshColumnList);
 
+    connect(ui->columnsList, &QTreeWidget::itemChanged, this,
+            &DatasetVisualization::refreshMemoryEstimate);
+
+    connect(ui->loadModeCombo,
+            qOverload<int>(&QComboBox::currentIndexChanged), this,
+            &DatasetVisualization::refreshMemoryEstimate);
+
+    connect(ui->firstRowSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+            this, &DatasetVisualization::refreshMemoryEstimate);
+
+    connect(ui->rowCountSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+            this, &DatasetVisualization::refreshMemoryEstimate);
+
     connect(ui->SelectAll, &QPushButton::clicked, this,
             &DatasetVisualization::selectAllClicked);
 
@@ -46,6 +74,8 @@ void DatasetVisualization::setDataset(std::unique_ptr<Dataset> dataset)
 
     setTaggedColumns();
 
+    setupLoadModeWidgets();
+
     ui->taggedColumnsWidget->setEnabled(true);
 
     refreshColumnList(0);
@@ -57,8 +87,10 @@ void DatasetVisualization::clear()
     ui->dateCombo->clear();
     ui->columnsList->clear();
     ui->columnsList->setEnabled(false);
-    ui->taggedColumnsWidget->setEnabled(false);
+    ui->memoryLabel->clear();
     dataset_ = nullptr;
+    ui->loadModeCombo->setCurrentIndex(0);
+    ui->taggedColumnsWidget->setEnabled(false);
 }
 
 void DatasetVisualization::searchTextChanged(const QString& newText)
@@ -83,6 +115,8 @@ std::unique_ptr<Dataset> DatasetVisualization::retrieveDataset()
     setTaggedColumnInDataset(ColumnTag::DATE, ui->dateCombo);
     setTaggedColumnInDataset(ColumnTag::VALUE, ui->pricePerUnitCombo);
 
+    dataset_->setLoadQuery(getLoadQuery());
+
     return std::move(dataset_);
 }
 
@@ -136,7 +170,8 @@ void DatasetVisualization::setupColumnsListWidget()
          ++column)
     {
         const QStringList list{dataset_->getHeaderName(column),
-                               getTypeDisplayNameForGivenColumn(column)};
+                               getTypeDisplayNameForGivenColumn(column),
+                               QString()};
         auto* item{new QTreeWidgetItem(list)};
         item->setData(0, Qt::UserRole, QVariant(column));
         ui->columnsList->addTopLevelItem(item);
@@ -211,6 +246,34 @@ QString DatasetVisualization::getTypeDisplayNameForGivenColumn(int column) const
     Q_ASSERT(false);
 }
 
+void DatasetVisualization::setupLoadModeWidgets()
+{
+    const int rowCount{static_cast<int>(std::min(
+        dataset_->rowCount(),
+        static_cast<unsigned int>(std::numeric_limits<int>::max())))};
+    const int maximum{std::max(rowCount, 1)};
+    ui->firstRowSpinBox->setRange(1, maximum);
+    ui->firstRowSpinBox->setValue(1);
+    ui->rowCountSpinBox->setRange(1, maximum);
+    ui->rowCountSpinBox->setValue(maximum);
+    ui->loadModeCombo->setCurrentIndex(0);
+    loadModeChanged(0);
+}
+
+LoadQuery DatasetVisualization::getLoadQuery() const
+{
+    LoadQuery query{dataset_->getLoadQuery()};
+    query.mode_ = static_cast<LoadMode>(
+        ui->loadModeCombo->itemData(ui->loadModeCombo->currentIndex())
+            .toInt());
+    query.firstRow_ = 0;
+    if (query.mode_ == LoadMode::ROW_RANGE)
+        query.firstRow_ =
+            static_cast<unsigned int>(ui->firstRowSpinBox->value() - 1);
+    query.rowLimit_ = static_cast<unsigned int>(ui->rowCountSpinBox->value());
+    return query;
+}
+
 void DatasetVisualization::fillTaggedColumnCombos()
 {
     for (int column = 0; column < static_cast<int>(dataset_->columnCount());
@@ -255,11 +318,21 @@ void DatasetVisualization::unselectAllClicked()
     setAllItemsInColumnsListToState(Qt::Unchecked);
 }
 
+void DatasetVisualization::loadModeChanged([[maybe_unused]] int newIndex)
+{
+    const auto mode{static_cast<LoadMode>(
+        ui->loadModeCombo->itemData(ui->loadModeCombo->currentIndex())
+            .toInt())};
+    ui->firstRowSpinBox->setEnabled(mode == LoadMode::ROW_RANGE);
+    ui->rowCountSpinBox->setEnabled(mode != LoadMode::ALL_ROWS);
+}
+
 void DatasetVisualization::refreshColumnList([[maybe_unused]] int newIndex)
 {
     const int dateColumn{getCurrentValueFromCombo(ui->dateCombo)};
     const int priceColumn{getCurrentValueFromCombo(ui->pricePerUnitCombo)};
 
+    ui->columnsList->blockSignals(true);
     int topLevelItemsCount{ui->columnsList->topLevelItemCount()};
     for (int i = 0; i < topLevelItemsCount; ++i)
     {
@@ -277,4 +350,115 @@ void DatasetVisualization::refreshColumnList([[maybe_unused]] int newIndex)
             currentItem->setCheckState(0, Qt::Checked);
         }
     }
+    ui->columnsList->blockSignals(false);
+
+    refreshMemoryEstimate();
+}
+
+void DatasetVisualization::refreshMemoryEstimate()
+{
+    if (dataset_ == nullptr)
+        return;
+
+    const unsigned int rowCount{getRowsToLoad()};
+    ui->columnsList->blockSignals(true);
+    const int memoryColumn{2};
+    for (int i = 0; i < ui->columnsList->topLevelItemCount(); ++i)
+    {
+        QTreeWidgetItem* currentItem{ui->columnsList->topLevelItem(i)};
+        const int column{currentItem->data(0, Qt::UserRole).toInt()};
+        currentItem->setText(
+            memoryColumn,
+            locale().formattedDataSize(static_cast<qint64>(
+                dataset_->estimateColumnMemory(column, rowCount))));
+    }
+    ui->columnsList->blockSignals(false);
+
+    const quint64 estimate{
+        dataset_->estimateMemory(getActiveColumns(), rowCount)};
+    QString text{tr("Estimated memory: ") +
+                 locale().formattedDataSize(static_cast<qint64>(estimate))};
+    const quint64 available{MemoryUtilities::getAvailableMemory()};
+    if (available != 0)
+        text.append(
+            tr(" of ") +
+            locale().formattedDataSize(static_cast<qint64>(available)) +
+            tr(" available."));
+
+    const auto budget{
+        static_cast<quint64>(available * AVAILABLE_MEMORY_RATIO)};
+    if (available != 0 && estimate > budget)
+        text.append(" " + getMemoryAdvice(estimate, budget));
+    ui->memoryLabel->setText(text);
+}
+
+unsigned int DatasetVisualization::getRowsToLoad() const
+{
+    const unsigned int rowCount{dataset_->rowCount()};
+    const auto limit{static_cast<unsigned int>(ui->rowCountSpinBox->value())};
+    switch (static_cast<LoadMode>(
+        ui->loadModeCombo->itemData(ui->loadModeCombo->currentIndex())
+            .toInt()))
+    {
+        case LoadMode::ALL_ROWS:
+            return rowCount;
+
+        case LoadMode::ROW_RANGE:
+        {
+            const auto firstRow{
+                static_cast<unsigned int>(ui->firstRowSpinBox->value() - 1)};
+            return std::min(limit, rowCount - std::min(firstRow, rowCount));
+        }
+
+        case LoadMode::RANDOM_SAMPLE:
+            return std::min(limit, rowCount);
+    }
+    return rowCount;
+}
+
+QString DatasetVisualization::getMemoryAdvice(quint64 estimate,
+                                              quint64 budget) const
+{
+    const unsigned int rowCount{getRowsToLoad()};
+    QVector<bool> activeColumns{getActiveColumns()};
+
+    // Heaviest columns which can be deselected go first.
+    QVector<std::pair<quint64, QTreeWidgetItem*>> candidates;
+    for (int i = 0; i < ui->columnsList->topLevelItemCount(); ++i)
+    {
+        QTreeWidgetItem* currentItem{ui->columnsList->topLevelItem(i)};
+        if (currentItem->flags().testFlag(Qt::ItemIsUserCheckable) &&
+            currentItem->checkState(0) == Qt::Checked)
+            candidates.append(
+                {dataset_->estimateColumnMemory(
+                     currentItem->data(0, Qt::UserRole).toInt(), rowCount),
+                 currentItem});
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const auto& left, const auto& right) {
+                  return left.first > right.first;
+              });
+
+    QStringList droppedColumns;
+    quint64 reducedEstimate{estimate};
+    for (const auto& [columnEstimate, item] : candidates)
+    {
+        if (reducedEstimate <= budget)
+            break;
+        activeColumns[item->data(0, Qt::UserRole).toInt()] = false;
+        reducedEstimate = dataset_->estimateMemory(activeColumns, rowCount);
+        droppedColumns.append(item->text(0));
+    }
+
+    const auto sampleSize{static_cast<unsigned int>(
+        static_cast<double>(rowCount) * budget / estimate)};
+    QString advice{tr("Data may not fit in memory.")};
+    if (reducedEstimate <= budget && !droppedColumns.isEmpty())
+        advice.append(tr(" Consider deselecting columns: ") +
+                      droppedColumns.join(QStringLiteral(", ")) + tr(" or"));
+    else
+        advice.append(tr(" Consider"));
+    advice.append(tr(" loading random sample of ") +
+                  QString::number(std::max(sampleSize, 1U)) + tr(" rows."));
+    return advice;
 }
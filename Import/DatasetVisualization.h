@@ -53,12 +53,23 @@ private:
 
     QString getTypeDisplayNameForGivenColumn(int column) const;
 
+    void setupLoadModeWidgets();
+
+    LoadQuery getLoadQuery() const;
+
     void fillTaggedColumnCombos();
 
     void setAllItemsInColumnsListToState(Qt::CheckState state);
 
     static int getCurrentValueFromCombo(QComboBox* combo);
 
+    unsigned int getRowsToLoad() const;
+
+    QString getMemoryAdvice(quint64 estimate, quint64 budget) const;
+
+    /// Part of available memory which loaded data should fit in.
+    static constexpr double AVAILABLE_MEMORY_RATIO{0.75};
+
     Ui::DatasetVisualization* ui;
 
     const QString typeNameString_{tr("Name")};
@@ -77,8 +88,12 @@ private Q_SLOTS:
 
     void unselectAllClicked();
 
+    void loadModeChanged(int newIndex);
+
     void refreshColumnList(int newIndex);
 
+    void refreshMemoryEstimate();
+
 Q_SIGNALS:
     /**
      * Emit when selected column was changed to sync linked widgets.
@@ -0,0 +1,80 @@
+#include "DsvImportTab.h"
+
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QMessageBox>
+#include <QSplitter>
+
+#include <Common/Configuration.h>
+#include <Datasets/DatasetDsv.h>
+
+#include "ColumnsPreview.h"
+#include "DatasetVisualization.h"
+#include "ui_DsvImportTab.h"
+
+DsvImportTab::DsvImportTab(QWidget* parent)
+    : ImportTab(parent), ui(new Ui::DsvImportTab)
+{
+    ui->setupUi(this);
+
+    connect(ui->openFileButton, &QPushButton::clicked, this,
+            &DsvImportTab::openFileButtonClicked);
+
+    auto [visualization, columnsPreview] =
+        createVisualizationAndColumnPreview();
+
+    auto* centralSplitter{new QSplitter(Qt::Vertical, this)};
+    centralSplitter->addWidget(visualization);
+    centralSplitter->addWidget(columnsPreview);
+
+    ui->verticalLayout->addWidget(centralSplitter);
+}
+
+DsvImportTab::~DsvImportTab() { delete ui; }
+
+std::unique_ptr<Dataset> DsvImportTab::getDataset()
+{
+    std::unique_ptr<Dataset> dataset{ImportTab::getDataset()};
+    if (auto* dsv{qobject_cast<DatasetDsv*>(dataset.get())}; dsv != nullptr)
+        dsv->setFollowing(ui->followCheckBox->isChecked());
+    return dataset;
+}
+
+bool DsvImportTab::getFileInfo(QFileInfo& fileInfo)
+{
+    const QString filePath = QFileDialog::getOpenFileName(
+        this, tr("Open file"), Configuration::getInstance().getImportFilePath(),
+        tr("Delimited text (*.csv *.tsv *.txt)"));
+
+    fileInfo.setFile(filePath);
+    if (!fileIsOk(fileInfo))
+    {
+        QMessageBox::information(this, tr("Access error"),
+                                 tr("Can not access file."));
+        return false;
+    }
+    return true;
+}
+
+void DsvImportTab::openFileButtonClicked()
+{
+    QFileInfo fileInfo;
+    if (!getFileInfo(fileInfo))
+        return;
+
+    Configuration::getInstance().setImportFilePath(fileInfo.canonicalPath());
+    ui->fileNameLineEdit->setText(fileInfo.filePath());
+
+    std::unique_ptr<Dataset> dataset{std::make_unique<DatasetDsv>(
+        getValidDatasetName(fileInfo), fileInfo.canonicalFilePath())};
+    analyzeFile(dataset);
+    if (!dataset->isValid())
+    {
+        QMessageBox::information(this, tr("Wrong file"),
+                                 dataset->getLastError());
+        Q_EMIT datasetIsReady(false);
+        return;
+    }
+
+    setDataset(std::move(dataset));
+}
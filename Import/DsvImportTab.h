@@ -0,0 +1,30 @@
+#pragma once
+
+#include "ImportTab.h"
+
+namespace Ui
+{
+class DsvImportTab;
+}  // namespace Ui
+
+/**
+ * @brief Ui class for importing delimiter separated text files.
+ */
+class DsvImportTab : public ImportTab
+{
+    Q_OBJECT
+public:
+    explicit DsvImportTab(QWidget* parent = nullptr);
+
+    ~DsvImportTab() override;
+
+    std::unique_ptr<Dataset> getDataset() override;
+
+private:
+    bool getFileInfo(QFileInfo& fileInfo);
+
+    Ui::DsvImportTab* ui;
+
+private Q_SLOTS:
+    void openFileButtonClicked();
+};
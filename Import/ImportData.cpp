@@ -7,7 +7,9 @@
 
 #include <Datasets/Dataset.h>
 
+#include "BatchImportTab.h"
 #include "DatasetImportTab.h"
+#include "DsvImportTab.h"
 #include "SpreadsheetsImportTab.h"
 
 ImportData::ImportData(QWidget* parent) : QDialog(parent)
@@ -66,6 +68,14 @@ QTabWidget* ImportData::createTabWidgetWithContent(
     connect(spreadsheetsTab, &ImportTab::datasetIsReady, enableOpenButton);
     tabWidget->addTab(spreadsheetsTab, tr("Spreadsheets"));
 
+    auto* dsvTab{new DsvImportTab(tabWidget)};
+    connect(dsvTab, &ImportTab::datasetIsReady, enableOpenButton);
+    tabWidget->addTab(dsvTab, tr("Text files"));
+
+    auto* batchTab{new BatchImportTab(tabWidget)};
+    connect(batchTab, &ImportTab::datasetIsReady, enableOpenButton);
+    tabWidget->addTab(batchTab, tr("Batch"));
+
     // If no datasets, than switch to spreadsheets tab.
     if (datasetsTab->datasetsAreAvailable())
         tabWidget->setCurrentWidget(datasetsTab);
@@ -1,8 +1,17 @@
 #include "ImportTab.h"
 
+#include <future>
+
+#include <ProgressBarInfinite.h>
+#include <QCoreApplication>
+#include <QFileInfo>
 #include <QHeaderView>
+#include <QTime>
 
+#include <Common/Constants.h>
+#include <Common/DatasetUtilities.h>
 #include <Datasets/Dataset.h>
+#include <Shared/Logger.h>
 
 #include "ColumnsPreview.h"
 #include "DatasetVisualization.h"
@@ -47,3 +56,49 @@ void ImportTab::setDataset(std::unique_ptr<Dataset> dataset)
 
     Q_EMIT datasetIsReady(true);
 }
+
+void ImportTab::analyzeFile(std::unique_ptr<Dataset>& dataset)
+{
+    const QString barTitle{
+        Constants::getProgressBarTitle(Constants::BarTitle::ANALYSING)};
+    ProgressBarInfinite bar(barTitle, nullptr);
+    bar.showDetached();
+    bar.start();
+    QTime performanceTimer;
+    performanceTimer.start();
+
+    QCoreApplication::processEvents();
+
+    auto futureInit{std::async(&Dataset::initialize, dataset.get())};
+    const std::chrono::milliseconds span(1);
+    while (futureInit.wait_for(span) == std::future_status::timeout)
+        QCoreApplication::processEvents();
+    if (!futureInit.get())
+    {
+        LOG(LogTypes::IMPORT_EXPORT, "Last error: " + dataset->getLastError());
+        return;
+    }
+
+    LOG(LogTypes::IMPORT_EXPORT,
+        "Analysed file having " + QString::number(dataset->rowCount()) +
+            " rows in time " +
+            Constants::timeFromTimeToSeconds(performanceTimer) + " seconds.");
+}
+
+bool ImportTab::fileIsOk(const QFileInfo& fileInfo)
+{
+    return fileInfo.exists() && fileInfo.isReadable();
+}
+
+QString ImportTab::getValidDatasetName(const QFileInfo& fileInfo)
+{
+    QString regexpString{DatasetUtilities::getDatasetNameRegExp().replace(
+        QLatin1String("["), QLatin1String("[^"))};
+    QString datasetName{
+        fileInfo.completeBaseName().remove(QRegExp(regexpString))};
+
+    if (datasetName.isEmpty())
+        datasetName = tr("Dataset");
+
+    return datasetName;
+}
@@ -7,6 +7,7 @@
 class Dataset;
 class ColumnsPreview;
 class DatasetVisualization;
+class QFileInfo;
 
 /**
  * @brief Import tabs base class.
@@ -19,7 +20,7 @@ public:
 
     ~ImportTab() override = default;
 
-    std::unique_ptr<Dataset> getDataset();
+    virtual std::unique_ptr<Dataset> getDataset();
 
 protected:
     std::pair<DatasetVisualization*, ColumnsPreview*>
@@ -27,6 +28,12 @@ protected:
 
     void setDataset(std::unique_ptr<Dataset> dataset);
 
+    static void analyzeFile(std::unique_ptr<Dataset>& dataset);
+
+    static bool fileIsOk(const QFileInfo& fileInfo);
+
+    static QString getValidDatasetName(const QFileInfo& fileInfo);
+
 Q_SIGNALS:
     void datasetIsReady(bool);
 };
@@ -1,19 +1,19 @@
 #include "SpreadsheetsImportTab.h"
 
 #include <cmath>
-#include <future>
 
-#include <ProgressBarInfinite.h>
+#include <QFile>
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QSplitter>
+#include <QStandardItemModel>
 
 #include <Common/Configuration.h>
-#include <Common/Constants.h>
-#include <Common/DatasetUtilities.h>
+#include <Common/ImportCache.h>
 #include <Datasets/Dataset.h>
+#include <Datasets/DatasetInner.h>
 #include <Datasets/DatasetOds.h>
 #include <Datasets/DatasetSpreadsheet.h>
 #include <Datasets/DatasetXlsx.h>
@@ -41,40 +41,15 @@ SpreadsheetsImportTab::SpreadsheetsImportTab(QWidget* parent)
     ui->verticalLayout->addWidget(centralSplitter);
 
     ui->sheetCombo->hide();
+    ui->sourceSheetCheckBox->hide();
+    connect(ui->sourceSheetCheckBox, &QCheckBox::toggled, this,
+            &SpreadsheetsImportTab::sheetSelectionChanged);
 }
 
 SpreadsheetsImportTab::~SpreadsheetsImportTab() { delete ui; }
 
-void SpreadsheetsImportTab::analyzeFile(std::unique_ptr<Dataset>& dataset)
-{
-    const QString barTitle{
-        Constants::getProgressBarTitle(Constants::BarTitle::ANALYSING)};
-    ProgressBarInfinite bar(barTitle, nullptr);
-    bar.showDetached();
-    bar.start();
-    QTime performanceTimer;
-    performanceTimer.start();
-
-    QCoreApplication::processEvents();
-
-    auto futureInit{std::async(&Dataset::initialize, dataset.get())};
-    const std::chrono::milliseconds span(1);
-    while (futureInit.wait_for(span) == std::future_status::timeout)
-        QCoreApplication::processEvents();
-    if (!futureInit.get())
-    {
-        LOG(LogTypes::IMPORT_EXPORT, "Last error: " + dataset->getLastError());
-        return;
-    }
-
-    LOG(LogTypes::IMPORT_EXPORT,
-        "Analysed file having " + QString::number(dataset->rowCount()) +
-            " rows in time " +
-            Constants::timeFromTimeToSeconds(performanceTimer) + " seconds.");
-}
-
-std::unique_ptr<Dataset> SpreadsheetsImportTab::createDataset(
-    const QFileInfo& fileInfo)
+std::unique_ptr<DatasetSpreadsheet>
+SpreadsheetsImportTab::createSpreadsheetDataset(const QFileInfo& fileInfo)
 {
     QString datasetName{getValidDatasetName(fileInfo)};
     QString datasetFilePath{fileInfo.canonicalFilePath()};
@@ -86,25 +61,102 @@ std::unique_ptr<Dataset> SpreadsheetsImportTab::createDataset(
     if (fileInfo.suffix().toLower().compare(QLatin1String("xlsx")) == 0)
         dataset = std::make_unique<DatasetXlsx>(datasetName, datasetFilePath);
 
+    return dataset;
+}
+
+std::unique_ptr<Dataset> SpreadsheetsImportTab::createDataset(
+    const QFileInfo& fileInfo, const QStringList& sheets,
+    bool sourceSheetColumn)
+{
+    std::unique_ptr<DatasetSpreadsheet> dataset{
+        createSpreadsheetDataset(fileInfo)};
+    if (dataset == nullptr)
+        return nullptr;
+
+    dataset->setSelectedSheets(sheets);
+    dataset->setSourceSheetColumn(sourceSheetColumn);
+
+    // Cache keeps first sheet only.
+    const QString cacheFilePath{ImportCache::getCacheFilePath(fileInfo)};
+    if (sheets.isEmpty() && !sourceSheetColumn && !cacheFilePath.isEmpty() &&
+        QFile::exists(cacheFilePath))
+    {
+        LOG(LogTypes::IMPORT_EXPORT,
+            "Using cached import " + cacheFilePath + " of " +
+                fileInfo.canonicalFilePath());
+        ImportCache::markUsed(cacheFilePath);
+        return std::make_unique<DatasetInner>(dataset->getName(),
+                                              cacheFilePath);
+    }
+
+    dataset->setCacheFilePath(cacheFilePath);
     return std::move(dataset);
 }
 
-bool SpreadsheetsImportTab::fileIsOk(const QFileInfo& fileInfo)
+QStringList SpreadsheetsImportTab::getSheetNames(const Dataset& dataset,
+                                                 const QFileInfo& fileInfo)
 {
-    return fileInfo.exists() && fileInfo.isReadable();
+    if (const auto* spreadsheet{
+            qobject_cast<const DatasetSpreadsheet*>(&dataset)};
+        spreadsheet != nullptr)
+        return spreadsheet->getSheetNames();
+
+    // Cached dataset does not know sheets of source file.
+    std::unique_ptr<DatasetSpreadsheet> spreadsheet{
+        createSpreadsheetDataset(fileInfo)};
+    if (spreadsheet == nullptr || !spreadsheet->loadSheetNames())
+        return {};
+    return spreadsheet->getSheetNames();
 }
 
-QString SpreadsheetsImportTab::getValidDatasetName(const QFileInfo& fileInfo)
+void SpreadsheetsImportTab::fillSheetCombo(const QStringList& sheetNames)
 {
-    QString regexpString{DatasetUtilities::getDatasetNameRegExp().replace(
-        QLatin1String("["), QLatin1String("[^"))};
-    QString datasetName{
-        fileInfo.completeBaseName().remove(QRegExp(regexpString))};
+    auto* model{new QStandardItemModel(ui->sheetCombo)};
+    for (const QString& sheetName : sheetNames)
+    {
+        auto* item{new QStandardItem(sheetName)};
+        item->setFlags(Qt::ItemIsUserCheckable | Qt::ItemIsEnabled);
+        item->setCheckState(model->rowCount() == 0 ? Qt::Checked
+                                                   : Qt::Unchecked);
+        model->appendRow(item);
+    }
+    connect(model, &QStandardItemModel::itemChanged, this,
+            &SpreadsheetsImportTab::sheetSelectionChanged);
+    ui->sheetCombo->setModel(model);
+
+    const bool severalSheets{sheetNames.size() > 1};
+    ui->sheetCombo->setVisible(severalSheets);
+    ui->sourceSheetCheckBox->blockSignals(true);
+    ui->sourceSheetCheckBox->setChecked(false);
+    ui->sourceSheetCheckBox->blockSignals(false);
+    ui->sourceSheetCheckBox->setVisible(severalSheets);
+    analysedSheets_ = sheetNames.mid(0, 1);
+    analysedSourceSheetColumn_ = false;
+}
 
-    if (datasetName.isEmpty())
-        datasetName = tr("Dataset");
+QStringList SpreadsheetsImportTab::getCheckedSheets() const
+{
+    QStringList sheets;
+    const auto* model{
+        qobject_cast<const QStandardItemModel*>(ui->sheetCombo->model())};
+    for (int row = 0; row < model->rowCount(); ++row)
+        if (model->item(row)->checkState() == Qt::Checked)
+            sheets.append(model->item(row)->text());
+    return sheets;
+}
 
-    return datasetName;
+void SpreadsheetsImportTab::setCheckedSheets(const QStringList& sheets)
+{
+    auto* model{qobject_cast<QStandardItemModel*>(ui->sheetCombo->model())};
+    model->blockSignals(true);
+    for (int row = 0; row < model->rowCount(); ++row)
+        model->item(row)->setCheckState(
+            sheets.contains(model->item(row)->text()) ? Qt::Checked
+                                                      : Qt::Unchecked);
+    model->blockSignals(false);
+    ui->sourceSheetCheckBox->blockSignals(true);
+    ui->sourceSheetCheckBox->setChecked(analysedSourceSheetColumn_);
+    ui->sourceSheetCheckBox->blockSignals(false);
 }
 
 bool SpreadsheetsImportTab::getFileInfo(QFileInfo& fileInfo)
@@ -132,7 +184,7 @@ void SpreadsheetsImportTab::openFileButtonClicked()
     Configuration::getInstance().setImportFilePath(fileInfo.canonicalPath());
     ui->fileNameLineEdit->setText(fileInfo.filePath());
 
-    std::unique_ptr<Dataset> dataset{createDataset(fileInfo)};
+    std::unique_ptr<Dataset> dataset{createDataset(fileInfo, {}, false)};
     if (dataset == nullptr)
     {
         QMessageBox::information(this, tr("Wrong file"),
@@ -142,5 +194,36 @@ void SpreadsheetsImportTab::openFileButtonClicked()
     }
 
     analyzeFile(dataset);
+    fillSheetCombo(getSheetNames(*dataset, fileInfo));
+    setDataset(std::move(dataset));
+}
+
+void SpreadsheetsImportTab::sheetSelectionChanged()
+{
+    const QStringList sheets{getCheckedSheets()};
+    const bool sourceSheetColumn{ui->sourceSheetCheckBox->isChecked()};
+    if (sheets.isEmpty())
+    {
+        setCheckedSheets(analysedSheets_);
+        return;
+    }
+
+    const QFileInfo fileInfo(ui->fileNameLineEdit->text());
+    std::unique_ptr<Dataset> dataset{
+        createDataset(fileInfo, sheets, sourceSheetColumn)};
+    if (dataset == nullptr)
+        return;
+
+    analyzeFile(dataset);
+    if (!dataset->isValid())
+    {
+        QMessageBox::information(this, tr("Sheets not loaded"),
+                                 dataset->getLastError());
+        setCheckedSheets(analysedSheets_);
+        return;
+    }
+
+    analysedSheets_ = sheets;
+    analysedSourceSheetColumn_ = sourceSheetColumn;
     setDataset(std::move(dataset));
 }
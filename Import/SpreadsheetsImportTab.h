@@ -22,18 +22,34 @@ public:
     ~SpreadsheetsImportTab() override;
 
 private:
-    static void analyzeFile(std::unique_ptr<Dataset>& dataset);
+    static std::unique_ptr<DatasetSpreadsheet> createSpreadsheetDataset(
+        const QFileInfo& fileInfo);
 
-    static std::unique_ptr<Dataset> createDataset(const QFileInfo& fileInfo);
+    static std::unique_ptr<Dataset> createDataset(const QFileInfo& fileInfo,
+                                                  const QStringList& sheets,
+                                                  bool sourceSheetColumn);
 
-    static bool fileIsOk(const QFileInfo& fileInfo);
+    static QStringList getSheetNames(const Dataset& dataset,
+                                     const QFileInfo& fileInfo);
 
-    static QString getValidDatasetName(const QFileInfo& fileInfo);
+    void fillSheetCombo(const QStringList& sheetNames);
+
+    QStringList getCheckedSheets() const;
+
+    void setCheckedSheets(const QStringList& sheets);
 
     bool getFileInfo(QFileInfo& fileInfo);
 
     Ui::SpreadsheetsImportTab* ui;
 
+    /// Sheets of currently analysed dataset.
+    QStringList analysedSheets_;
+
+    /// Source sheet column state of currently analysed dataset.
+    bool analysedSourceSheetColumn_{false};
+
 private Q_SLOTS:
     void openFileButtonClicked();
+
+    void sheetSelectionChanged();
 };
@@ -1,9 +1,14 @@
 #include "DataView.h"
 
+#include <algorithm>
+
 #include <QApplication>
 #include <QHeaderView>
 #include <QMouseEvent>
+#include <QTimer>
 
+#include <Common/MemoryBudget.h>
+#include <Common/MemoryUtilities.h>
 #include <Common/TimeLogger.h>
 
 #include "DateDelegate.h"
@@ -21,8 +26,12 @@ DataView::DataView(QWidget* parent)
 
     initHorizontalHeader();
     initVerticalHeader();
+
+    MemoryBudget::getInstance().registerReporter(this);
 }
 
+DataView::~DataView() { MemoryBudget::getInstance().unregisterReporter(this); }
+
 void DataView::setModel(QAbstractItemModel* model)
 {
     const auto* proxyModel{qobject_cast<FilteringProxyModel*>(model)};
@@ -33,6 +42,9 @@ void DataView::setModel(QAbstractItemModel* model)
 
     QTableView::setModel(model);
     groupByColumn_ = parentModel->getDefaultGroupingColumn();
+
+    connect(model, &QAbstractItemModel::rowsInserted, this,
+            &DataView::rowsWereInserted);
 }
 
 void DataView::groupingColumnChanged(int column)
@@ -92,6 +104,14 @@ void DataView::setDelegate(int column, const TableModel* parentModel)
 
 QVector<TransactionData> DataView::fillDataFromSelection(
     int groupByColumn) const
+{
+    return fillDataFromRows(0, getProxyModel()->rowCount() - 1,
+                            groupByColumn, true);
+}
+
+QVector<TransactionData> DataView::fillDataFromRows(int first, int last,
+                                                    int groupByColumn,
+                                                    bool processEvents) const
 {
     const TableModel* parentModel{getParentModel()};
 
@@ -107,9 +127,9 @@ QVector<TransactionData> DataView::fillDataFromSelection(
     const int batchSize{1000};
 
     const FilteringProxyModel* proxyModel{getProxyModel()};
-    for (int i = 0; i < proxyModel->rowCount(); ++i)
+    for (int i = first; i <= last; ++i)
     {
-        if (i % batchSize == 0)
+        if (processEvents && i % batchSize == 0)
             QApplication::processEvents();
 
         if (!selectionModelOfView->isSelected(proxyModel->index(i, 0)))
@@ -168,6 +188,109 @@ void DataView::keyPressEvent(QKeyEvent* event)
         recomputeAllData();
 }
 
+void DataView::rowsWereInserted([[maybe_unused]] const QModelIndex& parent,
+                                int first, int last)
+{
+    // Rows appended to followed dataset join plots, when plots are shown.
+    if (selectionMode() != QAbstractItemView::MultiSelection)
+        return;
+
+    selectionModel()->select(
+        QItemSelection(model()->index(first, 0),
+                       model()->index(last, model()->columnCount() - 1)),
+        QItemSelectionModel::Select);
+
+    const QVector<TransactionData> insertedData{
+        fillDataFromRows(first, last, groupByColumn_, false)};
+    if (insertedData.isEmpty())
+        return;
+
+    // Rows of one batch can be inserted in many ranges when view is sorted.
+    if (insertedData_.isEmpty())
+        QTimer::singleShot(0, this, &DataView::appendInsertedData);
+    insertedData_.append(insertedData);
+}
+
+void DataView::appendInsertedData()
+{
+    plotDataProvider_.append(insertedData_);
+    insertedData_.clear();
+}
+
+quint64 DataView::getUsedMemory() const
+{
+    quint64 usedMemory{MemoryUtilities::getVectorMemory(insertedData_) +
+                       static_cast<quint64>(selectedRows_.size()) / 8};
+    if (selectionModel() == nullptr)
+        return usedMemory;
+
+    // Each range keeps two persistent indexes with own private data.
+    const quint64 persistentIndexSize{sizeof(QModelIndex) + 2 * sizeof(int)};
+    const quint64 rangeSize{sizeof(void*) + sizeof(QItemSelectionRange) +
+                            2 * persistentIndexSize};
+    return usedMemory +
+           static_cast<quint64>(selectionModel()->selection().size()) *
+               rangeSize;
+}
+
+void DataView::storeSelection()
+{
+    const FilteringProxyModel* proxyModel{getProxyModel()};
+    selectedRows_ = QBitArray(proxyModel->sourceModel()->rowCount());
+    for (const QModelIndex& index : selectionModel()->selectedRows())
+        selectedRows_.setBit(proxyModel->mapToSource(index).row());
+}
+
+void DataView::restoreSelection()
+{
+    // Consecutive rows of view are merged into single range.
+    const FilteringProxyModel* proxyModel{getProxyModel()};
+    const int lastColumn{proxyModel->columnCount() - 1};
+    QItemSelection selection;
+    int first{-1};
+    for (int row = 0; row <= proxyModel->rowCount(); ++row)
+    {
+        bool selected{false};
+        if (row < proxyModel->rowCount())
+        {
+            const int sourceRow{
+                proxyModel->mapToSource(proxyModel->index(row, 0)).row()};
+            selected = sourceRow < selectedRows_.size() &&
+                       selectedRows_.testBit(sourceRow);
+        }
+
+        if (selected && first == -1)
+            first = row;
+        if (!selected && first != -1)
+        {
+            selection.append(
+                QItemSelectionRange(proxyModel->index(first, 0),
+                                    proxyModel->index(row - 1, lastColumn)));
+            first = -1;
+        }
+    }
+    selectionModel()->select(selection, QItemSelectionModel::ClearAndSelect);
+    selectedRows_.clear();
+}
+
+QVector<int> DataView::getSelectedSourceRows() const
+{
+    const FilteringProxyModel* proxyModel{getProxyModel()};
+    QVector<int> rows;
+    for (const QModelIndex& index : selectionModel()->selectedRows())
+        rows.append(proxyModel->mapToSource(index).row());
+
+    if (rows.isEmpty())
+    {
+        rows.reserve(proxyModel->rowCount());
+        for (int row = 0; row < proxyModel->rowCount(); ++row)
+            rows.append(
+                proxyModel->mapToSource(proxyModel->index(row, 0)).row());
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
 const PlotDataProvider& DataView::getPlotDataProvider() const
 {
     return plotDataProvider_;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <MemoryReporter.h>
+#include <QBitArray>
 #include <QTableView>
 
 #include "PlotDataProvider.h"
@@ -10,13 +12,13 @@ class FilteringProxyModel;
 /**
  * @brief 2d view for data.
  */
-class DataView : public QTableView
+class DataView : public QTableView, public MemoryReporter
 {
     Q_OBJECT
 public:
     explicit DataView(QWidget* parent = nullptr);
 
-    ~DataView() override = default;
+    ~DataView() override;
 
     void setModel(QAbstractItemModel* model) override;
 
@@ -27,6 +29,30 @@ public:
      */
     void recomputeAllData();
 
+    /**
+     * @brief Get memory used by selection and data waiting for plots.
+     * @return Used bytes.
+     */
+    quint64 getUsedMemory() const override;
+
+    /**
+     * @brief Store bitmap of selected source rows, used when rows of source
+     * model are going to be temporarily removed.
+     */
+    void storeSelection();
+
+    /**
+     * @brief Select rows stored by storeSelection() and release bitmap.
+     */
+    void restoreSelection();
+
+    /**
+     * @brief Get rows of source model selected in view. When nothing is
+     * selected, rows passing filters are taken.
+     * @return Source rows in ascending order.
+     */
+    QVector<int> getSelectedSourceRows() const;
+
 public Q_SLOTS:
     /**
      * @brief Force recomputing of data because of grouping column changed.
@@ -47,6 +73,20 @@ private:
      */
     QVector<TransactionData> fillDataFromSelection(int groupByColumn) const;
 
+    /**
+     * @brief Get data of selected rows in given range.
+     * @param first First row.
+     * @param last Last row.
+     * @param groupByColumn Column used in grouping.
+     * @param processEvents Process events between batches of rows. Must be
+     * false when called from model signal handler, as events could change
+     * model in the middle.
+     * @return Container of structures containing data, price and grouping data.
+     */
+    QVector<TransactionData> fillDataFromRows(int first, int last,
+                                              int groupByColumn,
+                                              bool processEvents) const;
+
     void initHorizontalHeader();
 
     void initVerticalHeader();
@@ -65,4 +105,15 @@ private:
     int groupByColumn_{0};
 
     PlotDataProvider plotDataProvider_;
+
+    /// Data of inserted rows waiting to be passed to plots.
+    QVector<TransactionData> insertedData_;
+
+    /// Source rows selected before source model was reset.
+    QBitArray selectedRows_;
+
+private Q_SLOTS:
+    void rowsWereInserted(const QModelIndex& parent, int first, int last);
+
+    void appendInsertedData();
 };
@@ -1,5 +1,7 @@
 #include "FilteringProxyModel.h"
 
+#include <MemoryBudget.h>
+#include <MemoryUtilities.h>
 #include <QDate>
 
 #include "TableModel.h"
@@ -7,6 +9,12 @@
 FilteringProxyModel::FilteringProxyModel(QObject* parent)
     : QSortFilterProxyModel(parent)
 {
+    MemoryBudget::getInstance().registerReporter(this);
+}
+
+FilteringProxyModel::~FilteringProxyModel()
+{
+    MemoryBudget::getInstance().unregisterReporter(this);
 }
 
 const TableModel* FilteringProxyModel::getParentModel() const
@@ -18,6 +26,7 @@ void FilteringProxyModel::setStringFilter(int column,
                                           const QStringList& bannedStrings)
 {
     stringsRestrictions_[column] = bannedStrings;
+    acceptedRows_.clear();
     invalidate();
 }
 
@@ -25,15 +34,52 @@ void FilteringProxyModel::setDateFilter(int column, QDate from, QDate to,
                                         bool filterEmptyDates)
 {
     datesRestrictions_[column] = {from, to, filterEmptyDates};
+    acceptedRows_.clear();
     invalidate();
 }
 
 void FilteringProxyModel::setNumericFilter(int column, double from, double to)
 {
     numericRestrictions_[column] = {from, to};
+    acceptedRows_.clear();
     invalidate();
 }
 
+quint64 FilteringProxyModel::getUsedMemory() const
+{
+    if (sourceModel() == nullptr)
+        return 0;
+
+    // Mapping keeps proxy position of each source item and source position
+    // of each proxy item, for rows and columns.
+    const auto mappedItems{static_cast<quint64>(
+        sourceModel()->rowCount() + rowCount() +
+        sourceModel()->columnCount() + columnCount())};
+    quint64 usedMemory{mappedItems * sizeof(int) +
+                       4 * MemoryUtilities::ARRAY_HEADER_SIZE +
+                       static_cast<quint64>(acceptedRows_.size()) / 8};
+
+    for (const auto& [column, bannedStrings] : stringsRestrictions_)
+        for (const QString& string : bannedStrings)
+            usedMemory +=
+                sizeof(void*) + MemoryUtilities::getStringMemory(string);
+    return usedMemory;
+}
+
+void FilteringProxyModel::storeAcceptedRows()
+{
+    acceptedRows_ = QBitArray(sourceModel()->rowCount());
+    for (int row = 0; row < rowCount(); ++row)
+        acceptedRows_.setBit(mapToSource(index(row, 0)).row());
+}
+
+void FilteringProxyModel::applyStoredAcceptedRows()
+{
+    // Mapping is built lazily, asking for row count forces it.
+    rowCount();
+    acceptedRows_.clear();
+}
+
 bool FilteringProxyModel::acceptRowAccordingToStringRestrictions(
     int sourceRow, const QModelIndex& sourceParent) const
 {
@@ -85,7 +131,23 @@ bool FilteringProxyModel::acceptRowAccordingToNumericRestrictions(
 bool FilteringProxyModel::filterAcceptsRow(
     int sourceRow, const QModelIndex& sourceParent) const
 {
+    if (sourceRow < acceptedRows_.size())
+        return acceptedRows_.testBit(sourceRow);
+
     return acceptRowAccordingToStringRestrictions(sourceRow, sourceParent) &&
            acceptRowAccordingToDateRestrictions(sourceRow, sourceParent) &&
            acceptRowAccordingToNumericRestrictions(sourceRow, sourceParent);
 }
+
+bool FilteringProxyModel::lessThan(const QModelIndex& left,
+                                   const QModelIndex& right) const
+{
+    const TableModel* parentModel{getParentModel()};
+    if (parentModel == nullptr || !parentModel->hasSortRanks() ||
+        sortRole() != Qt::DisplayRole ||
+        sortCaseSensitivity() != Qt::CaseSensitive || isSortLocaleAware())
+        return QSortFilterProxyModel::lessThan(left, right);
+
+    return parentModel->getSortRank(left.row(), left.column()) <
+           parentModel->getSortRank(right.row(), right.column());
+}
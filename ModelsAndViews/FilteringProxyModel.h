@@ -1,5 +1,7 @@
 #pragma once
 
+#include <MemoryReporter.h>
+#include <QBitArray>
 #include <QSortFilterProxyModel>
 
 class TableModel;
@@ -7,13 +9,14 @@ class TableModel;
 /**
  * @brief Filtering model for 2d data.
  */
-class FilteringProxyModel : public QSortFilterProxyModel
+class FilteringProxyModel : public QSortFilterProxyModel,
+                            public MemoryReporter
 {
     Q_OBJECT
 public:
     explicit FilteringProxyModel(QObject* parent = nullptr);
 
-    ~FilteringProxyModel() override = default;
+    ~FilteringProxyModel() override;
 
     /**
      * @brief get pointer to parent model.
@@ -44,6 +47,25 @@ public:
      */
     void setNumericFilter(int column, double from, double to);
 
+    /**
+     * @brief Get memory used by mapping between source and proxy rows and
+     * columns and by filters.
+     * @return Used bytes.
+     */
+    quint64 getUsedMemory() const override;
+
+    /**
+     * @brief Store bitmap of source rows accepted by filters. Until filters
+     * change, accepted rows are taken from bitmap instead of evaluating
+     * filters, e.g. when rows of hibernated source model come back.
+     */
+    void storeAcceptedRows();
+
+    /**
+     * @brief Build mapping of rows using stored bitmap and release it.
+     */
+    void applyStoredAcceptedRows();
+
 protected:
     /**
      * @brief Determine if row should be shown or not.
@@ -54,6 +76,15 @@ protected:
     bool filterAcceptsRow(int sourceRow,
                           const QModelIndex& sourceParent) const override;
 
+    /**
+     * @brief Compare items using precomputed sort ranks when available.
+     * @param left left index.
+     * @param right right index.
+     * @return true if left item is less than right one.
+     */
+    bool lessThan(const QModelIndex& left,
+                  const QModelIndex& right) const override;
+
 private:
     bool acceptRowAccordingToStringRestrictions(
         int sourceRow, const QModelIndex& sourceParent) const;
@@ -72,4 +103,7 @@ private:
 
     /// Filter set for numeric.
     std::map<int, std::pair<double, double> > numericRestrictions_;
+
+    /// Source rows accepted by filters, empty when not stored.
+    QBitArray acceptedRows_;
 };
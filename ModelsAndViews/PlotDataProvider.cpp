@@ -1,150 +1,262 @@
 #include "PlotDataProvider.h"
 
+#include <MemoryBudget.h>
+#include <MemoryUtilities.h>
 #include <QwtBleUtilities.h>
+#include <QMetaMethod>
 #include <QPointF>
 
-PlotDataProvider::PlotDataProvider(QObject* parent) : QObject(parent) {}
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+PlotDataProvider::PlotDataProvider(QObject* parent) : QObject(parent)
+{
+    MemoryBudget::getInstance().registerReporter(this);
+}
+
+PlotDataProvider::~PlotDataProvider()
+{
+    MemoryBudget::getInstance().unregisterReporter(this);
+}
 
 void PlotDataProvider::recompute(QVector<TransactionData> newCalcData,
                                  ColumnType columnFormat)
 {
-    calcData_ = std::move(newCalcData);
-    quantiles_ = computeQuantiles(calcData_);
+    released_ = false;
+    sums_ = RegressionSums();
+    points_.clear();
+    values_.clear();
+    sortedValues_.clear();
+    accumulate(newCalcData);
 
-    recomputeGroupingData(calcData_, columnFormat);
+    recomputeGroupingData(std::move(newCalcData), columnFormat);
 
-    auto [points, linearRegression] = computePointsAndRegression();
+    emitBasicData();
+}
 
-    QVector<double> yAxisValues;
-    yAxisValues.reserve(points.size());
-    for (const auto& point : qAsConst(points))
-        yAxisValues.append(point.y());
+void PlotDataProvider::append(const QVector<TransactionData>& appendedCalcData)
+{
+    if (appendedCalcData.isEmpty() || released_)
+        return;
 
-    Q_EMIT basicPlotDataChanged(std::move(points), quantiles_,
-                                std::move(linearRegression));
+    accumulate(appendedCalcData);
 
-    // Currently only histogram plot is attached under this signal.
-    Q_EMIT fundamentalDataChanged(std::move(yAxisValues), quantiles_);
+    calcData_.append(appendedCalcData);
+    if (ColumnType::STRING == columnFormat_)
+        accumulateGroups(appendedCalcData);
+    emitGroupingData();
+
+    emitBasicData();
 }
 
 void PlotDataProvider::recomputeGroupingData(QVector<TransactionData> calcData,
                                              ColumnType columnFormat)
 {
     calcData_ = std::move(calcData);
+    columnFormat_ = columnFormat;
+    groups_.clear();
+    groupsQuantiles_.clear();
+
+    if (ColumnType::STRING == columnFormat_)
+        accumulateGroups(calcData_);
+    emitGroupingData();
+}
+
+quint64 PlotDataProvider::getUsedMemory() const
+{
+    quint64 usedMemory{MemoryUtilities::getVectorMemory(calcData_) +
+                       MemoryUtilities::getVectorMemory(points_) +
+                       MemoryUtilities::getVectorMemory(values_) +
+                       MemoryUtilities::getVectorMemory(sortedValues_)};
+
+    // Map nodes hold key, value and pointers to parent and children.
+    const quint64 mapNodeOverhead{3 * sizeof(void*)};
+    for (auto it{groups_.constBegin()}; it != groups_.constEnd(); ++it)
+        usedMemory += mapNodeOverhead + sizeof(QString) +
+                      sizeof(QVector<double>) +
+                      MemoryUtilities::getStringMemory(it.key()) +
+                      MemoryUtilities::getVectorMemory(it.value());
+    usedMemory += static_cast<quint64>(groupsQuantiles_.size()) *
+                  (mapNodeOverhead + sizeof(QString) + sizeof(Quantiles));
+    return usedMemory;
+}
 
-    if (ColumnType::STRING != columnFormat)
+quint64 PlotDataProvider::getCachedMemory() const
+{
+    return isUsedByPlots() ? 0 : getUsedMemory();
+}
+
+quint64 PlotDataProvider::releaseCachedMemory()
+{
+    const quint64 releasedMemory{getCachedMemory()};
+    if (releasedMemory == 0)
+        return 0;
+
+    calcData_ = QVector<TransactionData>();
+    points_ = QVector<QPointF>();
+    values_ = QVector<double>();
+    sortedValues_ = QVector<double>();
+    groups_.clear();
+    groupsQuantiles_.clear();
+    sums_ = RegressionSums();
+    quantiles_ = Quantiles();
+    released_ = true;
+    return releasedMemory;
+}
+
+bool PlotDataProvider::isUsedByPlots() const
+{
+    return isSignalConnected(QMetaMethod::fromSignal(
+               &PlotDataProvider::basicPlotDataChanged)) ||
+           isSignalConnected(QMetaMethod::fromSignal(
+               &PlotDataProvider::fundamentalDataChanged)) ||
+           isSignalConnected(QMetaMethod::fromSignal(
+               &PlotDataProvider::groupingPlotDataChanged));
+}
+
+void PlotDataProvider::accumulate(const QVector<TransactionData>& calcData)
+{
+    const int first{values_.size()};
+    points_.reserve(points_.size() + calcData.size());
+    values_.reserve(values_.size() + calcData.size());
+    for (const auto& transactionData : calcData)
     {
-        Q_EMIT groupingPlotDataChanged({}, {}, quantiles_);
-        return;
+        const double x{static_cast<double>(
+            QwtBleUtilities::getStartOfTheWorld().daysTo(
+                transactionData.date_))};
+        const double y{transactionData.pricePerMeter_};
+        if (points_.isEmpty())
+        {
+            sums_.minX_ = x;
+            sums_.maxX_ = x;
+        }
+        points_.append({x, y});
+        values_.append(y);
+
+        sums_.sumX_ += x;
+        sums_.sumY_ += y;
+        sums_.sumXX_ += x * x;
+        sums_.sumXY_ += x * y;
+        sums_.minX_ = std::min(sums_.minX_, x);
+        sums_.maxX_ = std::max(sums_.maxX_, x);
     }
 
-    auto [names, quantilesForIntervals] = fillDataForStringGrouping(calcData_);
-    Q_EMIT groupingPlotDataChanged(
-        std::move(names), std::move(quantilesForIntervals), quantiles_);
+    mergeSorted(sortedValues_, values_.mid(first));
+    quantiles_ = computeQuantiles(sortedValues_);
 }
 
-std::tuple<QVector<QString>, QVector<Quantiles>>
-PlotDataProvider::fillDataForStringGrouping(
+void PlotDataProvider::accumulateGroups(
     const QVector<TransactionData>& calcData)
 {
-    QVector<QString> names;
-    QVector<Quantiles> quantilesForIntervals;
-    QMap<QString, QVector<double>> map;
-    const int dataSize = calcData.size();
-
     // Group by name/string.
-    for (int i = 0; i < dataSize; ++i)
-        map[calcData.at(i).groupedBy_.toString()].append(
-            calcData.at(i).pricePerMeter_);
+    QMap<QString, QVector<double>> newGroupsValues;
+    for (const auto& transactionData : calcData)
+        newGroupsValues[transactionData.groupedBy_.toString()].append(
+            transactionData.pricePerMeter_);
 
-    // For each group calculate quantiles and create names.
-    auto iterator = map.begin();
-    while (iterator != map.end())
+    for (auto it{newGroupsValues.begin()}; it != newGroupsValues.end(); ++it)
     {
-        names.append(iterator.key());
-        Quantiles quantiles;
-        quantiles.init(iterator.value());
-        quantilesForIntervals.append(quantiles);
-        ++iterator;
+        QVector<double>& groupValues{groups_[it.key()]};
+        mergeSorted(groupValues, std::move(it.value()));
+        groupsQuantiles_[it.key()] = computeQuantiles(groupValues);
     }
+}
 
-    return {names, quantilesForIntervals};
+void PlotDataProvider::mergeSorted(QVector<double>& sortedValues,
+                                   QVector<double> newValues)
+{
+    std::sort(newValues.begin(), newValues.end());
+    const int middle{sortedValues.size()};
+    sortedValues.append(newValues);
+    std::inplace_merge(sortedValues.begin(), sortedValues.begin() + middle,
+                       sortedValues.end());
 }
 
-std::tuple<QVector<QPointF>, QVector<QPointF>>
-PlotDataProvider::computePointsAndRegression()
+Quantiles PlotDataProvider::computeQuantiles(
+    const QVector<double>& sortedValues)
 {
-    int dataSize = calcData_.size();
-    if (dataSize <= 0)
-        return {{}, {}};
+    Quantiles quantiles;
+    const int count{sortedValues.size()};
+    if (count == 0)
+        return quantiles;
+
+    // Linear interpolation between closest ranks, same as Quantiles::init().
+    const auto quantile{[&sortedValues, count](double fraction) {
+        const double position{fraction * (count - 1)};
+        const int lower{static_cast<int>(position)};
+        const int upper{std::min(lower + 1, count - 1)};
+        return sortedValues[lower] +
+               (position - lower) * (sortedValues[upper] - sortedValues[lower]);
+    }};
+    quantiles.count_ = count;
+    quantiles.min_ = sortedValues.constFirst();
+    quantiles.max_ = sortedValues.constLast();
+    quantiles.q10_ = quantile(.1);
+    quantiles.q25_ = quantile(.25);
+    quantiles.q50_ = quantile(.5);
+    quantiles.q75_ = quantile(.75);
+    quantiles.q90_ = quantile(.9);
 
-    double sumX = 0.;
-    double sumY = 0.;
-    double sumXX = 0.;
-    double sumXY = 0.;
-    double minX = 0.;
-    double maxX = 0.;
-    bool set = false;
+    const double mean{
+        std::accumulate(sortedValues.cbegin(), sortedValues.cend(), 0.) /
+        count};
+    double squaresSum{0.};
+    for (const double value : sortedValues)
+        squaresSum += (value - mean) * (value - mean);
+    quantiles.mean_ = mean;
+    quantiles.stdDev_ = std::sqrt(squaresSum / count);
+    return quantiles;
+}
 
-    QVector<QPointF> data;
-    data.reserve(dataSize);
-    for (int i = 0; i < dataSize; ++i)
+void PlotDataProvider::emitGroupingData()
+{
+    if (ColumnType::STRING != columnFormat_)
     {
-        const QDate& date{calcData_.at(i).date_};
-        double x{static_cast<double>(
-            QwtBleUtilities::getStartOfTheWorld().daysTo(date))};
-        auto y{calcData_.at(i).pricePerMeter_};
-        data.append({x, y});
-
-        sumX += x;
-        sumY += y;
-        sumXX += x * x;
-        sumXY += x * y;
-
-        if (!set)
-        {
-            set = true;
-            minX = x;
-            maxX = x;
-        }
-        else
-        {
-            if (minX > x)
-                minX = x;
-            if (maxX < x)
-                maxX = x;
-        }
+        Q_EMIT groupingPlotDataChanged({}, {}, quantiles_);
+        return;
     }
 
-    quantiles_.minX_ = minX;
-    quantiles_.maxX_ = maxX;
-
-    // Calc linear regression and create points.
-    double a{(dataSize * sumXY - sumX * sumY) /
-             (dataSize * sumXX - sumX * sumX)};
-    double b{sumY / dataSize - a * sumX / dataSize};
+    QVector<QString> names;
+    QVector<Quantiles> quantilesForIntervals;
+    for (auto it{groupsQuantiles_.constBegin()};
+         it != groupsQuantiles_.constEnd(); ++it)
+    {
+        names.append(it.key());
+        quantilesForIntervals.append(it.value());
+    }
+    Q_EMIT groupingPlotDataChanged(
+        std::move(names), std::move(quantilesForIntervals), quantiles_);
+}
 
-    QPointF linearRegressionFrom(minX, a * minX + b);
-    QPointF linearRegressionTo(maxX, a * maxX + b);
+void PlotDataProvider::emitBasicData()
+{
     QVector<QPointF> linearRegression;
-    linearRegression.append(linearRegressionFrom);
-    linearRegression.append(linearRegressionTo);
+    if (!points_.isEmpty())
+    {
+        quantiles_.minX_ = sums_.minX_;
+        quantiles_.maxX_ = sums_.maxX_;
+        linearRegression = computeLinearRegression();
+    }
 
-    return {data, linearRegression};
+    Q_EMIT basicPlotDataChanged(points_, quantiles_,
+                                std::move(linearRegression));
+
+    // Currently only histogram plot is attached under this signal.
+    Q_EMIT fundamentalDataChanged(values_, quantiles_);
 }
 
-Quantiles PlotDataProvider::computeQuantiles(
-    const QVector<TransactionData>& transactionData)
+QVector<QPointF> PlotDataProvider::computeLinearRegression() const
 {
-    Quantiles quantiles;
-    int dataSize = transactionData.size();
-    if (dataSize != 0)
-    {
-        QVector<double> valuePerUnit{};
-        valuePerUnit.reserve(dataSize);
-        for (int i = 0; i < dataSize; ++i)
-            valuePerUnit.push_back(transactionData.at(i).pricePerMeter_);
-        quantiles.init(std::move(valuePerUnit));
-    }
-    return quantiles;
+    const double dataSize{static_cast<double>(points_.size())};
+    const double a{(dataSize * sums_.sumXY_ - sums_.sumX_ * sums_.sumY_) /
+                   (dataSize * sums_.sumXX_ - sums_.sumX_ * sums_.sumX_)};
+    const double b{sums_.sumY_ / dataSize - a * sums_.sumX_ / dataSize};
+
+    QPointF linearRegressionFrom(sums_.minX_, a * sums_.minX_ + b);
+    QPointF linearRegressionTo(sums_.maxX_, a * sums_.maxX_ + b);
+    QVector<QPointF> linearRegression;
+    linearRegression.append(linearRegressionFrom);
+    linearRegression.append(linearRegressionTo);
+    return linearRegression;
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <ColumnType.h>
+#include <MemoryReporter.h>
 #include <Quantiles.h>
+#include <QMap>
 #include <QObject>
 
 #include "Constants.h"
@@ -10,14 +12,19 @@
 
 /**
  * @brief class used for computation of values for all plots.
+ *
+ * Sums used by regression, points and values grouped by strings are kept
+ * between computations, so appended data is processed without going
+ * through data computed before. When no plot is attached, kept data is
+ * cache which can be released, next plot triggers full recomputation.
  */
-class PlotDataProvider : public QObject
+class PlotDataProvider : public QObject, public MemoryReporter
 {
     Q_OBJECT
 public:
     explicit PlotDataProvider(QObject* parent = nullptr);
 
-    ~PlotDataProvider() override = default;
+    ~PlotDataProvider() override;
 
     /**
      * @brief reCompute all data for plots.
@@ -27,6 +34,12 @@ public:
     void recompute(QVector<TransactionData> newCalcData,
                    ColumnType columnFormat);
 
+    /**
+     * @brief Update data for plots with appended data only.
+     * @param appendedCalcData Data appended to data used so far.
+     */
+    void append(const QVector<TransactionData>& appendedCalcData);
+
     /**
      * @brief recompute data for grouping plot.
      * @param calcData new data used for calculations.
@@ -35,6 +48,12 @@ public:
     void recomputeGroupingData(QVector<TransactionData> calcData,
                                ColumnType columnFormat);
 
+    quint64 getUsedMemory() const override;
+
+    quint64 getCachedMemory() const override;
+
+    quint64 releaseCachedMemory() override;
+
 Q_SIGNALS:
     void groupingPlotDataChanged(QVector<QString> intervalsNames,
                                  QVector<Quantiles> quantilesForIntervals,
@@ -47,21 +66,68 @@ Q_SIGNALS:
 
 private:
     /**
-     * @brief Groups strings and for each group calculate quantiles and names.
-     * @param calcData Data used for calculations.
+     * @brief Sums and ranges used for linear regression.
+     */
+    struct RegressionSums
+    {
+        double sumX_{0.};
+        double sumY_{0.};
+        double sumXX_{0.};
+        double sumXY_{0.};
+        double minX_{0.};
+        double maxX_{0.};
+    };
+
+    void accumulate(const QVector<TransactionData>& calcData);
+
+    void accumulateGroups(const QVector<TransactionData>& calcData);
+
+    /**
+     * @brief Merge new values into sorted ones, only new values get sorted.
+     * @param sortedValues Values sorted ascending.
+     * @param newValues Values to add.
      */
-    static std::tuple<QVector<QString>, QVector<Quantiles>>
-    fillDataForStringGrouping(const QVector<TransactionData>& calcData);
+    static void mergeSorted(QVector<double>& sortedValues,
+                            QVector<double> newValues);
 
     /**
-     * @brief compute data used for simple plots (histogram and basic plots).
+     * @brief Compute quantiles without sorting values again.
+     * @param sortedValues Values sorted ascending.
+     * @return Quantiles of values.
      */
-    std::tuple<QVector<QPointF>, QVector<QPointF>> computePointsAndRegression();
+    static Quantiles computeQuantiles(const QVector<double>& sortedValues);
 
-    static Quantiles computeQuantiles(
-        const QVector<TransactionData>& transactionData);
+    void emitGroupingData();
+
+    void emitBasicData();
+
+    QVector<QPointF> computeLinearRegression() const;
+
+    bool isUsedByPlots() const;
 
     Quantiles quantiles_;
 
     QVector<TransactionData> calcData_;
+
+    ColumnType columnFormat_{ColumnType::UNKNOWN};
+
+    RegressionSums sums_;
+
+    /// Points of basic plot, x is number of days since start of world.
+    QVector<QPointF> points_;
+
+    /// Values of data used so far in order of data.
+    QVector<double> values_;
+
+    /// Values of data used so far sorted ascending.
+    QVector<double> sortedValues_;
+
+    /// Values grouped by strings of grouping column, sorted ascending.
+    QMap<QString, QVector<double>> groups_;
+
+    /// Quantiles of groups, recomputed only for groups got new values.
+    QMap<QString, Quantiles> groupsQuantiles_;
+
+    /// Set when kept data was released, appended data is then ignored.
+    bool released_{false};
 };
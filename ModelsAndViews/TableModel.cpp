@@ -1,24 +1,79 @@
 #include "TableModel.h"
 
+#include <Logger.h>
+#include <MemoryBudget.h>
+#include <MemoryUtilities.h>
+#include <QApplication>
+
 #include "Constants.h"
+#include "DatasetDerived.h"
 
 TableModel::TableModel(std::unique_ptr<Dataset> dataset, QObject* parent)
     : QAbstractTableModel(parent), dataset_(std::move(dataset))
 {
+    connect(&followTimer_, &QTimer::timeout, this,
+            &TableModel::followTimerTimeout);
+    MemoryBudget::getInstance().registerReporter(this);
+    startProfiling();
+}
+
+TableModel::TableModel(const Dataset& loadingDataset, QObject* parent)
+    : QAbstractTableModel(parent)
+{
+    connect(&followTimer_, &QTimer::timeout, this,
+            &TableModel::followTimerTimeout);
+
+    // Columns are rebuilt at end of load, only active ones are kept.
+    for (Column column = 0;
+         column < static_cast<int>(loadingDataset.columnCount()); ++column)
+    {
+        if (!loadingDataset.isColumnActive(column))
+            continue;
+
+        for (const ColumnTag tag : {ColumnTag::DATE, ColumnTag::VALUE})
+            if (const auto [tagged, taggedColumn] =
+                    loadingDataset.getTaggedColumn(tag);
+                tagged && taggedColumn == column)
+                loadingTaggedColumns_[tag] = loadingHeaders_.size();
+        loadingHeaders_.append(loadingDataset.getHeaderName(column));
+        loadingFormats_.append(loadingDataset.getColumnFormat(column));
+    }
+    MemoryBudget::getInstance().registerReporter(this);
+}
+
+TableModel::~TableModel()
+{
+    MemoryBudget::getInstance().unregisterReporter(this);
+
+    // Pending read uses dataset.
+    if (appendedRows_.valid())
+        appendedRows_.wait();
+
+    // Pending profiling notifies model when finished.
+    if (pendingProfiles_.valid())
+        pendingProfiles_.wait();
 }
 
 int TableModel::rowCount([[maybe_unused]] const QModelIndex& parent) const
 {
+    if (isLoading())
+        return loadingRows_.size();
+    if (isHibernated())
+        return 0;
     return static_cast<int>(dataset_->rowCount());
 }
 
 int TableModel::columnCount([[maybe_unused]] const QModelIndex& parent) const
 {
+    if (isLoading())
+        return loadingHeaders_.size();
     return static_cast<int>(dataset_->columnCount());
 }
 
 QVariant TableModel::data(const QModelIndex& index, int role) const
 {
+    if (role == Qt::DisplayRole && isLoading())
+        return loadingRows_[index.row()][index.column()];
     if (role == Qt::DisplayRole)
         return *dataset_->getData(index.row(), index.column());
     return QVariant();
@@ -28,7 +83,8 @@ QVariant TableModel::headerData(int section, Qt::Orientation orientation,
                                 int role) const
 {
     if (role == Qt::DisplayRole && orientation == Qt::Horizontal)
-        return dataset_->getHeaderName(section);
+        return isLoading() ? loadingHeaders_.at(section)
+                           : dataset_->getHeaderName(section);
     return QVariant();
 }
 
@@ -47,14 +103,30 @@ QStringList TableModel::getStringList(int column) const
     return dataset_->getStringList(column);
 }
 
+bool TableModel::hasSortRanks() const
+{
+    return !isLoading() && !isHibernated() && dataset_->hasSortRanks();
+}
+
+quint32 TableModel::getSortRank(int row, int column) const
+{
+    return dataset_->getSortRank(row, column);
+}
+
 ColumnType TableModel::getColumnFormat(int column) const
 {
+    if (isLoading())
+        return loadingFormats_.at(column);
     return dataset_->getColumnFormat(column);
 }
 
 std::tuple<bool, int> TableModel::getTaggedColumnIfExists(
     ColumnTag columnTag) const
 {
+    if (isLoading())
+        return {loadingTaggedColumns_.contains(columnTag),
+                loadingTaggedColumns_.value(columnTag,
+                                            Constants::NOT_SET_COLUMN)};
     return dataset_->getTaggedColumn(columnTag);
 }
 
@@ -63,6 +135,12 @@ QByteArray TableModel::definitionToXml(unsigned int rowCount) const
     return dataset_->definitionToXml(rowCount);
 }
 
+std::tuple<bool, unsigned int> TableModel::matchDefinitionXml(
+    const QByteArray& definitionContent) const
+{
+    return dataset_->matchDefinitionXml(definitionContent);
+}
+
 bool TableModel::areTaggedColumnsSet() const
 {
     const auto [transDateColumnSet, transDateColumnId] =
@@ -80,3 +158,243 @@ int TableModel::getDefaultGroupingColumn() const
             return column;
     return Constants::NOT_SET_COLUMN;
 }
+
+bool TableModel::isLoading() const { return dataset_ == nullptr; }
+
+void TableModel::appendLoadedRows(const QVector<QVector<QVariant>>& rows)
+{
+    if (rows.isEmpty())
+        return;
+
+    beginInsertRows(QModelIndex(), loadingRows_.size(),
+                    loadingRows_.size() + rows.size() - 1);
+    loadingRows_.append(rows);
+    endInsertRows();
+}
+
+void TableModel::finishLoading(std::unique_ptr<Dataset> dataset)
+{
+    beginResetModel();
+    dataset_ = std::move(dataset);
+    loadingRows_.clear();
+    loadingRows_.squeeze();
+    endResetModel();
+    startProfiling();
+}
+
+bool TableModel::isFollowable() const
+{
+    return !isLoading() && !isHibernated() && dataset_->isFollowable();
+}
+
+void TableModel::setFollowing(bool following)
+{
+    if (following && isFollowable())
+        followTimer_.start(FOLLOW_INTERVAL);
+    else
+        followTimer_.stop();
+}
+
+void TableModel::appendRows(QVector<QVector<QVariant>> rows)
+{
+    if (rows.isEmpty() || isLoading() || isHibernated())
+        return;
+
+    const int first{rowCount()};
+    beginInsertRows(QModelIndex(), first, first + rows.size() - 1);
+    dataset_->appendRows(std::move(rows));
+    endInsertRows();
+    startProfiling();
+}
+
+void TableModel::followTimerTimeout()
+{
+    if (appendedRows_.valid())
+    {
+        if (appendedRows_.wait_for(std::chrono::seconds(0)) !=
+            std::future_status::ready)
+            return;
+        appendRows(appendedRows_.get());
+    }
+
+    if (followTimer_.isActive())
+        appendedRows_ = std::async(std::launch::async,
+                                   &Dataset::readAppendedRows, dataset_.get());
+}
+
+quint64 TableModel::getUsedMemory() const
+{
+    if (!isLoading())
+        return dataset_->getUsedMemory();
+
+    // Rows loaded so far have equal sizes, first one is representative.
+    quint64 usedMemory{MemoryUtilities::getVectorMemory(loadingRows_)};
+    if (!loadingRows_.isEmpty())
+        usedMemory += static_cast<quint64>(loadingRows_.size()) *
+                      MemoryUtilities::getVectorMemory(loadingRows_.first());
+    return usedMemory;
+}
+
+quint64 TableModel::getCachedMemory() const
+{
+    if (isLoading())
+        return 0;
+    if (hibernatable_ && canHibernate())
+        return dataset_->getUsedMemory();
+    return dataset_->getCachedMemory();
+}
+
+quint64 TableModel::releaseCachedMemory()
+{
+    // Dataset is modified by loading thread until load is finished.
+    if (isLoading())
+        return 0;
+    if (!hibernatable_ || !canHibernate())
+        return dataset_->releaseCachedMemory();
+
+    const quint64 usedMemory{dataset_->getUsedMemory()};
+    hibernate();
+    return usedMemory - std::min(usedMemory, dataset_->getUsedMemory());
+}
+
+quint64 TableModel::getColumnUsedMemory(int column) const
+{
+    if (isLoading())
+        return static_cast<quint64>(loadingRows_.size()) * sizeof(QVariant);
+    return dataset_->getColumnUsedMemory(column);
+}
+
+quint64 TableModel::getStringsUsedMemory() const
+{
+    return isLoading() ? 0 : dataset_->getStringsUsedMemory();
+}
+
+bool TableModel::hibernate()
+{
+    // Rows are shared with snapshot of pending profiling until it ends.
+    if (pendingProfiles_.valid())
+        pendingProfiles_.wait();
+
+    if (!canHibernate())
+        return false;
+
+    auto spillFile{std::make_unique<QTemporaryFile>()};
+    if (!spillFile->open())
+    {
+        LOG(LogTypes::MODEL, "Can not create spill file " +
+                                 spillFile->fileTemplate() + ".");
+        return false;
+    }
+
+    Q_EMIT aboutToHibernate();
+    beginResetModel();
+    const bool spilled{dataset_->spillData(*spillFile)};
+    if (spilled)
+        spillFile_ = std::move(spillFile);
+    endResetModel();
+
+    LOG(LogTypes::MODEL, "Dataset " + dataset_->getName() +
+                             (spilled ? " hibernated." : " not hibernated."));
+    if (!spilled)
+        Q_EMIT wokenUp();
+    return spilled;
+}
+
+bool TableModel::wakeUp()
+{
+    if (!isHibernated())
+        return true;
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    beginResetModel();
+    spillFile_->seek(0);
+    const bool restored{dataset_->restoreData(*spillFile_)};
+    spillFile_ = nullptr;
+    endResetModel();
+    QApplication::restoreOverrideCursor();
+
+    if (!restored)
+        LOG(LogTypes::MODEL, dataset_->getLastError());
+    Q_EMIT wokenUp();
+
+    if (profileOutdated_)
+        startProfiling();
+    return restored;
+}
+
+bool TableModel::isHibernated() const { return spillFile_ != nullptr; }
+
+bool TableModel::shareData(Dataset& dataset) const
+{
+    if (isLoading() || isHibernated() || !dataset.canShareDataOf(*dataset_))
+        return false;
+    dataset.shareDataOf(*dataset_);
+    return true;
+}
+
+std::unique_ptr<Dataset> TableModel::createDerivedDataset(
+    const QString& name, const QVector<int>& rows) const
+{
+    if (isLoading() || isHibernated())
+        return nullptr;
+    return std::make_unique<DatasetDerived>(name, *dataset_, rows);
+}
+
+void TableModel::setHibernatable(bool hibernatable)
+{
+    hibernatable_ = hibernatable;
+}
+
+bool TableModel::canHibernate() const
+{
+    // Followed dataset is modified by reads of appended rows. Spilling rows
+    // shared with other tab would not free memory.
+    return !isLoading() && !isHibernated() && !followTimer_.isActive() &&
+           !appendedRows_.valid() && !dataset_->isDataShared();
+}
+
+void TableModel::startProfiling()
+{
+    if (isLoading() || isHibernated())
+        return;
+
+    if (pendingProfiles_.valid())
+    {
+        profileOutdated_ = true;
+        return;
+    }
+
+    profileOutdated_ = false;
+    pendingProfiles_ = std::async(
+        std::launch::async,
+        [this, profiler = dataset_->createProfiler()]() mutable {
+            QVector<ColumnProfile> profiles{profiler()};
+
+            // Release snapshot of rows before model takes profiles.
+            profiler = nullptr;
+            QMetaObject::invokeMethod(this, &TableModel::profilingFinished,
+                                      Qt::QueuedConnection);
+            return profiles;
+        });
+}
+
+bool TableModel::isProfileReady() const
+{
+    return !isLoading() && profiles_.size() == columnCount();
+}
+
+const ColumnProfile& TableModel::getColumnProfile(int column) const
+{
+    return profiles_.at(column);
+}
+
+void TableModel::profilingFinished()
+{
+    profiles_ = pendingProfiles_.get();
+    LOG(LogTypes::MODEL,
+        "Profiles of columns of " + dataset_->getName() + " computed.");
+    Q_EMIT profileReady();
+
+    if (profileOutdated_)
+        startProfiling();
+}
@@ -1,23 +1,36 @@
 #pragma once
 
+#include <future>
 #include <memory>
 
 #include <ColumnType.h>
+#include <MemoryReporter.h>
 #include <QAbstractTableModel>
+#include <QTemporaryFile>
+#include <QTimer>
 
 #include "Dataset.h"
 
 /**
- * @brief 2d data model.
+ * @brief 2d data model. Reports memory of dataset to memory budget. Rows
+ * of hibernated model are kept in spill file and model shows no rows.
  */
-class TableModel : public QAbstractTableModel
+class TableModel : public QAbstractTableModel, public MemoryReporter
 {
     Q_OBJECT
 public:
     explicit TableModel(std::unique_ptr<Dataset> dataset,
                         QObject* parent = nullptr);
 
-    ~TableModel() override = default;
+    /**
+     * @brief Construct model showing rows of dataset while it is loaded.
+     * @param loadingDataset Dataset before load, only definition is used.
+     * @param parent Parent object.
+     */
+    explicit TableModel(const Dataset& loadingDataset,
+                        QObject* parent = nullptr);
+
+    ~TableModel() override;
 
     /**
      * @brief Overridden method for row count check.
@@ -73,6 +86,20 @@ public:
      */
     QStringList getStringList(int column) const;
 
+    /**
+     * @brief Check if dataset provides precomputed sort ranks.
+     * @return True if sort ranks are available.
+     */
+    bool hasSortRanks() const;
+
+    /**
+     * @brief Get rank of value in sorted column.
+     * @param row Row number.
+     * @param column Column number.
+     * @return Sort rank.
+     */
+    quint32 getSortRank(int row, int column) const;
+
     /**
      * @brief get type of given column.
      * @return data format of given column.
@@ -92,10 +119,171 @@ public:
      */
     QByteArray definitionToXml(unsigned int rowCount) const;
 
+    /**
+     * @brief Check if definition describes same columns as dataset.
+     * @param definitionContent Definition as XML.
+     * @return Flag indicating columns match and row count from definition.
+     */
+    std::tuple<bool, unsigned int> matchDefinitionXml(
+        const QByteArray& definitionContent) const;
+
     bool areTaggedColumnsSet() const;
 
     int getDefaultGroupingColumn() const;
 
+    /**
+     * @brief Check if model shows rows of dataset which is still loaded.
+     * @return True if loading is ongoing.
+     */
+    bool isLoading() const;
+
+    /**
+     * @brief Append rows loaded so far.
+     * @param rows Rows of active columns with strings resolved.
+     */
+    void appendLoadedRows(const QVector<QVector<QVariant>>& rows);
+
+    /**
+     * @brief Replace rows loaded so far with loaded dataset.
+     * @param dataset Loaded dataset.
+     */
+    void finishLoading(std::unique_ptr<Dataset> dataset);
+
+    /**
+     * @brief Check if rows appended to source of dataset can be followed.
+     * @return True if dataset is followable, false otherwise.
+     */
+    bool isFollowable() const;
+
+    /**
+     * @brief Start or stop periodic reading of rows appended to source.
+     * Appended rows are inserted in batches, one batch per read.
+     * @param following Flag indicating source should be followed.
+     */
+    void setFollowing(bool following);
+
+    /**
+     * @brief Append rows to loaded dataset.
+     * @param rows Rows of active columns with plain strings.
+     */
+    void appendRows(QVector<QVector<QVariant>> rows);
+
+    quint64 getUsedMemory() const override;
+
+    quint64 getCachedMemory() const override;
+
+    quint64 releaseCachedMemory() override;
+
+    /**
+     * @brief Get memory used by fields and statistics of column.
+     * @param column Column index.
+     * @return Used bytes.
+     */
+    quint64 getColumnUsedMemory(int column) const;
+
+    /**
+     * @brief Get memory used by strings shared between columns.
+     * @return Used bytes.
+     */
+    quint64 getStringsUsedMemory() const;
+
+    /**
+     * @brief Move rows of dataset to spill file. Model is reset and shows no
+     * rows until woken up.
+     * @return True if hibernated, false otherwise.
+     */
+    bool hibernate();
+
+    /**
+     * @brief Read rows of hibernated dataset back from spill file.
+     * @return True if rows were restored, false otherwise.
+     */
+    bool wakeUp();
+
+    bool isHibernated() const;
+
+    /**
+     * @brief Give rows of dataset to other dataset of same source, so it
+     * does not need to load them. Rows are shared, not copied.
+     * @param dataset Dataset before load.
+     * @return True if rows were shared, false otherwise.
+     */
+    bool shareData(Dataset& dataset) const;
+
+    /**
+     * @brief Create dataset of given rows without copying them.
+     * @param name Name of created dataset.
+     * @param rows Rows of model.
+     * @return Loaded dataset or nullptr when model has no rows to share.
+     */
+    std::unique_ptr<Dataset> createDerivedDataset(
+        const QString& name, const QVector<int>& rows) const;
+
+    /**
+     * @brief Allow memory budget to hibernate model when memory is needed.
+     * @param hibernatable Flag indicating model can be hibernated.
+     */
+    void setHibernatable(bool hibernatable);
+
+    /**
+     * @brief Start computing profiles of columns on worker threads. When
+     * profiling is ongoing, it is repeated after finish.
+     */
+    void startProfiling();
+
+    bool isProfileReady() const;
+
+    /**
+     * @brief Get profile of column computed by last finished profiling.
+     * @param column Column number.
+     * @return Profile of column.
+     */
+    const ColumnProfile& getColumnProfile(int column) const;
+
+Q_SIGNALS:
+    /// Emitted before rows are spilled, views should store their state.
+    void aboutToHibernate();
+
+    /// Emitted after rows are restored, views can restore their state.
+    void wokenUp();
+
+    /// Emitted when profiles of columns are computed.
+    void profileReady();
+
 private:
-    std::unique_ptr<Dataset> dataset_;
+    bool canHibernate() const;
+
+    std::unique_ptr<Dataset> dataset_{nullptr};
+
+    /// Triggers reads of rows appended to followed source.
+    QTimer followTimer_;
+
+    /// Rows read on worker thread, inserted on next timer tick.
+    std::future<QVector<QVector<QVariant>>> appendedRows_;
+
+    static constexpr int FOLLOW_INTERVAL{1000};
+
+    /// Definition and rows used while dataset is loaded.
+    QStringList loadingHeaders_;
+    QVector<ColumnType> loadingFormats_;
+    QMap<ColumnTag, int> loadingTaggedColumns_;
+    QVector<QVector<QVariant>> loadingRows_;
+
+    /// Rows of hibernated dataset, null when model is not hibernated.
+    std::unique_ptr<QTemporaryFile> spillFile_{nullptr};
+
+    bool hibernatable_{false};
+
+    /// Profiles computed on worker threads, taken when finished.
+    std::future<QVector<ColumnProfile>> pendingProfiles_;
+
+    QVector<ColumnProfile> profiles_;
+
+    /// Dataset changed while profiling, profiling is repeated.
+    bool profileOutdated_{false};
+
+private Q_SLOTS:
+    void followTimerTimeout();
+
+    void profilingFinished();
 };
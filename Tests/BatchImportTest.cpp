@@ -0,0 +1,56 @@
+#include "BatchImportTest.h"
+
+#include <QtTest/QtTest>
+
+#include <Datasets/DatasetBatch.h>
+
+#include "DatasetCommon.h"
+
+namespace
+{
+QString writeFile(const QTemporaryDir& dir, const QString& fileName,
+                  const QByteArray& content)
+{
+    QFile file(dir.filePath(fileName));
+    file.open(QIODevice::WriteOnly);
+    file.write(content);
+    return file.fileName();
+}
+}  // namespace
+
+void BatchImportTest::testUnionOfFiles()
+{
+    QTemporaryDir dir;
+    const QStringList files{
+        writeFile(dir, QStringLiteral("a.csv"), "name,value\nx,1\ny,2\n"),
+        writeFile(dir, QStringLiteral("b.csv"), "name,value\ny,3\nz,text\n")};
+
+    DatasetBatch dataset(QStringLiteral("batch"), files);
+    dataset.setSourceFileColumn(true);
+    QVERIFY(dataset.initialize());
+    QCOMPARE(dataset.rowCount(), 4U);
+    QCOMPARE(dataset.columnCount(), 3U);
+    QCOMPARE(dataset.getColumnFormat(1), ColumnType::STRING);
+
+    DatasetCommon::activateAllDatasetColumns(dataset);
+    QVERIFY(dataset.loadData());
+    QCOMPARE(dataset.rowCount(), 4U);
+    QCOMPARE(dataset.getData(1, 0)->toString(), QStringLiteral("y"));
+    QCOMPARE(dataset.getData(2, 0)->toString(), QStringLiteral("y"));
+    QCOMPARE(dataset.getData(1, 1)->toString(), QStringLiteral("2"));
+    QCOMPARE(dataset.getData(3, 1)->toString(), QStringLiteral("text"));
+    QCOMPARE(dataset.getData(0, 2)->toString(), QStringLiteral("a.csv"));
+    QCOMPARE(dataset.getData(3, 2)->toString(), QStringLiteral("b.csv"));
+}
+
+void BatchImportTest::testDifferentColumns()
+{
+    QTemporaryDir dir;
+    const QStringList files{
+        writeFile(dir, QStringLiteral("a.csv"), "name,value\nx,1\n"),
+        writeFile(dir, QStringLiteral("b.csv"), "name,other\ny,3\n")};
+
+    DatasetBatch dataset(QStringLiteral("batch"), files);
+    QVERIFY(!dataset.initialize());
+    QVERIFY(!dataset.isValid());
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <QObject>
+
+class BatchImportTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testUnionOfFiles();
+
+    void testDifferentColumns();
+};
@@ -0,0 +1,87 @@
+#include "CompressionTest.h"
+
+#include <zlib.h>
+#include <QtTest/QtTest>
+
+#include <Common/CompressionUtilities.h>
+#include <Export/ParallelDeflater.h>
+
+void CompressionTest::testConcatenatedChunks()
+{
+    const QByteArray data{generateData(100000)};
+    const int chunkSize{30000};
+    QByteArray compressed;
+    for (int position = 0; position < data.size(); position += chunkSize)
+    {
+        const auto [deflated, chunk] = CompressionUtilities::deflateChunk(
+            data.mid(position, chunkSize), false);
+        QVERIFY(deflated);
+        compressed.append(chunk.data_);
+    }
+    const auto [closed, closingChunk] =
+        CompressionUtilities::deflateChunk({}, true);
+    QVERIFY(closed);
+    compressed.append(closingChunk.data_);
+
+    const auto [inflated, decompressed] =
+        CompressionUtilities::inflateChunk(compressed, data.size());
+    QVERIFY(inflated);
+    QCOMPARE(decompressed, data);
+}
+
+void CompressionTest::testCombinedCrc()
+{
+    const QByteArray data{generateData(100000)};
+    const int chunkSize{30000};
+    quint32 combinedCrc{0};
+    for (int position = 0; position < data.size(); position += chunkSize)
+    {
+        const auto [deflated, chunk] = CompressionUtilities::deflateChunk(
+            data.mid(position, chunkSize), false);
+        QVERIFY(deflated);
+        combinedCrc = CompressionUtilities::combineCrc(
+            combinedCrc, chunk.crc_, chunk.uncompressedSize_);
+    }
+
+    const auto crc{static_cast<quint32>(
+        crc32(crc32(0L, Z_NULL, 0),
+              reinterpret_cast<const Bytef*>(data.constData()),
+              static_cast<uInt>(data.size())))};
+    QCOMPARE(combinedCrc, crc);
+}
+
+void CompressionTest::testParallelDeflater()
+{
+    const QByteArray data{generateData(1000000)};
+    QByteArray compressed;
+    ParallelDeflater deflater([&compressed](const QByteArray& chunk) {
+        compressed.append(chunk);
+        return true;
+    });
+
+    // More chunks than cores, so adding waits for compressed ones.
+    const int chunkSize{10000};
+    for (int position = 0; position < data.size(); position += chunkSize)
+        QVERIFY(deflater.addChunk(data.mid(position, chunkSize)));
+    QVERIFY(deflater.finish());
+
+    QCOMPARE(deflater.getUncompressedSize(), qint64{data.size()});
+    const auto [inflated, decompressed] =
+        CompressionUtilities::inflateChunk(compressed, data.size());
+    QVERIFY(inflated);
+    QCOMPARE(decompressed, data);
+    QCOMPARE(deflater.getCrc(),
+             CompressionUtilities::deflateChunk(data, true).second.crc_);
+}
+
+QByteArray CompressionTest::generateData(int size)
+{
+    // Repeated words with counter give data which compresses, but not to
+    // nothing.
+    QByteArray data;
+    data.reserve(size);
+    for (int i = 0; data.size() < size; ++i)
+        data.append("value;" + QByteArray::number(i % 977) + ";text\n");
+    data.resize(size);
+    return data;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <QObject>
+
+/**
+ * @brief Unit tests for compression in independent chunks.
+ */
+class CompressionTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testConcatenatedChunks();
+    void testCombinedCrc();
+    void testParallelDeflater();
+
+private:
+    static QByteArray generateData(int size);
+};
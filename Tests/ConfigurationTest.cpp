@@ -33,6 +33,8 @@ void ConfigurationTest::testReadingFilledConfigurationFile()
     QCOMPARE(Configuration::getInstance().getStyleName(), defaultStyle_);
     QVERIFY(Configuration::getInstance().isUpdatePolicyPicked());
     QVERIFY(!Configuration::getInstance().needToCheckForUpdates());
+    QCOMPARE(Configuration::getInstance().getHibernationIdleMinutes(),
+             defaultHibernationIdleMinutes_);
 }
 
 void ConfigurationTest::testReadingEmptyConfigurationFile()
@@ -19,4 +19,5 @@ private:
     QString configurationFileContent_;
     QString configurationFileName_;
     const QString defaultStyle_{QStringLiteral("Fusion")};
+    const int defaultHibernationIdleMinutes_{10};
 };
@@ -1,11 +1,47 @@
 #include "DatasetTest.h"
 
+#include <numeric>
+
 #include <QtTest/QtTest>
 
 #include <Constants.h>
+#include <Datasets/DatasetInner.h>
+#include <ModelsAndViews/TableModel.h>
 
+#include "Common.h"
+#include "DatasetCommon.h"
 #include "DatasetDummy.h"
 
+namespace
+{
+/// Dataset having equal strings stored separately in rows.
+class DatasetWithPlainStrings : public DatasetDummy
+{
+public:
+    explicit DatasetWithPlainStrings(int rowCount)
+        : DatasetDummy(QStringLiteral("plainStrings"))
+    {
+        columnTypes_ = {ColumnType::STRING, ColumnType::NUMBER};
+        headerColumnNames_ = QStringList{"name", "value"};
+        columnsCount_ = 2;
+        for (int row = 0; row < rowCount; ++row)
+            data_.append(QVector<QVariant>{
+                "name " + QString::number(row % DISTINCT_NAMES),
+                static_cast<double>(row)});
+        rowsCount_ = static_cast<unsigned int>(rowCount);
+        valid_ = true;
+    }
+
+    void internNames()
+    {
+        QHash<QString, int> stringIndexes;
+        internColumnStrings(data_, 0, stringIndexes);
+    }
+
+    static constexpr int DISTINCT_NAMES{3};
+};
+}  // namespace
+
 void DatasetTest::testGetColumnFormatColumnsSet()
 {
     const unsigned int dateColumnIndex{0};
@@ -32,3 +68,272 @@ void DatasetTest::testGetColumnFormatColumnsNotSet()
     QVERIFY(!ok);
     QCOMPARE(column, Constants::NOT_SET_COLUMN);
 }
+
+void DatasetTest::testMemoryEstimate()
+{
+    DatasetInner dataset(QStringLiteral("ExampleData"));
+    QVERIFY(dataset.initialize());
+    const unsigned int rowCount{dataset.rowCount()};
+    const QVector<bool> allColumns(static_cast<int>(dataset.columnCount()),
+                                   true);
+
+    Column stringColumn{Constants::NOT_SET_COLUMN};
+    for (Column column = 0; column < static_cast<int>(dataset.columnCount());
+         ++column)
+    {
+        const quint64 columnEstimate{
+            dataset.estimateColumnMemory(column, rowCount)};
+        if (dataset.getColumnFormat(column) == ColumnType::STRING)
+        {
+            stringColumn = column;
+            QVERIFY(columnEstimate >= rowCount * sizeof(QVariant));
+        }
+        else
+            QCOMPARE(columnEstimate, rowCount * sizeof(QVariant));
+    }
+    QVERIFY(stringColumn != Constants::NOT_SET_COLUMN);
+
+    const quint64 estimate{dataset.estimateMemory(allColumns, rowCount)};
+    QVERIFY(dataset.estimateMemory(allColumns, rowCount / 2) < estimate);
+    QVector<bool> withoutStrings{allColumns};
+    withoutStrings[stringColumn] = false;
+    QCOMPARE(dataset.estimateMemory(withoutStrings, rowCount),
+             estimate - dataset.estimateColumnMemory(stringColumn, rowCount));
+    QCOMPARE(dataset.estimateMemory(
+                 QVector<bool>(allColumns.size(), false), rowCount),
+             quint64{0});
+}
+
+void DatasetTest::testHibernation()
+{
+    auto dataset{
+        std::make_unique<DatasetInner>(QStringLiteral("ExampleData"))};
+    QVERIFY(dataset->initialize());
+    DatasetCommon::activateAllDatasetColumns(*dataset);
+    QVERIFY(dataset->loadData());
+    TableModel model(std::move(dataset));
+
+    QVector<QVector<QVariant>> rows;
+    for (int row = 0; row < model.rowCount(); ++row)
+    {
+        QVector<QVariant> fields;
+        for (int column = 0; column < model.columnCount(); ++column)
+            fields.append(model.index(row, column).data());
+        rows.append(fields);
+    }
+    const quint64 usedMemory{model.getUsedMemory()};
+
+    QVERIFY(model.hibernate());
+    QVERIFY(model.isHibernated());
+    QCOMPARE(model.rowCount(), 0);
+    QVERIFY(model.getUsedMemory() < usedMemory);
+    QVERIFY(!model.hibernate());
+
+    QVERIFY(model.wakeUp());
+    QVERIFY(!model.isHibernated());
+    QCOMPARE(model.rowCount(), rows.size());
+    for (int row = 0; row < model.rowCount(); ++row)
+        for (int column = 0; column < model.columnCount(); ++column)
+            QCOMPARE(model.index(row, column).data(), rows[row][column]);
+}
+
+void DatasetTest::testSharedData()
+{
+    auto loadedDataset{
+        std::make_unique<DatasetInner>(QStringLiteral("ExampleData"))};
+    QVERIFY(loadedDataset->initialize());
+    DatasetCommon::activateAllDatasetColumns(*loadedDataset);
+    QVERIFY(loadedDataset->loadData());
+    TableModel loadedModel(std::move(loadedDataset));
+
+    DatasetInner otherColumnsDataset(QStringLiteral("ExampleData"));
+    QVERIFY(otherColumnsDataset.initialize());
+    QVector<bool> activeColumns(
+        static_cast<int>(otherColumnsDataset.columnCount()), true);
+    activeColumns[0] = false;
+    otherColumnsDataset.setActiveColumns(activeColumns);
+    QVERIFY(!loadedModel.shareData(otherColumnsDataset));
+
+    auto dataset{std::make_unique<DatasetInner>(QStringLiteral("ExampleData"))};
+    QVERIFY(dataset->initialize());
+    DatasetCommon::activateAllDatasetColumns(*dataset);
+    QVERIFY(dataset->getUsedMemory() > 0);
+    QVERIFY(loadedModel.shareData(*dataset));
+    QVERIFY(dataset->isDataShared());
+    QCOMPARE(dataset->getUsedMemory(), 0ULL);
+    TableModel model(std::move(dataset));
+
+    QCOMPARE(model.rowCount(), loadedModel.rowCount());
+    QCOMPARE(model.columnCount(), loadedModel.columnCount());
+    for (int row = 0; row < model.rowCount(); ++row)
+        for (int column = 0; column < model.columnCount(); ++column)
+            QCOMPARE(model.index(row, column).data(),
+                     loadedModel.index(row, column).data());
+    QVERIFY(!model.hibernate());
+    QVERIFY(!loadedModel.hibernate());
+}
+
+void DatasetTest::testDerivedDataset()
+{
+    auto parentDataset{
+        std::make_unique<DatasetInner>(QStringLiteral("ExampleData"))};
+    QVERIFY(parentDataset->initialize());
+    DatasetCommon::activateAllDatasetColumns(*parentDataset);
+    QVERIFY(parentDataset->loadData());
+    TableModel parentModel(std::move(parentDataset));
+
+    const QVector<int> rows{1, 3, 5};
+    std::unique_ptr<Dataset> dataset{
+        parentModel.createDerivedDataset(QStringLiteral("derived"), rows)};
+    QVERIFY(dataset != nullptr);
+    QVERIFY(dataset->isValid());
+    QVERIFY(dataset->isDataShared());
+    QCOMPARE(dataset->rowCount(), static_cast<unsigned int>(rows.size()));
+    QCOMPARE(dataset->columnCount(),
+             static_cast<unsigned int>(parentModel.columnCount()));
+    QVERIFY(dataset->getUsedMemory() < parentModel.getUsedMemory());
+    TableModel model(std::move(dataset));
+
+    for (int row = 0; row < rows.size(); ++row)
+        for (int column = 0; column < model.columnCount(); ++column)
+            QCOMPARE(model.index(row, column).data(),
+                     parentModel.index(rows[row], column).data());
+
+    for (int column = 0; column < model.columnCount(); ++column)
+    {
+        if (model.getColumnFormat(column) != ColumnType::NUMBER)
+            continue;
+        const auto [min, max] = model.getNumericRange(column);
+        for (const int row : rows)
+        {
+            const double value{
+                parentModel.index(row, column).data().toDouble()};
+            QVERIFY(value >= min && value <= max);
+        }
+    }
+}
+
+void DatasetTest::testDerivedDatasetWithoutFirstRow()
+{
+    auto parentDataset{
+        std::make_unique<DatasetInner>(QStringLiteral("ExampleData"))};
+    QVERIFY(parentDataset->initialize());
+    DatasetCommon::activateAllDatasetColumns(*parentDataset);
+    QVERIFY(parentDataset->loadData());
+    TableModel parentModel(std::move(parentDataset));
+
+    std::unique_ptr<Dataset> dataset{parentModel.createDerivedDataset(
+        QStringLiteral("derived"), {2, 4})};
+    QVERIFY(dataset != nullptr);
+    QVERIFY(dataset->isDataShared());
+    QVERIFY(!parentModel.hibernate());
+
+    dataset.reset();
+    QVERIFY(parentModel.hibernate());
+}
+
+void DatasetTest::testColumnProfile()
+{
+    DatasetInner dataset(QStringLiteral("ExampleData"));
+    QVERIFY(dataset.initialize());
+    DatasetCommon::activateAllDatasetColumns(dataset);
+    QVERIFY(dataset.loadData());
+
+    const QVector<ColumnProfile> profiles{dataset.createProfiler()()};
+    QCOMPARE(profiles.size(), static_cast<int>(dataset.columnCount()));
+    const int rowCount{static_cast<int>(dataset.rowCount())};
+    for (int column = 0; column < profiles.size(); ++column)
+    {
+        const ColumnProfile& profile{profiles[column]};
+        QVERIFY(profile.emptyValues_ <= rowCount);
+        if (profile.emptyValues_ < rowCount)
+            QVERIFY(!profile.topValues_.isEmpty());
+        for (int i = 1; i < profile.topValues_.size(); ++i)
+            QVERIFY(profile.topValues_[i - 1].second >=
+                    profile.topValues_[i].second);
+
+        switch (dataset.getColumnFormat(column))
+        {
+            case ColumnType::STRING:
+            {
+                QStringList expected{dataset.getStringList(column)};
+                QStringList strings{profile.strings_};
+                expected.sort();
+                strings.sort();
+                QCOMPARE(strings, expected);
+                QCOMPARE(profile.distinctValues_, strings.size());
+                break;
+            }
+            case ColumnType::NUMBER:
+            {
+                const auto [min, max] = dataset.getNumericRange(column);
+                QCOMPARE(profile.min_.toDouble(), min);
+                QCOMPARE(profile.max_.toDouble(), max);
+                QCOMPARE(std::accumulate(profile.histogram_.cbegin(),
+                                         profile.histogram_.cend(), 0),
+                         rowCount - profile.emptyValues_);
+                break;
+            }
+            case ColumnType::DATE:
+            {
+                const auto [min, max, emptyDates] =
+                    dataset.getDateRange(column);
+                QCOMPARE(profile.min_.toDate(), min);
+                QCOMPARE(profile.max_.toDate(), max);
+                QCOMPARE(profile.emptyValues_ > 0, emptyDates);
+                QCOMPARE(std::accumulate(profile.histogram_.cbegin(),
+                                         profile.histogram_.cend(), 0),
+                         rowCount - profile.emptyValues_);
+                break;
+            }
+            case ColumnType::UNKNOWN:
+            {
+                QFAIL("Unknown column type.");
+            }
+        }
+    }
+}
+
+void DatasetTest::testInternedStrings()
+{
+    const int rowCount{300};
+    DatasetWithPlainStrings dataset(rowCount);
+    const quint64 usedMemory{dataset.getUsedMemory()};
+    dataset.internNames();
+    QVERIFY(dataset.getUsedMemory() < usedMemory);
+
+    const int distinctNames{DatasetWithPlainStrings::DISTINCT_NAMES};
+    QCOMPARE(dataset.getStringList(0).size(), distinctNames);
+    for (int row = 0; row < rowCount; ++row)
+    {
+        const QString name{dataset.getData(row, 0)->toString()};
+        const QString firstName{
+            dataset.getData(row % distinctNames, 0)->toString()};
+        QCOMPARE(name, "name " + QString::number(row % distinctNames));
+        QCOMPARE(name.constData(), firstName.constData());
+    }
+}
+
+void DatasetTest::testLoadedStringsShareStorage()
+{
+    const QString fileName{QStringLiteral("test01.ods")};
+    std::unique_ptr<Dataset> dataset{DatasetCommon::createDataset(
+        fileName, Common::getSpreadsheetsDir() + fileName)};
+    QVERIFY(dataset->initialize());
+    DatasetCommon::activateAllDatasetColumns(*dataset);
+    QVERIFY(dataset->loadData());
+
+    // Each distinct string of column is stored once.
+    const Column column{6};
+    QHash<QString, const QChar*> storages;
+    for (int row = 0; row < static_cast<int>(dataset->rowCount()); ++row)
+    {
+        const QString string{dataset->getData(row, column)->toString()};
+        if (string.isEmpty())
+            continue;
+        const QChar* storage{storages.value(string, string.constData())};
+        QCOMPARE(string.constData(), storage);
+        storages.insert(string, storage);
+    }
+    QCOMPARE(storages.size(), dataset->getStringList(column).size());
+}
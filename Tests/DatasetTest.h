@@ -9,4 +9,20 @@ private Q_SLOTS:
     void testGetColumnFormatColumnsSet();
 
     void testGetColumnFormatColumnsNotSet();
+
+    void testMemoryEstimate();
+
+    void testHibernation();
+
+    void testSharedData();
+
+    void testDerivedDataset();
+
+    void testDerivedDatasetWithoutFirstRow();
+
+    void testColumnProfile();
+
+    void testInternedStrings();
+
+    void testLoadedStringsShareStorage();
 };
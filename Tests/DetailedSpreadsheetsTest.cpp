@@ -17,14 +17,15 @@ void DetailedSpreadsheetsTest::testBasics_data()
     QTest::addColumn<unsigned int>("rowCount");
     QTest::addColumn<unsigned int>("columnCount");
 
-    const QVector<unsigned int> expectedRowCounts{49, 4, 30};
+    // Blank row of test04.xlsx is kept, ods importer drops it.
+    const QVector<unsigned int> expectedRowCounts{49, 49, 4, 4, 31, 30};
     const QVector<unsigned int> expectedColumnCounts{7, 5, 12};
 
     for (int i = 0; i < fileNames_.size(); ++i)
     {
         QString testName{"Basic test for " + fileNames_[i] + "."};
         QTest::newRow(testName.toStdString().c_str())
-            << fileNames_[i] << expectedRowCounts[i / 2]
+            << fileNames_[i] << expectedRowCounts[i]
             << expectedColumnCounts[i / 2];
     }
 }
@@ -179,14 +180,17 @@ void DetailedSpreadsheetsTest::testDateColumnRanges_data()
 
     const QVector<DateCheckData> expectedRanges{
         {2, QDate(2010, 1, 7), QDate(2010, 2, 27), false},
+        {2, QDate(2010, 1, 7), QDate(2010, 2, 27), false},
+        {3, QDate(2012, 2, 2), QDate(2012, 2, 5), true},
         {3, QDate(2012, 2, 2), QDate(2012, 2, 5), true},
+        {1, QDate(1970, 1, 1), QDate(1970, 1, 30), true},
         {1, QDate(1970, 1, 1), QDate(1970, 1, 30), false}};
 
     for (int i = 0; i < fileNames_.size(); ++i)
     {
         QString testName{"Numeric ranges test for " + fileNames_[i] + "."};
         QTest::newRow(testName.toStdString().c_str())
-            << fileNames_[i] << expectedRanges[i / 2];
+            << fileNames_[i] << expectedRanges[i];
     }
 }
 
@@ -0,0 +1,195 @@
+#include "DsvTest.h"
+
+#include <QtTest/QtTest>
+
+#include <Datasets/DatasetDsv.h>
+#include <Datasets/DsvParser.h>
+
+#include "DatasetCommon.h"
+
+namespace
+{
+const QByteArray semicolonSeparated{
+    "name;value;day\r\n"
+    "first;1.5;2020-01-02\r\n"
+    "\"second; quoted\";-2;2020-12-31\r\n"
+    "\"multi\nline \"\"text\"\"\";3;\r\n"
+    "first;;2021-06-15"};
+
+std::unique_ptr<Dataset> loadDsv(QTemporaryFile& file,
+                                 const QByteArray& content)
+{
+    file.open();
+    file.write(content);
+    file.close();
+
+    auto dataset{std::make_unique<DatasetDsv>(QStringLiteral("dsv"),
+                                              file.fileName())};
+    dataset->initialize();
+    DatasetCommon::activateAllDatasetColumns(*dataset);
+    return std::move(dataset);
+}
+}  // namespace
+
+void DsvTest::testDefinition()
+{
+    QTemporaryFile file;
+    std::unique_ptr<Dataset> dataset{loadDsv(file, semicolonSeparated)};
+    QVERIFY(dataset->isValid());
+
+    QCOMPARE(dataset->columnCount(), 3U);
+    QCOMPARE(dataset->rowCount(), 4U);
+    QCOMPARE(dataset->getHeaderName(0), QStringLiteral("name"));
+    QCOMPARE(dataset->getHeaderName(2), QStringLiteral("day"));
+    QCOMPARE(dataset->getColumnFormat(0), ColumnType::STRING);
+    QCOMPARE(dataset->getColumnFormat(1), ColumnType::NUMBER);
+    QCOMPARE(dataset->getColumnFormat(2), ColumnType::DATE);
+}
+
+void DsvTest::testQuotedFields()
+{
+    QTemporaryFile file;
+    std::unique_ptr<Dataset> dataset{loadDsv(file, semicolonSeparated)};
+    QVERIFY(dataset->loadData());
+
+    QCOMPARE(dataset->rowCount(), 4U);
+    QCOMPARE(dataset->getData(0, 0)->toString(), QStringLiteral("first"));
+    QCOMPARE(dataset->getData(1, 0)->toString(),
+             QStringLiteral("second; quoted"));
+    QCOMPARE(dataset->getData(2, 0)->toString(),
+             QStringLiteral("multi\nline \"text\""));
+    QCOMPARE(dataset->getData(3, 0)->toString(), QStringLiteral("first"));
+    QCOMPARE(dataset->getData(1, 1)->toDouble(), -2.);
+    QVERIFY(dataset->getData(3, 1)->isNull());
+    QCOMPARE(dataset->getData(1, 2)->toDate(), QDate(2020, 12, 31));
+    QVERIFY(dataset->getData(2, 2)->isNull());
+}
+
+void DsvTest::testTabSeparated()
+{
+    QTemporaryFile file;
+    std::unique_ptr<Dataset> dataset{
+        loadDsv(file, "a\tb\n1,5\tx,y\n2,5\tz\n\n")};
+    QVERIFY(dataset->loadData());
+
+    QCOMPARE(dataset->columnCount(), 2U);
+    QCOMPARE(dataset->rowCount(), 2U);
+    QCOMPARE(dataset->getColumnFormat(0), ColumnType::STRING);
+    QCOMPARE(dataset->getData(0, 0)->toString(), QStringLiteral("1,5"));
+    QCOMPARE(dataset->getData(1, 1)->toString(), QStringLiteral("z"));
+}
+
+void DsvTest::testFollowAppendedRows()
+{
+    QTemporaryFile file;
+    file.open();
+    file.write("name,value\na,1\nb,2\nc,");
+    file.flush();
+
+    DatasetDsv dataset(QStringLiteral("dsv"), file.fileName());
+    dataset.setFollowing(true);
+    QVERIFY(dataset.initialize());
+    DatasetCommon::activateAllDatasetColumns(dataset);
+    QVERIFY(dataset.loadData());
+    QVERIFY(dataset.isFollowable());
+    QCOMPARE(dataset.rowCount(), 2U);
+
+    // Record written partially before load is read when it is complete.
+    QVERIFY(dataset.readAppendedRows().isEmpty());
+    file.write("5\na,7\n\"d\n");
+    file.flush();
+    dataset.appendRows(dataset.readAppendedRows());
+    QCOMPARE(dataset.rowCount(), 4U);
+    QCOMPARE(dataset.getData(2, 0)->toString(), QStringLiteral("c"));
+    QCOMPARE(dataset.getData(3, 0)->toString(), QStringLiteral("a"));
+    QCOMPARE(dataset.getData(3, 1)->toDouble(), 7.);
+    QCOMPARE(dataset.getNumericRange(1), std::make_tuple(1., 7.));
+    QCOMPARE(dataset.getStringList(0).size(), 3);
+
+    file.write("\",3\n");
+    file.flush();
+    dataset.appendRows(dataset.readAppendedRows());
+    QCOMPARE(dataset.rowCount(), 5U);
+    QCOMPARE(dataset.getData(4, 0)->toString(), QStringLiteral("d\n"));
+}
+
+void DsvTest::testColumnWidenedAfterSniffedRows()
+{
+    QByteArray content{"id,value\n"};
+    const int numericRows{1500};
+    for (int row = 0; row < numericRows; ++row)
+        content.append(QByteArray::number(row) + "," +
+                       QByteArray::number(row) + "\n");
+    content.append("N/A,1\n12A,2\n");
+
+    QTemporaryFile file;
+    std::unique_ptr<Dataset> dataset{loadDsv(file, content)};
+    QCOMPARE(dataset->getColumnFormat(0), ColumnType::NUMBER);
+    QVERIFY(dataset->loadData());
+
+    QCOMPARE(dataset->rowCount(), static_cast<unsigned int>(numericRows + 2));
+    QCOMPARE(dataset->getColumnFormat(0), ColumnType::STRING);
+    QCOMPARE(dataset->getColumnFormat(1), ColumnType::NUMBER);
+    QCOMPARE(dataset->getData(7, 0)->toString(), QStringLiteral("7"));
+    QCOMPARE(dataset->getData(numericRows, 0)->toString(),
+             QStringLiteral("N/A"));
+    QCOMPARE(dataset->getData(numericRows + 1, 0)->toString(),
+             QStringLiteral("12A"));
+    QCOMPARE(dataset->getData(numericRows + 1, 1)->toDouble(), 2.);
+}
+
+void DsvTest::testChunksWithQuotesInsideFields()
+{
+    QByteArray content{"name,size,note\n"};
+    const QByteArray records{
+        "O'Brien,5\",plain\n"
+        "\"quoted, with comma\",7,\"multi\nline\"\n"
+        "D'Arcy,12\",'single'\n"
+        "\"say \"\"hi\"\"\",3,x\"y\n"};
+    const int repeats{20};
+    for (int i = 0; i < repeats; ++i)
+        content.append(records);
+
+    QTemporaryFile file;
+    file.open();
+    file.write(content);
+    file.close();
+
+    QVector<std::unique_ptr<DatasetDsv>> datasets;
+    for (const qint64 chunkSize : {qint64(1024 * 1024), qint64(7)})
+    {
+        auto dataset{std::make_unique<DatasetDsv>(QStringLiteral("dsv"),
+                                                  file.fileName())};
+        dataset->setChunkSize(chunkSize);
+        QVERIFY(dataset->initialize());
+        DatasetCommon::activateAllDatasetColumns(*dataset);
+        QCOMPARE(dataset->rowCount(), static_cast<unsigned int>(4 * repeats));
+        QVERIFY(dataset->loadData());
+        QCOMPARE(dataset->rowCount(), static_cast<unsigned int>(4 * repeats));
+        datasets.push_back(std::move(dataset));
+    }
+
+    const DatasetDsv& whole{*datasets[0]};
+    const DatasetDsv& chunked{*datasets[1]};
+    for (int row = 0; row < static_cast<int>(whole.rowCount()); ++row)
+        for (Column column = 0; column < 3; ++column)
+            QCOMPARE(*chunked.getData(row, column),
+                     *whole.getData(row, column));
+    QCOMPARE(whole.getData(0, 0)->toString(), QStringLiteral("O'Brien"));
+    QCOMPARE(whole.getData(0, 1)->toString(), QStringLiteral("5\""));
+    QCOMPARE(whole.getData(1, 2)->toString(), QStringLiteral("multi\nline"));
+    QCOMPARE(whole.getData(3, 0)->toString(), QStringLiteral("say \"hi\""));
+    QCOMPARE(whole.getData(3, 2)->toString(), QStringLiteral("x\"y"));
+}
+
+void DsvTest::testSniffQuote()
+{
+    const QByteArray apostrophes{"name,value\nO'Brien,1\n'90s,2\n"};
+    QCOMPARE(DsvParser::sniff(apostrophes.cbegin(), apostrophes.cend())
+                 .getQuote(),
+             '\0');
+
+    const QByteArray quoted{"name,value\n'a, b',1\nO'Brien,2\n"};
+    QCOMPARE(DsvParser::sniff(quoted.cbegin(), quoted.cend()).getQuote(),
+             '\'');
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <QObject>
+
+class DsvTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testDefinition();
+
+    void testQuotedFields();
+
+    void testTabSeparated();
+
+    void testFollowAppendedRows();
+
+    void testColumnWidenedAfterSniffedRows();
+
+    void testChunksWithQuotesInsideFields();
+
+    void testSniffQuote();
+};
@@ -0,0 +1,121 @@
+#include "ImportCacheTest.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include <Common/DatasetUtilities.h>
+#include <Common/ImportCache.h>
+
+void ImportCacheTest::testKeyStability()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString sourcePath{directory.filePath(QStringLiteral("a.csv"))};
+    writeFile(sourcePath, QByteArray(3 * 1024 * 1024, 'a'));
+
+    const QString cacheFilePath{
+        ImportCache::getCacheFilePath(QFileInfo(sourcePath))};
+    QVERIFY(!cacheFilePath.isEmpty());
+    QVERIFY(cacheFilePath.startsWith(ImportCache::getCacheDir()));
+    QVERIFY(cacheFilePath.endsWith(DatasetUtilities::getDatasetExtension()));
+    QCOMPARE(ImportCache::getCacheFilePath(QFileInfo(sourcePath)),
+             cacheFilePath);
+
+    // Same content in other file gets own entry.
+    const QString otherPath{directory.filePath(QStringLiteral("b.csv"))};
+    QVERIFY(QFile::copy(sourcePath, otherPath));
+    QVERIFY(ImportCache::getCacheFilePath(QFileInfo(otherPath)) !=
+            cacheFilePath);
+}
+
+void ImportCacheTest::testInvalidation()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString sourcePath{directory.filePath(QStringLiteral("a.csv"))};
+    const QByteArray content(3 * 1024 * 1024, 'a');
+    writeFile(sourcePath, content);
+    const QDateTime modificationTime{QFileInfo(sourcePath).lastModified()};
+    const QString cacheFilePath{
+        ImportCache::getCacheFilePath(QFileInfo(sourcePath))};
+    const QString sourceKey{
+        QFileInfo(cacheFilePath).completeBaseName().section('_', 0, 0)};
+
+    // Changed beginning is detected even with same size and time.
+    QByteArray changedContent{content};
+    changedContent[0] = 'b';
+    writeFile(sourcePath, changedContent);
+    QFile file(sourcePath);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(modificationTime,
+                             QFileDevice::FileModificationTime));
+    file.close();
+    const QString changedPath{
+        ImportCache::getCacheFilePath(QFileInfo(sourcePath))};
+    QVERIFY(changedPath != cacheFilePath);
+    QCOMPARE(QFileInfo(changedPath).completeBaseName().section('_', 0, 0),
+             sourceKey);
+
+    // Modification time alone changes key as well.
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.setFileTime(modificationTime.addSecs(60),
+                             QFileDevice::FileModificationTime));
+    file.close();
+    QVERIFY(ImportCache::getCacheFilePath(QFileInfo(sourcePath)) !=
+            changedPath);
+}
+
+void ImportCacheTest::testStaleEntriesRemoval()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString extension{DatasetUtilities::getDatasetExtension()};
+    const QString stalePath{directory.filePath("source_old" + extension)};
+    const QString currentPath{directory.filePath("source_new" + extension)};
+    const QString otherPath{directory.filePath("other_old" + extension)};
+    for (const QString& filePath : {stalePath, currentPath, otherPath})
+        writeFile(filePath, "data");
+
+    ImportCache::removeStaleEntries(currentPath);
+
+    QVERIFY(!QFile::exists(stalePath));
+    QVERIFY(QFile::exists(currentPath));
+    QVERIFY(QFile::exists(otherPath));
+}
+
+void ImportCacheTest::testLeastRecentlyUsedEviction()
+{
+    QTemporaryDir directory;
+    QVERIFY(directory.isValid());
+    const QString extension{DatasetUtilities::getDatasetExtension()};
+    const QStringList filePaths{directory.filePath("a_1" + extension),
+                                directory.filePath("b_1" + extension),
+                                directory.filePath("c_1" + extension)};
+    const QDateTime now{QDateTime::currentDateTime()};
+    for (int i = 0; i < filePaths.size(); ++i)
+    {
+        writeFile(filePaths[i], QByteArray(100, 'a'));
+        QFile file(filePaths[i]);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.setFileTime(now.addSecs(3600 * (i - 3)),
+                                 QFileDevice::FileModificationTime));
+    }
+
+    // Oldest file gets used, so next one is least recently used.
+    ImportCache::markUsed(filePaths[0]);
+    ImportCache::removeLeastRecentlyUsed(filePaths[2], 250);
+
+    QVERIFY(QFile::exists(filePaths[0]));
+    QVERIFY(!QFile::exists(filePaths[1]));
+    QVERIFY(QFile::exists(filePaths[2]));
+}
+
+void ImportCacheTest::writeFile(const QString& filePath,
+                                const QByteArray& content)
+{
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(file.write(content), static_cast<qint64>(content.size()));
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <QObject>
+
+class QString;
+
+/**
+ * @brief Tests of cache of imported files.
+ */
+class ImportCacheTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testKeyStability();
+    void testInvalidation();
+    void testStaleEntriesRemoval();
+    void testLeastRecentlyUsedEviction();
+
+private:
+    static void writeFile(const QString& filePath, const QByteArray& content);
+};
@@ -1,5 +1,7 @@
 #include "InnerTests.h"
 
+#include <algorithm>
+
 #include <Qt5Quazip/quazipfile.h>
 #include <QBuffer>
 #include <QDirIterator>
@@ -7,6 +9,7 @@
 #include <QTableView>
 #include <QtTest/QtTest>
 
+#include <Common/DatasetIndex.h>
 #include <Common/FileUtilities.h>
 #include <Datasets/DatasetInner.h>
 #include <Export/ExportVbx.h>
@@ -17,6 +20,24 @@
 #include "DatasetCommon.h"
 #include "DatasetUtilities.h"
 
+namespace
+{
+/// Inner dataset giving access to decoded strings.
+class InspectedDatasetInner : public DatasetInner
+{
+public:
+    using DatasetInner::DatasetInner;
+
+    int getDecodedStringsCount() const
+    {
+        // First element is always empty string.
+        return static_cast<int>(std::count_if(
+            sharedStrings_.constBegin() + 1, sharedStrings_.constEnd(),
+            [](const QVariant& string) { return string.isValid(); }));
+    }
+};
+}  // namespace
+
 void InnerTests::initTestCase()
 {
     // generateDumpData();
@@ -54,11 +75,90 @@ void InnerTests::testExport()
     QByteArray exportedByteArray;
     QBuffer exportedBuffer(&exportedByteArray);
     exportedBuffer.open(QIODevice::WriteOnly);
-    generateVbxFile(datasetName, exportedBuffer, {});
+    generateVbxFile(datasetName, exportedBuffer, {}, false);
 
     checkExport(datasetName, exportedBuffer);
 }
 
+void InnerTests::testStreamedExport_data()
+{
+    addTestCases(QStringLiteral("Test streamed export"));
+}
+
+void InnerTests::testStreamedExport()
+{
+    QFETCH(QString, datasetName);
+
+    std::unique_ptr<Dataset> dataset{DatasetCommon::createDataset(
+        datasetName, DatasetUtilities::getDatasetsDir())};
+    dataset->initialize();
+    DatasetCommon::activateAllDatasetColumns(*dataset);
+    dataset->loadData();
+    TableModel model(std::move(dataset));
+    FilteringProxyModel proxyModel;
+    proxyModel.setSourceModel(&model);
+    QTableView view;
+    view.setModel(&proxyModel);
+
+    // Small chunks make spools flush many times. First export checks that
+    // nothing is carried over to next export done by same object.
+    const int chunkSize{64};
+    ExportVbx exportVbx;
+    exportVbx.setSpoolChunkSize(chunkSize);
+    QByteArray firstByteArray;
+    QBuffer firstBuffer(&firstByteArray);
+    firstBuffer.open(QIODevice::WriteOnly);
+    QVERIFY(exportVbx.generateVbx(view, firstBuffer));
+
+    const QString roundTripName{datasetName + QStringLiteral("RoundTrip")};
+    QFile file(DatasetUtilities::getDatasetsDir() + roundTripName +
+               DatasetUtilities::getDatasetExtension());
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(exportVbx.generateVbx(view, file));
+    file.close();
+
+    QuaZip zip(file.fileName());
+    QVERIFY(zip.open(QuaZip::mdUnzip));
+    QuaZipFileInfo dataFileInfo;
+    QVERIFY(zip.setCurrentFile(DatasetUtilities::getDatasetDataFilename()));
+    QVERIFY(zip.getCurrentFileInfo(&dataFileInfo));
+    const QByteArray data{
+        loadDataFromZip(zip, DatasetUtilities::getDatasetDataFilename())};
+    const auto [groupsValid, groups] = DatasetIndex::rowGroupsFromByteArray(
+        loadDataFromZip(zip, DatasetUtilities::getDatasetRowGroupsFilename()),
+        dataFileInfo.crc, static_cast<unsigned int>(model.rowCount()),
+        static_cast<unsigned int>(model.columnCount()));
+    zip.close();
+    QVERIFY(groupsValid);
+
+    // Spool closes chunk after row which fills it, each chunk is row group.
+    int expectedGroups{0};
+    int bufferedBytes{0};
+    for (int position = 0; position < data.size();)
+    {
+        const int lineEnd{data.indexOf('\n', position)};
+        bufferedBytes += lineEnd + 1 - position;
+        position = lineEnd + 1;
+        if (bufferedBytes >= chunkSize || position == data.size())
+        {
+            expectedGroups++;
+            bufferedBytes = 0;
+        }
+    }
+    QCOMPARE(groups.size(), expectedGroups);
+
+    std::unique_ptr<Dataset> loadedDataset{
+        std::make_unique<DatasetInner>(roundTripName)};
+    QVERIFY(loadedDataset->initialize());
+    DatasetCommon::activateAllDatasetColumns(*loadedDataset);
+    QVERIFY(loadedDataset->loadData());
+    DatasetCommon::compareExportDataWithDump(
+        std::move(loadedDataset),
+        DatasetUtilities::getDatasetsDir() + datasetName);
+
+    QVERIFY(DatasetUtilities::removeDataset(roundTripName));
+}
+
 void InnerTests::generateDumpData()
 {
     QString generatedFilesDir{QApplication::applicationDirPath() +
@@ -106,7 +206,8 @@ void InnerTests::checkExportedDefinitions(QuaZip& zipOriginal,
 }
 
 void InnerTests::generateVbxFile(const QString& datasetName, QBuffer& buffer,
-                                 const QVector<bool>& activeColumns)
+                                 const QVector<bool>& activeColumns,
+                                 bool writeIndexes)
 {
     std::unique_ptr<Dataset> dataset{DatasetCommon::createDataset(
         datasetName, DatasetUtilities::getDatasetsDir())};
@@ -125,6 +226,7 @@ void InnerTests::generateVbxFile(const QString& datasetName, QBuffer& buffer,
     view.setModel(&proxyModel);
 
     ExportVbx exportVbx;
+    exportVbx.setWriteIndexes(writeIndexes);
     exportVbx.generateVbx(view, buffer);
 }
 
@@ -158,11 +260,476 @@ void InnerTests::testPartialData()
     activeColumns[5] = true;
     activeColumns[6] = true;
     generateVbxFile(QStringLiteral("ExampleData"), exportedBuffer,
-                    activeColumns);
+                    activeColumns, false);
 
     checkExport(QStringLiteral("ExampleDataPartial"), exportedBuffer);
 }
 
+void InnerTests::testLoadStringsOfActiveColumns()
+{
+    const Column stringColumn{0};
+    const Column inactiveStringColumn{6};
+    DatasetInner fullDataset(QStringLiteral("ExampleData"));
+    fullDataset.initialize();
+    DatasetCommon::activateAllDatasetColumns(fullDataset);
+    fullDataset.loadData();
+
+    // Sample covers all columns and decodes strings from read prefix.
+    InspectedDatasetInner dataset(QStringLiteral("ExampleData"));
+    QVERIFY(dataset.initialize());
+    const QVector<QVector<QVariant>> sample{dataset.retrieveSampleData()};
+    QVERIFY(!sample.isEmpty());
+    for (int row = 0; row < sample.size(); ++row)
+        for (const Column column : {stringColumn, inactiveStringColumn})
+            QCOMPARE(sample[row][column].toString(),
+                     fullDataset.getData(row, column)->toString());
+
+    QVector<bool> activeColumns(7, true);
+    activeColumns[inactiveStringColumn] = false;
+    dataset.setActiveColumns(activeColumns);
+    QVERIFY(dataset.loadData());
+    QCOMPARE(dataset.rowCount(), fullDataset.rowCount());
+    QStringList columnStrings;
+    for (int row = 0; row < static_cast<int>(dataset.rowCount()); ++row)
+    {
+        const QString string{dataset.getData(row, stringColumn)->toString()};
+        QCOMPARE(string, fullDataset.getData(row, stringColumn)->toString());
+        if (!string.isEmpty() && !columnStrings.contains(string))
+            columnStrings.append(string);
+    }
+
+    // Strings referenced only by inactive column are not decoded.
+    QCOMPARE(dataset.getDecodedStringsCount(), columnStrings.size());
+}
+
+void InnerTests::testIndexes_data()
+{
+    addTestCases(QStringLiteral("Test indexes"));
+}
+
+void InnerTests::testIndexes()
+{
+    QFETCH(QString, datasetName);
+
+    QByteArray exportedByteArray;
+    QBuffer exportedBuffer(&exportedByteArray);
+    exportedBuffer.open(QIODevice::WriteOnly);
+    generateVbxFile(datasetName, exportedBuffer, {}, true);
+
+    QuaZip zipGenerated(&exportedBuffer);
+    QVERIFY(zipGenerated.open(QuaZip::mdUnzip));
+    QuaZipFileInfo dataFileInfo;
+    zipGenerated.setCurrentFile(DatasetUtilities::getDatasetDataFilename());
+    QVERIFY(zipGenerated.getCurrentFileInfo(&dataFileInfo));
+    const QByteArray indexesContent{loadDataFromZip(
+        zipGenerated, DatasetUtilities::getDatasetIndexFilename())};
+
+    std::unique_ptr<Dataset> dataset{DatasetCommon::createDataset(
+        datasetName, DatasetUtilities::getDatasetsDir())};
+    dataset->initialize();
+    DatasetCommon::activateAllDatasetColumns(*dataset);
+    dataset->loadData();
+
+    auto [valid, indexes] = DatasetIndex::fromByteArray(
+        indexesContent, dataFileInfo.crc, dataset->rowCount(),
+        dataset->columnCount());
+    QVERIFY(valid);
+    QVERIFY(!std::get<0>(DatasetIndex::fromByteArray(
+        indexesContent, dataFileInfo.crc + 1, dataset->rowCount(),
+        dataset->columnCount())));
+
+    for (Column column = 0; column < static_cast<int>(dataset->columnCount());
+         ++column)
+    {
+        const ColumnIndex& index{indexes[column]};
+        switch (dataset->getColumnFormat(column))
+        {
+            case ColumnType::NUMBER:
+            {
+                auto [min, max] = dataset->getNumericRange(column);
+                QCOMPARE(index.min_.toDouble(), min);
+                QCOMPARE(index.max_.toDouble(), max);
+                break;
+            }
+
+            case ColumnType::DATE:
+            {
+                auto [min, max, emptyDates] = dataset->getDateRange(column);
+                QCOMPARE(index.min_.toDate(), min);
+                QCOMPARE(index.max_.toDate(), max);
+                QCOMPARE(index.emptyValues_, emptyDates);
+                break;
+            }
+
+            case ColumnType::STRING:
+            {
+                QStringList expectedStrings;
+                for (int row = 0; row < static_cast<int>(dataset->rowCount());
+                     ++row)
+                {
+                    const QString value{
+                        dataset->getData(row, column)->toString()};
+                    if (!value.isEmpty() && !expectedStrings.contains(value))
+                        expectedStrings.append(value);
+                }
+                QCOMPARE(index.distinctStrings_.size(), expectedStrings.size());
+                QCOMPARE(dataset->getStringList(column), expectedStrings);
+                break;
+            }
+
+            case ColumnType::UNKNOWN:
+                break;
+        }
+    }
+}
+
+void InnerTests::testLoadWithRangePredicate()
+{
+    QByteArray exportedByteArray;
+    QBuffer exportedBuffer(&exportedByteArray);
+    exportedBuffer.open(QIODevice::WriteOnly);
+    generateVbxFile(QStringLiteral("ExampleData"), exportedBuffer, {}, false);
+
+    const QString datasetName{QStringLiteral("ExampleDataRowGroups")};
+    QFile file(DatasetUtilities::getDatasetsDir() + datasetName +
+               DatasetUtilities::getDatasetExtension());
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(exportedByteArray);
+    file.close();
+
+    const Column dateColumn{2};
+    const double minJulianDay{2455204};
+    const double maxJulianDay{2455220};
+    DatasetInner fullDataset(QStringLiteral("ExampleData"));
+    fullDataset.initialize();
+    DatasetCommon::activateAllDatasetColumns(fullDataset);
+    fullDataset.loadData();
+    int expectedRows{0};
+    for (int row = 0; row < static_cast<int>(fullDataset.rowCount()); ++row)
+    {
+        const QVariant* date{fullDataset.getData(row, dateColumn)};
+        if (!date->isNull() && date->toDate().toJulianDay() >= minJulianDay &&
+            date->toDate().toJulianDay() <= maxJulianDay)
+            expectedRows++;
+    }
+
+    DatasetInner dataset(datasetName);
+    dataset.initialize();
+    DatasetCommon::activateAllDatasetColumns(dataset);
+    LoadQuery query;
+    query.rangePredicates_.append({dateColumn, minJulianDay, maxJulianDay});
+    QVERIFY(dataset.loadData(query));
+    QCOMPARE(static_cast<int>(dataset.rowCount()), expectedRows);
+    for (int row = 0; row < static_cast<int>(dataset.rowCount()); ++row)
+    {
+        const qint64 julianDay{
+            dataset.getData(row, dateColumn)->toDate().toJulianDay()};
+        QVERIFY(julianDay >= minJulianDay && julianDay <= maxJulianDay);
+    }
+
+    QVERIFY(DatasetUtilities::removeDataset(datasetName));
+}
+
+void InnerTests::checkQueriedRows(const Dataset& fullDataset,
+                                  const QVector<int>& candidateRows,
+                                  const QVector<int>& projectedColumns,
+                                  const Dataset& dataset)
+{
+    QCOMPARE(dataset.columnCount(),
+             static_cast<unsigned int>(projectedColumns.size()));
+    int candidate{0};
+    for (int row = 0; row < static_cast<int>(dataset.rowCount()); ++row)
+    {
+        auto rowMatches = [&](int sourceRow) {
+            for (int column = 0; column < projectedColumns.size(); ++column)
+                if (*dataset.getData(row, column) !=
+                    *fullDataset.getData(sourceRow,
+                                         projectedColumns[column]))
+                    return false;
+            return true;
+        };
+        while (candidate < candidateRows.size() &&
+               !rowMatches(candidateRows[candidate]))
+            candidate++;
+        QVERIFY(candidate < candidateRows.size());
+        candidate++;
+    }
+}
+
+void InnerTests::testLoadQuery()
+{
+    // String, date and numeric column.
+    const QVector<Column> projectedColumns{0, 2, 5};
+    const Column stringColumn{0};
+    DatasetInner fullDataset(QStringLiteral("ExampleData"));
+    fullDataset.initialize();
+    DatasetCommon::activateAllDatasetColumns(fullDataset);
+    fullDataset.loadData();
+    const int fullRowCount{static_cast<int>(fullDataset.rowCount())};
+
+    QStringList acceptedStrings;
+    for (int row = 0; row < 10; ++row)
+        acceptedStrings.append(
+            fullDataset.getData(row, stringColumn)->toString());
+    QVector<int> matchingRows;
+    for (int row = 0; row < fullRowCount; ++row)
+        if (acceptedStrings.contains(
+                fullDataset.getData(row, stringColumn)->toString()))
+            matchingRows.append(row);
+
+    LoadQuery query;
+    query.activeColumns_ = {true, false, true, false, false, true, false};
+    query.stringPredicates_.append({stringColumn, acceptedStrings});
+
+    DatasetInner dataset(QStringLiteral("ExampleData"));
+    dataset.initialize();
+    QVERIFY(dataset.loadData(query));
+    QCOMPARE(static_cast<int>(dataset.rowCount()), matchingRows.size());
+    checkQueriedRows(fullDataset, matchingRows, projectedColumns, dataset);
+
+    // Range is applied to source rows, before predicates.
+    query.mode_ = LoadMode::ROW_RANGE;
+    query.firstRow_ = 3;
+    query.rowLimit_ = 20;
+    QVector<int> matchingRangeRows;
+    for (const int row : matchingRows)
+        if (row >= 3 && row < 23)
+            matchingRangeRows.append(row);
+    DatasetInner rangeDataset(QStringLiteral("ExampleData"));
+    rangeDataset.initialize();
+    QVERIFY(rangeDataset.loadData(query));
+    QCOMPARE(static_cast<int>(rangeDataset.rowCount()),
+             matchingRangeRows.size());
+    checkQueriedRows(fullDataset, matchingRangeRows, projectedColumns,
+                     rangeDataset);
+
+    // Sample is drawn from rows matching predicates.
+    query.mode_ = LoadMode::RANDOM_SAMPLE;
+    query.firstRow_ = 0;
+    query.rowLimit_ = 5;
+    QVERIFY(static_cast<int>(query.rowLimit_) < matchingRows.size());
+    DatasetInner sampleDataset(QStringLiteral("ExampleData"));
+    sampleDataset.initialize();
+    QVERIFY(sampleDataset.loadData(query));
+    QCOMPARE(sampleDataset.rowCount(), query.rowLimit_);
+    checkQueriedRows(fullDataset, matchingRows, projectedColumns,
+                     sampleDataset);
+}
+
+void InnerTests::testPartialLoad()
+{
+    DatasetInner fullDataset(QStringLiteral("ExampleData"));
+    fullDataset.initialize();
+    DatasetCommon::activateAllDatasetColumns(fullDataset);
+    fullDataset.loadData();
+    const int columns{static_cast<int>(fullDataset.columnCount())};
+
+    DatasetInner rangeDataset(QStringLiteral("ExampleData"));
+    rangeDataset.initialize();
+    LoadQuery query;
+    query.mode_ = LoadMode::ROW_RANGE;
+    query.firstRow_ = 3;
+    query.rowLimit_ = 5;
+    QVERIFY(rangeDataset.loadData(query));
+    QCOMPARE(rangeDataset.rowCount(), query.rowLimit_);
+    for (int row = 0; row < static_cast<int>(rangeDataset.rowCount()); ++row)
+        for (int column = 0; column < columns; ++column)
+            QCOMPARE(*rangeDataset.getData(row, column),
+                     *fullDataset.getData(row + 3, column));
+
+    DatasetInner sampleDataset(QStringLiteral("ExampleData"));
+    sampleDataset.initialize();
+    query.mode_ = LoadMode::RANDOM_SAMPLE;
+    query.firstRow_ = 0;
+    QVERIFY(sampleDataset.loadData(query));
+    QCOMPARE(sampleDataset.rowCount(), query.rowLimit_);
+
+    // Sampled rows keep order of source rows.
+    int fullRow{0};
+    for (int row = 0; row < static_cast<int>(sampleDataset.rowCount()); ++row)
+    {
+        auto rowMatches = [&](int sourceRow) {
+            for (int column = 0; column < columns; ++column)
+                if (*sampleDataset.getData(row, column) !=
+                    *fullDataset.getData(sourceRow, column))
+                    return false;
+            return true;
+        };
+        while (fullRow < static_cast<int>(fullDataset.rowCount()) &&
+               !rowMatches(fullRow))
+            fullRow++;
+        QVERIFY(fullRow < static_cast<int>(fullDataset.rowCount()));
+        fullRow++;
+    }
+}
+
+void InnerTests::testCancelledLoad()
+{
+    DatasetInner dataset(QStringLiteral("ExampleData"));
+    dataset.initialize();
+    DatasetCommon::activateAllDatasetColumns(dataset);
+    dataset.cancelLoading();
+    QVERIFY(!dataset.loadData());
+    QVERIFY(dataset.isLoadingCancelled());
+    QCOMPARE(dataset.getLoadingPercent(), 0U);
+}
+
+void InnerTests::testAppend()
+{
+    QByteArray existingByteArray;
+    QBuffer existingBuffer(&existingByteArray);
+    existingBuffer.open(QIODevice::WriteOnly);
+    generateVbxFile(QStringLiteral("ExampleData"), existingBuffer, {}, false);
+    existingBuffer.close();
+
+    std::unique_ptr<Dataset> appendedDataset{DatasetCommon::createDataset(
+        QStringLiteral("ExampleData"), DatasetUtilities::getDatasetsDir())};
+    appendedDataset->initialize();
+    DatasetCommon::activateAllDatasetColumns(*appendedDataset);
+    appendedDataset->loadData();
+    TableModel model(std::move(appendedDataset));
+    FilteringProxyModel proxyModel;
+    proxyModel.setSourceModel(&model);
+    QTableView view;
+    view.setModel(&proxyModel);
+
+    const QString datasetName{QStringLiteral("ExampleDataAppended")};
+    QFile file(DatasetUtilities::getDatasetsDir() + datasetName +
+               DatasetUtilities::getDatasetExtension());
+    ExportVbx exportVbx;
+    QVERIFY(exportVbx.appendVbx(view, existingBuffer, file));
+
+    // All strings are already stored, strings entry stays unchanged.
+    QuaZip zipExisting(&existingBuffer);
+    QVERIFY(zipExisting.open(QuaZip::mdUnzip));
+    QuaZip zipAppended(file.fileName());
+    QVERIFY(zipAppended.open(QuaZip::mdUnzip));
+    QCOMPARE(loadDataFromZip(zipAppended,
+                             DatasetUtilities::getDatasetStringsFilename()),
+             loadDataFromZip(zipExisting,
+                             DatasetUtilities::getDatasetStringsFilename()));
+    zipAppended.close();
+
+    DatasetInner fullDataset(QStringLiteral("ExampleData"));
+    fullDataset.initialize();
+    DatasetCommon::activateAllDatasetColumns(fullDataset);
+    fullDataset.loadData();
+    const int rows{static_cast<int>(fullDataset.rowCount())};
+    const int columns{static_cast<int>(fullDataset.columnCount())};
+
+    DatasetInner dataset(datasetName);
+    dataset.initialize();
+    DatasetCommon::activateAllDatasetColumns(dataset);
+    QVERIFY(dataset.loadData());
+    QCOMPARE(static_cast<int>(dataset.rowCount()), 2 * rows);
+    for (int row = 0; row < static_cast<int>(dataset.rowCount()); ++row)
+        for (int column = 0; column < columns; ++column)
+            QCOMPARE(*dataset.getData(row, column),
+                     *fullDataset.getData(row % rows, column));
+
+    // Row groups of appended rows are used when predicates are given.
+    const Column dateColumn{2};
+    const double minJulianDay{2455204};
+    const double maxJulianDay{2455220};
+    DatasetInner filteredDataset(datasetName);
+    filteredDataset.initialize();
+    DatasetCommon::activateAllDatasetColumns(filteredDataset);
+    LoadQuery query;
+    query.rangePredicates_.append({dateColumn, minJulianDay, maxJulianDay});
+    QVERIFY(filteredDataset.loadData(query));
+    int expectedRows{0};
+    for (int row = 0; row < rows; ++row)
+    {
+        const QVariant* date{fullDataset.getData(row, dateColumn)};
+        if (!date->isNull() && date->toDate().toJulianDay() >= minJulianDay &&
+            date->toDate().toJulianDay() <= maxJulianDay)
+            expectedRows++;
+    }
+    QCOMPARE(static_cast<int>(filteredDataset.rowCount()), 2 * expectedRows);
+
+    QVERIFY(DatasetUtilities::removeDataset(datasetName));
+}
+
+void InnerTests::testAppendNewStrings()
+{
+    QByteArray existingByteArray;
+    QBuffer existingBuffer(&existingByteArray);
+    existingBuffer.open(QIODevice::WriteOnly);
+    generateVbxFile(QStringLiteral("ExampleData"), existingBuffer, {}, false);
+    existingBuffer.close();
+
+    std::unique_ptr<Dataset> appendedDataset{DatasetCommon::createDataset(
+        QStringLiteral("ExampleData"), DatasetUtilities::getDatasetsDir())};
+    appendedDataset->initialize();
+    DatasetCommon::activateAllDatasetColumns(*appendedDataset);
+    appendedDataset->loadData();
+    const int rows{static_cast<int>(appendedDataset->rowCount())};
+    const int columns{static_cast<int>(appendedDataset->columnCount())};
+    Column stringColumn{0};
+    while (appendedDataset->getColumnFormat(stringColumn) != ColumnType::STRING)
+        stringColumn++;
+    QVector<QVariant> firstRow;
+    for (Column column = 0; column < columns; ++column)
+        firstRow.append(*appendedDataset->getData(0, column));
+
+    // Rows with strings not stored in existing file yet.
+    TableModel model(std::move(appendedDataset));
+    QVector<QVector<QVariant>> newRows{firstRow, firstRow};
+    newRows[0][stringColumn] = QStringLiteral("new\nline");
+    newRows[1][stringColumn] = QStringLiteral("brand new");
+    model.appendRows(newRows);
+    FilteringProxyModel proxyModel;
+    proxyModel.setSourceModel(&model);
+    QTableView view;
+    view.setModel(&proxyModel);
+
+    const QString firstName{QStringLiteral("ExampleDataNewStrings")};
+    QFile firstFile(DatasetUtilities::getDatasetsDir() + firstName +
+                    DatasetUtilities::getDatasetExtension());
+    QVERIFY(ExportVbx().appendVbx(view, existingBuffer, firstFile));
+    firstFile.close();
+
+    // Second append finds all strings, including one with new line.
+    const QString secondName{QStringLiteral("ExampleDataNewStrings2")};
+    QFile secondFile(DatasetUtilities::getDatasetsDir() + secondName +
+                     DatasetUtilities::getDatasetExtension());
+    QVERIFY(ExportVbx().appendVbx(view, firstFile, secondFile));
+    firstFile.close();
+    secondFile.close();
+
+    QuaZip zipFirst(firstFile.fileName());
+    QVERIFY(zipFirst.open(QuaZip::mdUnzip));
+    const QByteArray firstStrings{loadDataFromZip(
+        zipFirst, DatasetUtilities::getDatasetStringsFilename())};
+    zipFirst.close();
+    QVERIFY(firstStrings.endsWith("\nnew\tline\nbrand new"));
+    QuaZip zipSecond(secondFile.fileName());
+    QVERIFY(zipSecond.open(QuaZip::mdUnzip));
+    QCOMPARE(loadDataFromZip(zipSecond,
+                             DatasetUtilities::getDatasetStringsFilename()),
+             firstStrings);
+    zipSecond.close();
+
+    DatasetInner dataset(secondName);
+    dataset.initialize();
+    DatasetCommon::activateAllDatasetColumns(dataset);
+    QVERIFY(dataset.loadData());
+    QCOMPARE(static_cast<int>(dataset.rowCount()), 3 * rows + 4);
+    const Column otherColumn{(stringColumn + 1) % columns};
+    for (const int appendedRows : {2 * rows, 3 * rows + 2})
+    {
+        QCOMPARE(dataset.getData(appendedRows, stringColumn)->toString(),
+                 QStringLiteral("new\tline"));
+        QCOMPARE(dataset.getData(appendedRows + 1, stringColumn)->toString(),
+                 QStringLiteral("brand new"));
+        QCOMPARE(*dataset.getData(appendedRows + 1, otherColumn),
+                 *dataset.getData(0, otherColumn));
+    }
+
+    QVERIFY(DatasetUtilities::removeDataset(firstName));
+    QVERIFY(DatasetUtilities::removeDataset(secondName));
+}
+
 void InnerTests::addTestCases(const QString& testNamePrefix)
 {
     QTest::addColumn<QString>("datasetName");
@@ -28,8 +28,28 @@ private Q_SLOTS:
     void testExport_data();
     void testExport();
 
+    void testStreamedExport_data();
+    void testStreamedExport();
+
     void testPartialData();
 
+    void testLoadStringsOfActiveColumns();
+
+    void testIndexes_data();
+    void testIndexes();
+
+    void testLoadWithRangePredicate();
+
+    void testLoadQuery();
+
+    void testPartialLoad();
+
+    void testCancelledLoad();
+
+    void testAppend();
+
+    void testAppendNewStrings();
+
 private:
     void generateDumpData();
 
@@ -50,8 +70,22 @@ private:
     static void checkExportedDefinitions(QuaZip& zipOriginal,
                                          QuaZip& zipGenerated);
 
+    /**
+     * @brief Check that rows of queried dataset are, in order, a subset of
+     * candidate rows of full dataset, compared on projected columns.
+     * @param fullDataset Dataset loaded with all columns and rows.
+     * @param candidateRows Rows of full dataset allowed by query.
+     * @param projectedColumns Columns of full dataset kept by query.
+     * @param dataset Dataset loaded with query.
+     */
+    static void checkQueriedRows(const Dataset& fullDataset,
+                                 const QVector<int>& candidateRows,
+                                 const QVector<int>& projectedColumns,
+                                 const Dataset& dataset);
+
     static void generateVbxFile(const QString& datasetName, QBuffer& buffer,
-                                const QVector<bool>& activeColumns);
+                                const QVector<bool>& activeColumns,
+                                bool writeIndexes);
 
     const QVector<QString> testFileNames_{
         "ExampleData", "po0_dmg", "po0_dmg2_bez_dat",
@@ -0,0 +1,95 @@
+#include "MemoryBudgetTest.h"
+
+#include <QtTest/QtTest>
+
+#include <Common/MemoryBudget.h>
+#include <Common/MemoryReporter.h>
+
+namespace
+{
+class FakeReporter : public MemoryReporter
+{
+public:
+    FakeReporter(quint64 usedMemory, quint64 cachedMemory)
+        : usedMemory_(usedMemory), cachedMemory_(cachedMemory)
+    {
+        MemoryBudget::getInstance().registerReporter(this);
+    }
+
+    ~FakeReporter() override
+    {
+        MemoryBudget::getInstance().unregisterReporter(this);
+    }
+
+    quint64 getUsedMemory() const override { return usedMemory_; }
+
+    quint64 getCachedMemory() const override { return cachedMemory_; }
+
+    quint64 releaseCachedMemory() override
+    {
+        const quint64 released{cachedMemory_};
+        usedMemory_ -= cachedMemory_;
+        cachedMemory_ = 0;
+        return released;
+    }
+
+private:
+    quint64 usedMemory_;
+    quint64 cachedMemory_;
+};
+}  // namespace
+
+void MemoryBudgetTest::testUsedMemory()
+{
+    MemoryBudget& budget{MemoryBudget::getInstance()};
+    const quint64 initialMemory{budget.getUsedMemory()};
+    {
+        FakeReporter first(100, 0);
+        FakeReporter second(50, 20);
+        QCOMPARE(budget.getUsedMemory(), initialMemory + 150);
+    }
+    QCOMPARE(budget.getUsedMemory(), initialMemory);
+}
+
+void MemoryBudgetTest::testMakeRoomReleasesBiggestCacheFirst()
+{
+    MemoryBudget& budget{MemoryBudget::getInstance()};
+    const quint64 initialMemory{budget.getUsedMemory()};
+    FakeReporter small(100, 10);
+    FakeReporter big(100, 60);
+    FakeReporter noCache(100, 0);
+    budget.setLimit(initialMemory + 300);
+
+    QVERIFY(budget.makeRoom(0));
+    QCOMPARE(big.getCachedMemory(), 60ULL);
+
+    QVERIFY(budget.makeRoom(50));
+    QCOMPARE(big.getCachedMemory(), 0ULL);
+    QCOMPARE(small.getCachedMemory(), 10ULL);
+    QCOMPARE(budget.getUsedMemory(), initialMemory + 240);
+}
+
+void MemoryBudgetTest::testMakeRoomWhenCachesAreNotEnough()
+{
+    MemoryBudget& budget{MemoryBudget::getInstance()};
+    const quint64 initialMemory{budget.getUsedMemory()};
+    FakeReporter first(100, 10);
+    FakeReporter second(100, 20);
+    budget.setLimit(initialMemory + 200);
+
+    QVERIFY(!budget.makeRoom(100));
+    QCOMPARE(first.getCachedMemory(), 0ULL);
+    QCOMPARE(second.getCachedMemory(), 0ULL);
+}
+
+void MemoryBudgetTest::testReleaseCaches()
+{
+    MemoryBudget& budget{MemoryBudget::getInstance()};
+    FakeReporter first(100, 10);
+    FakeReporter second(100, 20);
+
+    QCOMPARE(budget.releaseCaches(), 30ULL);
+    QCOMPARE(budget.releaseCaches(), 0ULL);
+}
+
+void MemoryBudgetTest::cleanup() { MemoryBudget::getInstance().setLimit(0); }
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <QObject>
+
+/**
+ * @brief Unit tests for MemoryBudget class.
+ */
+class MemoryBudgetTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testUsedMemory();
+    void testMakeRoomReleasesBiggestCacheFirst();
+    void testMakeRoomWhenCachesAreNotEnough();
+    void testReleaseCaches();
+    void cleanup();
+};
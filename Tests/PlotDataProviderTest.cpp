@@ -124,6 +124,61 @@ void PlotDataProviderTest::testRecompute()
                                       quantiles);
 }
 
+void PlotDataProviderTest::testAppend()
+{
+    PlotDataProvider provider;
+    provider.recompute(calcData_.mid(0, 3), ColumnType::STRING);
+
+    QSignalSpy groupingPlotDataChangedSpy(
+        &provider, &PlotDataProvider::groupingPlotDataChanged);
+    QSignalSpy basicPlotDataChangedSpy(&provider,
+                                       &PlotDataProvider::basicPlotDataChanged);
+    QSignalSpy fundamentalDataChangedSpy(
+        &provider, &PlotDataProvider::fundamentalDataChanged);
+    provider.append(calcData_.mid(3));
+
+    checkGroupingDataChangedSignal(
+        groupingPlotDataChangedSpy,
+        {QStringLiteral("column1"), QStringLiteral("column2")},
+        {firstQuantiles_, secondQuantiles_}, mainQuantiles_);
+
+    checkBasicDataChangedSignal(basicPlotDataChangedSpy, points_,
+                                mainQuantiles_, regression_);
+
+    checkFundamentalDataChangedSignal(fundamentalDataChangedSpy, yAxisValues_,
+                                      mainQuantiles_);
+}
+
+void PlotDataProviderTest::testAppendInBatches()
+{
+    QVector<TransactionData> calcData;
+    QVector<double> values;
+    for (int i = 0; i < 100; ++i)
+    {
+        const double value{static_cast<double>((i * 37) % 101) + i % 3 * .5};
+        calcData.append({QDate(2010, 3, 1).addDays(i), QVariant("column1"),
+                         value});
+        values.append(value);
+    }
+    Quantiles expectedQuantiles;
+    expectedQuantiles.init(values);
+
+    PlotDataProvider provider;
+    provider.recompute(calcData.mid(0, 10), ColumnType::STRING);
+    provider.append(calcData.mid(10, 45));
+    QSignalSpy groupingPlotDataChangedSpy(
+        &provider, &PlotDataProvider::groupingPlotDataChanged);
+    QSignalSpy fundamentalDataChangedSpy(
+        &provider, &PlotDataProvider::fundamentalDataChanged);
+    provider.append(calcData.mid(55));
+
+    checkGroupingDataChangedSignal(groupingPlotDataChangedSpy,
+                                   {QStringLiteral("column1")},
+                                   {expectedQuantiles}, expectedQuantiles);
+    checkFundamentalDataChangedSignal(fundamentalDataChangedSpy, values,
+                                      expectedQuantiles);
+}
+
 void PlotDataProviderTest::checkRecomputeGroupingDataForColumnType(
     ColumnType columnType)
 {
@@ -25,6 +25,10 @@ private Q_SLOTS:
     void testRecompute_data();
     void testRecompute();
 
+    void testAppend();
+
+    void testAppendInBatches();
+
 private:
     void checkRecomputeGroupingDataForColumnType(ColumnType columnType);
 
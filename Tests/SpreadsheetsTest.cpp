@@ -1,5 +1,7 @@
 #include "SpreadsheetsTest.h"
 
+#include <algorithm>
+
 #include <QApplication>
 #include <QTableView>
 #include <QtTest/QtTest>
@@ -7,6 +9,7 @@
 #include <Common/FileUtilities.h>
 #include <Datasets/DatasetOds.h>
 #include <Datasets/DatasetXlsx.h>
+#include <Datasets/XlsxSheetParser.h>
 #include <ModelsAndViews/FilteringProxyModel.h>
 #include <ModelsAndViews/TableModel.h>
 
@@ -54,6 +57,230 @@ void SpreadsheetsTest::testDamagedFiles()
     QVERIFY(!dataset->initialize());
 }
 
+void SpreadsheetsTest::testXlsxInSmallChunks_data()
+{
+    addXlsxTestCases(testFileNames_);
+}
+
+void SpreadsheetsTest::testXlsxInSmallChunks()
+{
+    QFETCH(QString, fileName);
+
+    // Data parsed in chunks of few rows matches dump of single chunk parse.
+    const QString filePath{Common::getSpreadsheetsDir() + fileName};
+    auto dataset{std::make_unique<DatasetXlsx>(fileName, filePath)};
+    dataset->setChunkSize(256);
+    QVERIFY(dataset->initialize());
+    DatasetCommon::activateAllDatasetColumns(*dataset);
+    QVERIFY(dataset->loadData());
+    DatasetCommon::compareExportDataWithDump(std::move(dataset), filePath);
+}
+
+void SpreadsheetsTest::testXlsxSheetParserChunks()
+{
+    const QVector<QByteArray> rows{
+        R"(<row r="1"><c r="A1" t="inlineStr"><is><t>id</t></is></c>)"
+        R"(<c r="B1" t="inlineStr"><is><t>code</t></is></c>)"
+        R"(<c r="C1" t="inlineStr"><is><t>note</t></is></c></row>)",
+        R"(<row r="2"><c r="A2"><v>1</v></c><c r="B2"><v>10</v></c>)"
+        R"(<c r="C2" t="inlineStr"><is><t>first</t></is></c></row>)",
+        R"(<row r="3"><c r="A3"><v>2</v></c><c r="B3"><v>20.5</v></c></row>)",
+        R"(<row r="4"><c r="A4"><v>3</v></c>)"
+        R"(<c r="B4" t="inlineStr"><is><t>X30</t></is></c>)"
+        R"(<c r="C4"><v>7</v></c></row>)",
+        R"(<row r="5"><c r="A5"><v>4</v></c></row>)"};
+
+    QByteArray allRows;
+    for (const QByteArray& row : rows)
+        allRows.append(row);
+    XlsxSheetParser whole(QVector<bool>{});
+    QVERIFY(whole.parseRows(allRows));
+
+    XlsxSheetParser chunked(QVector<bool>{});
+    QVERIFY(chunked.parseRows(rows[0] + rows[1] + rows[2]));
+    for (int row = 3; row < rows.size(); ++row)
+    {
+        XlsxSheetParser chunk(QVector<bool>{}, false);
+        QVERIFY(chunk.parseRows(rows[row]));
+        chunked.append(std::move(chunk));
+    }
+
+    const QVector<ColumnType> expectedTypes{
+        ColumnType::NUMBER, ColumnType::STRING, ColumnType::STRING};
+    QCOMPARE(whole.getColumnTypes(), expectedTypes);
+    QCOMPARE(chunked.getColumnTypes(), expectedTypes);
+    QCOMPARE(chunked.getRowCount(), 4);
+    QCOMPARE(chunked.getRowCount(), whole.getRowCount());
+    QCOMPARE(chunked.getHeader(), whole.getHeader());
+    for (int column = 0; column < whole.getColumnCount(); ++column)
+        for (int row = 0; row < whole.getRowCount(); ++row)
+            QCOMPARE(chunked.getColumn(column).value(row),
+                     whole.getColumn(column).value(row));
+    QCOMPARE(chunked.getColumn(1).value(0), QVariant(QStringLiteral("10")));
+    QCOMPARE(chunked.getColumn(1).value(1), QVariant(QStringLiteral("20.5")));
+    QCOMPARE(chunked.getColumn(2).value(2), QVariant(QStringLiteral("7")));
+}
+
+void SpreadsheetsTest::testXlsxSheetParserRowGaps()
+{
+    const QByteArray header{
+        R"(<row r="1"><c r="A1" t="inlineStr"><is><t>id</t></is></c></row>)"};
+    const QByteArray firstRows{R"(<row r="3"><c r="A3"><v>1</v></c></row>)"
+                               R"(<row r="4"><c r="A4"><v>2</v></c></row>)"};
+    const QByteArray nextRows{R"(<row r="7"><c r="A7"><v>3</v></c></row>)"
+                              R"(<row><c><v>4</v></c></row>)"};
+
+    XlsxSheetParser whole(QVector<bool>{});
+    QVERIFY(whole.parseRows(header + firstRows + nextRows));
+
+    XlsxSheetParser chunked(QVector<bool>{});
+    QVERIFY(chunked.parseRows(header + firstRows));
+    XlsxSheetParser chunk(QVector<bool>{}, false);
+    QVERIFY(chunk.parseRows(nextRows));
+    chunked.append(std::move(chunk));
+
+    const QVector<QVariant> expected{QVariant(), 1., 2., QVariant(),
+                                     QVariant(),  3., 4.};
+    QCOMPARE(whole.getRowCount(), expected.size());
+    QCOMPARE(chunked.getRowCount(), expected.size());
+    QCOMPARE(whole.getColumn(0), expected);
+    QCOMPARE(chunked.getColumn(0), expected);
+}
+
+void SpreadsheetsTest::testXlsxDateFormats_data()
+{
+    QTest::addColumn<QString>("formatCode");
+    QTest::addColumn<bool>("dateFormat");
+
+    QTest::newRow("Year, month, day") << "yyyy-mm-dd" << true;
+    QTest::newRow("Date and time") << "d/m/yy h:mm" << true;
+    QTest::newRow("Locale") << "[$-409]mmmm d, yyyy" << true;
+    QTest::newRow("Minutes") << "mm:ss" << false;
+    QTest::newRow("Elapsed time") << "[h]:mm:ss" << false;
+    QTest::newRow("Color") << "[Red]0.00" << false;
+    QTest::newRow("Quoted text") << R"(0.00" dm")" << false;
+    QTest::newRow("Escaped characters") << R"(#,##0\ \d\m)" << false;
+}
+
+void SpreadsheetsTest::testXlsxDateFormats()
+{
+    QFETCH(QString, formatCode);
+    QFETCH(bool, dateFormat);
+
+    QCOMPARE(XlsxSheetParser::isDateFormat(formatCode), dateFormat);
+}
+
+void SpreadsheetsTest::testXlsxDateColumns_data()
+{
+    addXlsxTestCases(testFileNames_);
+}
+
+void SpreadsheetsTest::testXlsxDateColumns()
+{
+    QFETCH(QString, fileName);
+
+    // Date columns are found using styles, importer checks formats itself.
+    const QString filePath{Common::getSpreadsheetsDir() + fileName};
+    DatasetXlsx parsed(fileName, filePath);
+    DatasetXlsx imported(fileName, filePath);
+    imported.setUseImporter(true);
+    QVERIFY(parsed.initialize());
+    QVERIFY(imported.initialize());
+    QCOMPARE(parsed.columnCount(), imported.columnCount());
+    for (Column column = 0; column < static_cast<Column>(parsed.columnCount());
+         ++column)
+        QCOMPARE(parsed.getColumnFormat(column) == ColumnType::DATE,
+                 imported.getColumnFormat(column) == ColumnType::DATE);
+}
+
+void SpreadsheetsTest::testXlsxImporterParity_data()
+{
+    addXlsxTestCases(testFileNames_);
+}
+
+void SpreadsheetsTest::testXlsxImporterParity()
+{
+    QFETCH(QString, fileName);
+
+    // Own parser keeps blank rows, which importer drops.
+    const QString filePath{Common::getSpreadsheetsDir() + fileName};
+    auto parsed{std::make_unique<DatasetXlsx>(fileName, filePath)};
+    auto imported{std::make_unique<DatasetXlsx>(fileName, filePath)};
+    imported->setUseImporter(true);
+    QVERIFY(parsed->initialize());
+    QVERIFY(imported->initialize());
+    QCOMPARE(parsed->columnCount(), imported->columnCount());
+    for (Column column = 0; column < static_cast<Column>(parsed->columnCount());
+         ++column)
+        QCOMPARE(parsed->getHeaderName(column),
+                 imported->getHeaderName(column));
+
+    DatasetCommon::activateAllDatasetColumns(*parsed);
+    QVERIFY(parsed->loadData());
+    DatasetCommon::activateAllDatasetColumns(*imported);
+    QVERIFY(imported->loadData());
+    QCOMPARE(getNonBlankTsvLines(std::move(parsed)),
+             getNonBlankTsvLines(std::move(imported)));
+}
+
+void SpreadsheetsTest::testMultipleSheets_data() { addXlsxReaderTestCases(); }
+
+void SpreadsheetsTest::testMultipleSheets()
+{
+    QFETCH(bool, useImporter);
+
+    // Numbers of first sheet are widened to strings of second one.
+    const QString fileName{QStringLiteral("multiSheet.xlsx")};
+    DatasetXlsx dataset(fileName, Common::getSpreadsheetsDir() + fileName);
+    dataset.setUseImporter(useImporter);
+    dataset.setSelectedSheets({"Second", "First"});
+    dataset.setSourceSheetColumn(true);
+    QVERIFY(dataset.initialize());
+    QCOMPARE(dataset.getSheetNames(),
+             QStringList({"First", "Second", "Other"}));
+    QCOMPARE(dataset.rowCount(), 5U);
+
+    const QVector<QString> expectedNames{"name", "value", "date", "Sheet"};
+    const QVector<ColumnType> expectedTypes{
+        ColumnType::STRING, ColumnType::STRING, ColumnType::DATE,
+        ColumnType::STRING};
+    QCOMPARE(dataset.columnCount(), 4U);
+    for (Column column = 0; column < expectedNames.size(); ++column)
+    {
+        QCOMPARE(dataset.getHeaderName(column), expectedNames[column]);
+        QCOMPARE(dataset.getColumnFormat(column), expectedTypes[column]);
+    }
+
+    DatasetCommon::activateAllDatasetColumns(dataset);
+    QVERIFY(dataset.loadData());
+    const QVector<QVector<QVariant>> expectedRows{
+        {"c", "x3", QDate(2020, 1, 3), "Second"},
+        {"d", "x4", QDate(2020, 1, 4), "Second"},
+        {"e", "x5", QDate(2020, 1, 5), "Second"},
+        {"a", "1", QDate(2020, 1, 1), "First"},
+        {"b", "2", QDate(2020, 1, 2), "First"}};
+    QCOMPARE(dataset.rowCount(), 5U);
+    for (int row = 0; row < expectedRows.size(); ++row)
+        for (Column column = 0; column < expectedNames.size(); ++column)
+            QCOMPARE(*dataset.getData(row, column), expectedRows[row][column]);
+}
+
+void SpreadsheetsTest::testMismatchedSheets_data()
+{
+    addXlsxReaderTestCases();
+}
+
+void SpreadsheetsTest::testMismatchedSheets()
+{
+    QFETCH(bool, useImporter);
+
+    const QString fileName{QStringLiteral("multiSheet.xlsx")};
+    DatasetXlsx dataset(fileName, Common::getSpreadsheetsDir() + fileName);
+    dataset.setUseImporter(useImporter);
+    dataset.setSelectedSheets({"First", "Other"});
+    QVERIFY(!dataset.initialize());
+}
+
 void SpreadsheetsTest::compareExpectedDefinitionsOfOdsAndXlsx_data()
 {
     addTestCaseForOdsAndXlsxComparison(
@@ -90,6 +317,9 @@ void SpreadsheetsTest::addTestCaseForOdsAndXlsxComparison(
 void SpreadsheetsTest::compareOdsAndXlsxExpectedData(const QString& fileSuffix)
 {
     QFETCH(QString, fileName);
+    if (fileName == QLatin1String("import3") ||
+        fileName == QLatin1String("test04"))
+        QSKIP("Ods importer drops blank rows kept in xlsx");
 
     QString filePath{Common::getSpreadsheetsDir() + fileName};
     auto [xlsxLoaded, xlsxDump] =
@@ -128,6 +358,43 @@ void SpreadsheetsTest::addTestCasesForFileNames(
     }
 }
 
+void SpreadsheetsTest::addXlsxTestCases(const QVector<QString>& fileNames)
+{
+    QTest::addColumn<QString>("fileName");
+    for (const auto& fileName : fileNames)
+    {
+        const QString testFileName{fileName + ".xlsx"};
+        const QString testName{"Test " + testFileName};
+        QTest::newRow(testName.toStdString().c_str()) << testFileName;
+    }
+}
+
+void SpreadsheetsTest::addXlsxReaderTestCases()
+{
+    QTest::addColumn<bool>("useImporter");
+    QTest::newRow("Own parser") << false;
+    QTest::newRow("ImportXlsx") << true;
+}
+
+QStringList SpreadsheetsTest::getNonBlankTsvLines(
+    std::unique_ptr<Dataset> dataset)
+{
+    TableModel model(std::move(dataset));
+    FilteringProxyModel proxyModel;
+    proxyModel.setSourceModel(&model);
+    QTableView view;
+    view.setModel(&proxyModel);
+
+    QStringList lines{
+        DatasetCommon::getExportedTsv(view).split(QRegExp("\n|\r\n"))};
+    lines.erase(std::remove_if(lines.begin(), lines.end(),
+                               [](const QString& line) {
+                                   return line.count('\t') == line.size();
+                               }),
+                lines.end());
+    return lines;
+}
+
 void SpreadsheetsTest::generateExpectedData()
 {
     QString generatedFilesDir{QApplication::applicationDirPath() +
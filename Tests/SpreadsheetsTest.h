@@ -24,6 +24,28 @@ private Q_SLOTS:
     void testDamagedFiles_data();
     void testDamagedFiles();
 
+    void testXlsxInSmallChunks_data();
+    void testXlsxInSmallChunks();
+
+    void testXlsxSheetParserChunks();
+
+    void testXlsxSheetParserRowGaps();
+
+    void testXlsxDateFormats_data();
+    void testXlsxDateFormats();
+
+    void testXlsxDateColumns_data();
+    void testXlsxDateColumns();
+
+    void testXlsxImporterParity_data();
+    void testXlsxImporterParity();
+
+    void testMultipleSheets_data();
+    void testMultipleSheets();
+
+    void testMismatchedSheets_data();
+    void testMismatchedSheets();
+
     void compareExpectedDefinitionsOfOdsAndXlsx_data();
     void compareExpectedDefinitionsOfOdsAndXlsx();
 
@@ -42,6 +64,12 @@ private:
 
     static void addTestCasesForFileNames(const QVector<QString>& fileNames);
 
+    static void addXlsxTestCases(const QVector<QString>& fileNames);
+
+    static void addXlsxReaderTestCases();
+
+    static QStringList getNonBlankTsvLines(std::unique_ptr<Dataset> dataset);
+
     const QVector<QString> testFileNames_{"excel",
                                           "HistVsNormal",
                                           "import1",
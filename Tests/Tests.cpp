@@ -1,10 +1,15 @@
 #include <QtTest/QtTest>
 
+#include "BatchImportTest.h"
+#include "CompressionTest.h"
 #include "ConfigurationTest.h"
 #include "DatasetTest.h"
 #include "DetailedSpreadsheetsTest.h"
+#include "DsvTest.h"
 #include "FilteringProxyModelTest.h"
+#include "ImportCacheTest.h"
 #include "InnerTests.h"
+#include "MemoryBudgetTest.h"
 #include "PlotDataProviderTest.h"
 #include "SpreadsheetsTest.h"
 
@@ -29,11 +34,26 @@ int main(int argc, char* argv[])
     FilteringProxyModelTest filteringProxyModelTest;
     QTest::qExec(&filteringProxyModelTest);
 
+    DsvTest dsvTest;
+    QTest::qExec(&dsvTest);
+
+    BatchImportTest batchImportTest;
+    QTest::qExec(&batchImportTest);
+
     InnerTests innerTests;
     QTest::qExec(&innerTests);
 
     DatasetTest datasetTest;
     QTest::qExec(&datasetTest);
 
+    MemoryBudgetTest memoryBudgetTest;
+    QTest::qExec(&memoryBudgetTest);
+
+    CompressionTest compressionTest;
+    QTest::qExec(&compressionTest);
+
+    ImportCacheTest importCacheTest;
+    QTest::qExec(&importCacheTest);
+
     return 0;
 }